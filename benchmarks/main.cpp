@@ -0,0 +1,424 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+#include "ouzel.hpp"
+
+std::string DEVELOPER_NAME = "org.ouzelengine";
+std::string APPLICATION_NAME = "benchmarks";
+
+static void benchmarkResources()
+{
+    const uint32_t RESOURCE_COUNT = 100000;
+
+    std::vector<std::unique_ptr<ouzel::graphics::Buffer>> buffers;
+    buffers.reserve(RESOURCE_COUNT);
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < RESOURCE_COUNT; ++i)
+    {
+        buffers.push_back(std::unique_ptr<ouzel::graphics::Buffer>(new ouzel::graphics::Buffer()));
+    }
+
+    std::chrono::steady_clock::time_point createTime = std::chrono::steady_clock::now();
+
+    // every destructor deletes its render resource
+    buffers.clear();
+
+    std::chrono::steady_clock::time_point deleteTime = std::chrono::steady_clock::now();
+
+    ouzel::Log(ouzel::Log::Level::INFO) << "Created " << RESOURCE_COUNT << " resources in " <<
+        std::chrono::duration_cast<std::chrono::microseconds>(createTime - startTime).count() / 1000.0f << " ms, deleted in " <<
+        std::chrono::duration_cast<std::chrono::microseconds>(deleteTime - createTime).count() / 1000.0f << " ms";
+}
+
+static void benchmarkLayerDraw()
+{
+    const uint32_t ACTOR_COUNTS[] = {1000, 10000, 100000};
+    const uint32_t DRAW_COUNT = 10;
+
+    for (uint32_t actorCount : ACTOR_COUNTS)
+    {
+        // the second run puts all the actors under a static root, so their draw list is reused
+        for (bool staticRoot : {false, true})
+        {
+            ouzel::scene::Layer layer;
+            ouzel::scene::Camera camera;
+            ouzel::scene::Actor cameraActor;
+            cameraActor.addComponent(&camera);
+            layer.addChild(&cameraActor);
+
+            ouzel::scene::Actor root;
+            root.setStatic(staticRoot);
+            layer.addChild(&root);
+
+            std::vector<std::unique_ptr<ouzel::scene::Actor>> actors;
+            actors.reserve(actorCount);
+
+            for (uint32_t i = 0; i < actorCount; ++i)
+            {
+                std::unique_ptr<ouzel::scene::Actor> actor(new ouzel::scene::Actor());
+                // every actor is visible and the orders are interleaved, so that the draw queue has to be sorted
+                actor->setCullDisabled(true);
+                actor->setOrder(static_cast<int32_t>((i * 7) % 32) - 16);
+                root.addChild(actor.get());
+                actors.push_back(std::move(actor));
+            }
+
+            // first draw calculates all the transforms
+            layer.draw();
+
+            std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+            for (uint32_t i = 0; i < DRAW_COUNT; ++i)
+            {
+                layer.draw();
+            }
+
+            std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+
+            ouzel::Log(ouzel::Log::Level::INFO) << "Layer with " << actorCount << (staticRoot ? " static" : "") << " actors drawn in " <<
+                std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count() / 1000.0f / DRAW_COUNT << " ms";
+        }
+    }
+}
+
+static void benchmarkCulling()
+{
+    const uint32_t BOX_COUNT = 10000;
+
+    ouzel::scene::Layer layer;
+    ouzel::scene::Camera camera(ouzel::TAU / 6.0f, 1.0f, 1000.0f);
+    ouzel::scene::Actor cameraActor;
+    cameraActor.addComponent(&camera);
+    cameraActor.setPosition(ouzel::Vector3(0.0f, 0.0f, -100.0f));
+    layer.addChild(&cameraActor);
+
+    std::vector<ouzel::Box3> boxes;
+    boxes.reserve(BOX_COUNT);
+
+    for (uint32_t i = 0; i < BOX_COUNT; ++i)
+    {
+        std::uniform_real_distribution<float> distribution(-500.0f, 500.0f);
+        ouzel::Vector3 position(distribution(ouzel::randomEngine), distribution(ouzel::randomEngine), distribution(ouzel::randomEngine));
+        boxes.push_back(ouzel::Box3(position - ouzel::Vector3(5.0f, 5.0f, 5.0f), position + ouzel::Vector3(5.0f, 5.0f, 5.0f)));
+    }
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    uint32_t visibleCount = 0;
+    for (const ouzel::Box3& box : boxes)
+    {
+        if (camera.checkVisibility(ouzel::Matrix4::IDENTITY, box)) ++visibleCount;
+    }
+
+    std::chrono::steady_clock::time_point singleTime = std::chrono::steady_clock::now();
+
+    std::vector<uint32_t> visibilityMask((BOX_COUNT + 31) / 32);
+    camera.checkVisibility(boxes.data(), BOX_COUNT, visibilityMask.data());
+
+    std::chrono::steady_clock::time_point batchTime = std::chrono::steady_clock::now();
+
+    uint32_t batchVisibleCount = 0;
+    for (uint32_t i = 0; i < BOX_COUNT; ++i)
+    {
+        if (visibilityMask[i / 32] & (1U << (i % 32))) ++batchVisibleCount;
+    }
+
+    ouzel::Log(ouzel::Log::Level::INFO) << "Culled " << BOX_COUNT << " boxes one at a time in " <<
+        std::chrono::duration_cast<std::chrono::microseconds>(singleTime - startTime).count() << " us (" << visibleCount << " visible), in a batch in " <<
+        std::chrono::duration_cast<std::chrono::microseconds>(batchTime - singleTime).count() << " us (" << batchVisibleCount << " visible)";
+}
+
+static void benchmarkJobs()
+{
+    const uint32_t ITEM_COUNT = 1000000;
+    const uint32_t JOB_COUNT = 100000;
+
+    uint32_t maxThreadCount = std::max(std::thread::hardware_concurrency(), 1U);
+
+    std::vector<float> items(ITEM_COUNT);
+    float singleTime = 0.0f;
+
+    for (uint32_t threadCount = 1; threadCount <= maxThreadCount; ++threadCount)
+    {
+        // the calling thread runs jobs too, so one worker less is started,
+        // the workers of the single thread run are stopped, so that all the jobs run inline on the calling thread
+        ouzel::JobSystem jobSystem(std::max(threadCount - 1, 1U));
+        if (threadCount == 1) jobSystem.stop();
+
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+        jobSystem.parallelFor(ITEM_COUNT, [&items](uint32_t index) {
+            float value = static_cast<float>(index);
+            for (uint32_t i = 0; i < 64; ++i)
+            {
+                value = sqrtf(value + static_cast<float>(i));
+            }
+            items[index] = value;
+        });
+
+        std::chrono::steady_clock::time_point forTime = std::chrono::steady_clock::now();
+
+        // many small jobs and one job that depends on all of them
+        std::atomic<uint32_t> finishedCount(0);
+        std::vector<ouzel::JobHandle> handles;
+        handles.reserve(JOB_COUNT);
+
+        for (uint32_t i = 0; i < JOB_COUNT; ++i)
+        {
+            handles.push_back(jobSystem.schedule([&finishedCount]() { ++finishedCount; }));
+        }
+
+        jobSystem.wait(jobSystem.schedule([]() {}, handles));
+
+        std::chrono::steady_clock::time_point jobTime = std::chrono::steady_clock::now();
+
+        float time = std::chrono::duration_cast<std::chrono::microseconds>(forTime - startTime).count() / 1000.0f;
+        if (threadCount == 1) singleTime = time;
+
+        ouzel::Log(ouzel::Log::Level::INFO) << threadCount << " threads: parallel for of " << ITEM_COUNT << " items in " <<
+            time << " ms (" << (time > 0.0f ? singleTime / time : 0.0f) << "x), " << finishedCount.load() << " jobs in " <<
+            std::chrono::duration_cast<std::chrono::microseconds>(jobTime - forTime).count() / 1000.0f << " ms";
+    }
+}
+
+// particle layout and update loop of ParticleSystem before the particles were stored as structure of arrays
+struct ReferenceParticle
+{
+    float life;
+    ouzel::Vector2 position;
+    float colorRed, colorGreen, colorBlue, colorAlpha;
+    float deltaColorRed, deltaColorGreen, deltaColorBlue, deltaColorAlpha;
+    float angle, speed;
+    float size, deltaSize;
+    float rotation, deltaRotation;
+    float radialAcceleration, tangentialAcceleration;
+    ouzel::Vector2 direction;
+    float radius, degreesPerSecond, deltaRadius;
+};
+
+static uint32_t updateReferenceParticles(std::vector<ReferenceParticle>& particles, uint32_t particleCount,
+                                         const ouzel::scene::ParticleDefinition& particleDefinition, float step)
+{
+    for (uint32_t counter = particleCount; counter > 0; --counter)
+    {
+        ReferenceParticle& particle = particles[counter - 1];
+
+        particle.life -= step;
+
+        if (particle.life >= 0.0f)
+        {
+            if (particleDefinition.emitterType == ouzel::scene::ParticleDefinition::EmitterType::GRAVITY)
+            {
+                ouzel::Vector2 radial, tangential;
+
+                if (particle.position.x == 0.0f || particle.position.y == 0.0f)
+                {
+                    radial = particle.position;
+                    radial.normalize();
+                }
+                tangential = radial;
+                radial *= particle.radialAcceleration;
+
+                std::swap(tangential.x, tangential.y);
+                tangential.x *= -particle.tangentialAcceleration;
+                tangential.y *= particle.tangentialAcceleration;
+
+                particle.direction.x += (radial.x + tangential.x + particleDefinition.gravity.x) * step;
+                particle.direction.y += (radial.y + tangential.y + particleDefinition.gravity.y) * step;
+                particle.position.x += particle.direction.x * step * particleDefinition.yCoordFlipped;
+                particle.position.y += particle.direction.y * step * particleDefinition.yCoordFlipped;
+            }
+            else
+            {
+                particle.angle += particle.degreesPerSecond * step;
+                particle.radius += particle.deltaRadius * step;
+                particle.position.x = -cosf(particle.angle) * particle.radius;
+                particle.position.y = -sinf(particle.angle) * particle.radius * particleDefinition.yCoordFlipped;
+            }
+
+            particle.colorRed += particle.deltaColorRed * step;
+            particle.colorGreen += particle.deltaColorGreen * step;
+            particle.colorBlue += particle.deltaColorBlue * step;
+            particle.colorAlpha += particle.deltaColorAlpha * step;
+
+            particle.size = std::max(0.0f, particle.size + particle.deltaSize * step);
+
+            particle.rotation += particle.deltaRotation * step;
+        }
+        else
+        {
+            particle = particles[particleCount - 1];
+            particleCount--;
+        }
+    }
+
+    return particleCount;
+}
+
+static void benchmarkParticles()
+{
+    const uint32_t PARTICLE_COUNT = 100000;
+    const uint32_t STEP_COUNT = 120;
+    const float UPDATE_STEP = 1.0f / 60.0f;
+
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    for (ouzel::scene::ParticleDefinition::EmitterType emitterType : {ouzel::scene::ParticleDefinition::EmitterType::GRAVITY,
+                                                                      ouzel::scene::ParticleDefinition::EmitterType::RADIUS})
+    {
+        ouzel::scene::ParticleDefinition particleDefinition;
+        particleDefinition.emitterType = emitterType;
+        particleDefinition.gravity = ouzel::Vector2(0.0f, -100.0f);
+
+        std::vector<ReferenceParticle> referenceParticles(PARTICLE_COUNT);
+        ouzel::scene::ParticleData particles;
+        particles.resize(PARTICLE_COUNT);
+
+        for (uint32_t i = 0; i < PARTICLE_COUNT; ++i)
+        {
+            ReferenceParticle& particle = referenceParticles[i];
+            particle = ReferenceParticle();
+
+            // some of the particles die during the benchmark
+            particle.life = 2.5f + 1.5f * distribution(ouzel::randomEngine);
+            particle.position = ouzel::Vector2(100.0f * distribution(ouzel::randomEngine), 100.0f * distribution(ouzel::randomEngine));
+            particle.colorRed = particle.colorGreen = particle.colorBlue = particle.colorAlpha = 1.0f;
+            particle.deltaColorRed = particle.deltaColorGreen = particle.deltaColorBlue = particle.deltaColorAlpha = -0.25f;
+            particle.size = 32.0f;
+            particle.deltaSize = -8.0f;
+            particle.deltaRotation = 90.0f * distribution(ouzel::randomEngine);
+            particle.radialAcceleration = 10.0f * distribution(ouzel::randomEngine);
+            particle.tangentialAcceleration = 10.0f * distribution(ouzel::randomEngine);
+            particle.direction = ouzel::Vector2(50.0f * distribution(ouzel::randomEngine), 50.0f * distribution(ouzel::randomEngine));
+            particle.angle = ouzel::PI * distribution(ouzel::randomEngine);
+            particle.radius = 100.0f;
+            particle.degreesPerSecond = ouzel::PI * distribution(ouzel::randomEngine);
+            particle.deltaRadius = -10.0f;
+
+            particles.life[i] = particle.life;
+            particles.positionX[i] = particle.position.x;
+            particles.positionY[i] = particle.position.y;
+            particles.colorRed[i] = particles.colorGreen[i] = particles.colorBlue[i] = particles.colorAlpha[i] = particle.colorRed;
+            particles.deltaColorRed[i] = particles.deltaColorGreen[i] = particles.deltaColorBlue[i] = particles.deltaColorAlpha[i] = particle.deltaColorRed;
+            particles.size[i] = particle.size;
+            particles.deltaSize[i] = particle.deltaSize;
+            particles.rotation[i] = particle.rotation;
+            particles.deltaRotation[i] = particle.deltaRotation;
+            particles.radialAcceleration[i] = particle.radialAcceleration;
+            particles.tangentialAcceleration[i] = particle.tangentialAcceleration;
+            particles.directionX[i] = particle.direction.x;
+            particles.directionY[i] = particle.direction.y;
+            particles.angle[i] = particle.angle;
+            particles.radius[i] = particle.radius;
+            particles.degreesPerSecond[i] = particle.degreesPerSecond;
+            particles.deltaRadius[i] = particle.deltaRadius;
+        }
+
+        uint64_t referenceUpdateCount = 0;
+        uint32_t referenceCount = PARTICLE_COUNT;
+
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+        for (uint32_t step = 0; step < STEP_COUNT; ++step)
+        {
+            referenceUpdateCount += referenceCount;
+            referenceCount = updateReferenceParticles(referenceParticles, referenceCount, particleDefinition, UPDATE_STEP);
+        }
+
+        std::chrono::steady_clock::time_point referenceTime = std::chrono::steady_clock::now();
+
+        uint64_t updateCount = 0;
+        uint32_t count = PARTICLE_COUNT;
+
+        for (uint32_t step = 0; step < STEP_COUNT; ++step)
+        {
+            updateCount += count;
+            count = particles.update(count, particleDefinition, UPDATE_STEP);
+        }
+
+        std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+
+        float before = std::chrono::duration_cast<std::chrono::microseconds>(referenceTime - startTime).count() / 1000.0f;
+        float after = std::chrono::duration_cast<std::chrono::microseconds>(endTime - referenceTime).count() / 1000.0f;
+
+        ouzel::Log(ouzel::Log::Level::INFO) << (emitterType == ouzel::scene::ParticleDefinition::EmitterType::GRAVITY ? "Gravity" : "Radius") <<
+            " emitter: array of structures " << (before > 0.0f ? referenceUpdateCount / before : 0.0f) << " particles/ms (" << referenceCount << " left), " <<
+            "structure of arrays " << (after > 0.0f ? updateCount / after : 0.0f) << " particles/ms (" << count << " left)";
+    }
+}
+
+void ouzelMain(const std::vector<std::string>& args)
+{
+    std::vector<std::string> benchmarks;
+
+    for (auto arg = args.begin(); arg != args.end(); ++arg)
+    {
+        if (arg == args.begin())
+        {
+            // skip the first parameter
+            continue;
+        }
+
+        if (*arg == "-benchmark")
+        {
+            auto nextArg = ++arg;
+
+            if (nextArg != args.end())
+            {
+                benchmarks.push_back(*nextArg);
+            }
+            else
+            {
+                ouzel::Log(ouzel::Log::Level::WARN) << "No benchmark specified";
+            }
+        }
+        else
+        {
+            ouzel::Log(ouzel::Log::Level::WARN) << "Invalid argument \"" << *arg << "\"";
+        }
+    }
+
+    // all the benchmarks are run if none is specified
+    if (benchmarks.empty())
+    {
+        benchmarks = {"resources", "layer", "culling", "jobs", "particles"};
+    }
+
+    for (const std::string& benchmark : benchmarks)
+    {
+        if (benchmark == "resources")
+        {
+            benchmarkResources();
+        }
+        else if (benchmark == "layer")
+        {
+            benchmarkLayerDraw();
+        }
+        else if (benchmark == "culling")
+        {
+            benchmarkCulling();
+        }
+        else if (benchmark == "jobs")
+        {
+            benchmarkJobs();
+        }
+        else if (benchmark == "particles")
+        {
+            benchmarkParticles();
+        }
+        else
+        {
+            ouzel::Log(ouzel::Log::Level::WARN) << "Invalid benchmark \"" << benchmark << "\"";
+        }
+    }
+
+    ouzel::sharedEngine->exit();
+}
@@ -47,6 +47,8 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
     ../../ouzel/core/Cache.cpp \
     ../../ouzel/core/Engine.cpp \
     ../../ouzel/core/Timer.cpp \
+    ../../ouzel/core/FramePacer.cpp \
+    ../../ouzel/core/JobSystem.cpp \
     ../../ouzel/core/UpdateCallback.cpp \
     ../../ouzel/core/Window.cpp \
     ../../ouzel/core/WindowResource.cpp \
@@ -79,6 +81,8 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
     ../../ouzel/graphics/MeshBufferResource.cpp \
     ../../ouzel/graphics/Renderer.cpp \
     ../../ouzel/graphics/RenderDevice.cpp \
+    ../../ouzel/graphics/RenderRecorder.cpp \
+    ../../ouzel/graphics/RenderReplay.cpp \
     ../../ouzel/graphics/Shader.cpp \
     ../../ouzel/graphics/ShaderResource.cpp \
     ../../ouzel/graphics/Texture.cpp \
@@ -130,18 +134,24 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
     ../../ouzel/scene/Component.cpp \
     ../../ouzel/scene/Layer.cpp \
     ../../ouzel/scene/MeshRenderer.cpp \
+    ../../ouzel/scene/ParticleData.cpp \
     ../../ouzel/scene/ParticleDefinition.cpp \
+    ../../ouzel/scene/ParticleManager.cpp \
     ../../ouzel/scene/ParticleSystem.cpp \
     ../../ouzel/scene/Scene.cpp \
     ../../ouzel/scene/SceneManager.cpp \
     ../../ouzel/scene/ShapeRenderer.cpp \
+    ../../ouzel/scene/SpatialIndex.cpp \
     ../../ouzel/scene/Sprite.cpp \
     ../../ouzel/scene/SpriteDefinition.cpp \
     ../../ouzel/scene/SpriteFrame.cpp \
     ../../ouzel/scene/TextRenderer.cpp \
+    ../../ouzel/scene/TransformHierarchy.cpp \
+    ../../ouzel/utils/ExecuteQueue.cpp \
     ../../ouzel/utils/INI.cpp \
     ../../ouzel/utils/Log.cpp \
     ../../ouzel/utils/OBF.cpp \
+    ../../ouzel/utils/Profiler.cpp \
     ../../ouzel/utils/Utils.cpp
 
 include $(BUILD_STATIC_LIBRARY)
@@ -15,3 +15,5 @@
 #define OUZEL_ENABLE_OPENSL 1
 #define OUZEL_ENABLE_COREAUDIO 1
 #define OUZEL_ENABLE_ALSA 1
+
+#define OUZEL_ENABLE_PROFILER 1
@@ -141,9 +141,9 @@ namespace ouzel
             return true;
         }
 
-        void Audio::executeOnAudioThread(const std::function<void(void)>& func)
+        void Audio::executeOnAudioThread(Function&& func)
         {
-            device->executeOnAudioThread(func);
+            device->executeOnAudioThread(std::move(func));
         }
 
         void Audio::addListener(Listener* listener)
@@ -9,6 +9,7 @@
 #include <set>
 #include <vector>
 #include "utils/Noncopyable.hpp"
+#include "utils/Function.hpp"
 #include "math/Quaternion.hpp"
 #include "math/Vector3.hpp"
 
@@ -74,7 +75,7 @@ namespace ouzel
 
             bool update();
 
-            void executeOnAudioThread(const std::function<void(void)>& func);
+            void executeOnAudioThread(Function&& func);
 
             void addListener(Listener* listener);
             void removeListener(Listener* listener);
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include "AudioDevice.hpp"
 #include "math/MathUtils.hpp"
+#include "core/Engine.hpp"
 
 namespace ouzel
 {
@@ -139,6 +140,8 @@ namespace ouzel
 
         bool AudioDevice::getData(uint32_t frames, std::vector<uint8_t>& result)
         {
+            OUZEL_PROFILE_SCOPE(sharedEngine->getProfiler(), "Audio mix");
+
             currentBuffer = 0;
             uint32_t buffer = currentBuffer++;
             if (currentBuffer > buffers.size()) return true; // out of buffers
@@ -179,32 +182,14 @@ namespace ouzel
             return true;
         }
 
-        void AudioDevice::executeOnAudioThread(const std::function<void(void)>& func)
+        void AudioDevice::executeOnAudioThread(Function&& func)
         {
-            std::lock_guard<std::mutex> lock(executeMutex);
-
-            executeQueue.push(func);
+            executeQueue.push(std::move(func));
         }
 
         void AudioDevice::executeAll()
         {
-            std::function<void(void)> func;
-
-            for (;;)
-            {
-                {
-                    std::lock_guard<std::mutex> lock(executeMutex);
-                    if (executeQueue.empty()) break;
-
-                    func = std::move(executeQueue.front());
-                    executeQueue.pop();
-                }
-
-                if (func)
-                {
-                    func();
-                }
-            }
+            executeQueue.executeAll();
         }
     } // namespace audio
 } // namespace ouzel
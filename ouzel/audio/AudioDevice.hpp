@@ -4,9 +4,9 @@
 #pragma once
 
 #include <mutex>
-#include <queue>
 #include <vector>
 #include "utils/Noncopyable.hpp"
+#include "utils/ExecuteQueue.hpp"
 #include "audio/Audio.hpp"
 
 namespace ouzel
@@ -27,7 +27,7 @@ namespace ouzel
             uint16_t getAPIMajorVersion() const { return apiMajorVersion; }
             uint16_t getAPIMinorVersion() const { return apiMinorVersion; }
 
-            void executeOnAudioThread(const std::function<void(void)>& func);
+            void executeOnAudioThread(Function&& func);
 
             struct RenderCommand
             {
@@ -81,8 +81,7 @@ namespace ouzel
             std::vector<std::vector<float>> buffers;
             uint32_t currentBuffer = 0;
 
-            std::queue<std::function<void(void)>> executeQueue;
-            std::mutex executeMutex;
+            ExecuteQueue executeQueue;
 
             std::vector<RenderCommand> renderQueue;
             std::mutex renderQueueMutex;
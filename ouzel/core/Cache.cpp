@@ -105,7 +105,8 @@ namespace ouzel
         {
             // don't delete default shaders
             if (i->first == graphics::SHADER_COLOR ||
-                i->first == graphics::SHADER_TEXTURE)
+                i->first == graphics::SHADER_TEXTURE ||
+                i->first == graphics::SHADER_DISTANCE_FIELD)
             {
                 ++i;
             }
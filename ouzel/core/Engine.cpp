@@ -46,6 +46,8 @@ namespace ouzel
     ouzel::Engine* sharedEngine = nullptr;
 
     Engine::Engine():
+        timerStartTime(std::chrono::steady_clock::now()),
+        updateThreadId(std::this_thread::get_id()),
         active(false), paused(false), screenSaverEnabled(true)
     {
         sharedEngine = this;
@@ -75,15 +77,30 @@ namespace ouzel
         }
 #endif
 
-        for (UpdateCallback* updateCallback : updateCallbackAddSet)
+        // the jobs can use the other subsystems, so they must finish before the subsystems are destroyed
+        jobSystem.stop();
+
+        std::vector<UpdateCallbackList*> lists;
+        lists.push_back(&addedUpdateCallbacks);
+
+        for (UpdateBucket* bucket : sortedUpdateBuckets)
+        {
+            lists.push_back(&bucket->callbacks);
+            lists.push_back(&bucket->dueCallbacks);
+        }
+
+        for (UpdateCallbackList& slot : timerWheel)
         {
-            updateCallback->engine = nullptr;
+            lists.push_back(&slot);
         }
 
-        for (UpdateCallback* updateCallback : updateCallbacks)
+        for (UpdateCallbackList* list : lists)
         {
-            auto i = std::find(updateCallbackDeleteSet.begin(), updateCallbackDeleteSet.end(), updateCallback);
-            if (i == updateCallbackDeleteSet.end()) updateCallback->engine = nullptr;
+            while (UpdateCallback* updateCallback = list->getFirst())
+            {
+                list->remove(updateCallback);
+                updateCallback->engine = nullptr;
+            }
         }
 
         sharedEngine = nullptr;
@@ -262,6 +279,25 @@ namespace ouzel
             }
         }
 
+        std::string updateRateValue = userSettings.getValue("engine", "updateRate", defaultSettings.getValue("engine", "updateRate"));
+
+        if (!updateRateValue.empty())
+        {
+            if (updateRateValue == "vsync")
+            {
+                framePacer.setMode(FramePacer::Mode::VSYNC);
+            }
+            else if (updateRateValue == "uncapped")
+            {
+                framePacer.setMode(FramePacer::Mode::UNCAPPED);
+            }
+            else
+            {
+                framePacer.setMode(FramePacer::Mode::TARGET_RATE);
+                framePacer.setTargetRate(std::stof(updateRateValue));
+            }
+        }
+
         std::string debugAudioValue = userSettings.getValue("engine", "debugAudio", defaultSettings.getValue("engine", "debugAudio"));
         if (!debugAudioValue.empty()) debugAudio = (debugAudioValue == "true" || debugAudioValue == "1" || debugAudioValue == "yes");
 
@@ -477,63 +513,45 @@ namespace ouzel
 
         if (diff > std::chrono::milliseconds(1)) // at least one millisecond has passed
         {
-            executeAll();
+            profiler.beginFrame();
+            OUZEL_PROFILE_SCOPE(&profiler, "Update");
+
+            {
+                OUZEL_PROFILE_SCOPE(&profiler, "Execute");
+                executeAll();
+            }
 
             previousUpdateTime = currentTime;
             float delta = std::chrono::duration_cast<std::chrono::microseconds>(diff).count() / 1000000.0f;
 
-            eventDispatcher.dispatchEvents();
-            timer.update(delta);
-
-            for (UpdateCallback* updateCallback : updateCallbackDeleteSet)
             {
-                auto i = std::find(updateCallbacks.begin(), updateCallbacks.end(), updateCallback);
-
-                if (i != updateCallbacks.end())
-                {
-                    updateCallbacks.erase(i);
-                }
+                OUZEL_PROFILE_SCOPE(&profiler, "Events");
+                eventDispatcher.dispatchEvents();
             }
 
-            updateCallbackDeleteSet.clear();
+            timer.update(delta);
 
-            for (UpdateCallback* updateCallback : updateCallbackAddSet)
             {
-                auto i = std::find(updateCallbacks.begin(), updateCallbacks.end(), updateCallback);
-
-                if (i == updateCallbacks.end())
-                {
-                    auto upperBound = std::upper_bound(updateCallbacks.begin(), updateCallbacks.end(), updateCallback,
-                                                       [](const UpdateCallback* a, const UpdateCallback* b) {
-                                                           return a->priority > b->priority;
-                                                       });
-
-                    updateCallbacks.insert(upperBound, updateCallback);
-                }
+                OUZEL_PROFILE_SCOPE(&profiler, "Update callbacks");
+                dispatchUpdateCallbacks(delta);
             }
 
-            updateCallbackAddSet.clear();
+            bool refillQueue = renderer->getDevice()->getRefillQueue();
 
-            for (UpdateCallback* updateCallback : updateCallbacks)
             {
-                auto i = std::find(updateCallbackDeleteSet.begin(), updateCallbackDeleteSet.end(), updateCallback);
+                OUZEL_PROFILE_SCOPE(&profiler, "Particles");
+                sceneManager.getParticleManager()->update(delta, refillQueue);
+            }
 
-                if (i == updateCallbackDeleteSet.end())
+            if (refillQueue)
+            {
                 {
-                    updateCallback->timeSinceLastUpdate += delta;
-
-                    if (updateCallback->timeSinceLastUpdate >= updateCallback->interval)
-                    {
-                        updateCallback->timeSinceLastUpdate = (updateCallback->interval > 0.0f) ? fmodf(updateCallback->timeSinceLastUpdate, updateCallback->interval) : 0.0f;
-                        if (updateCallback->callback) updateCallback->callback(delta);
-                    }
+                    OUZEL_PROFILE_SCOPE(&profiler, "Scene draw");
+                    sceneManager.draw();
                 }
-            }
 
-            if (renderer->getDevice()->getRefillQueue())
-            {
-                sceneManager.draw();
-                renderer->getDevice()->flushCommands();
+                OUZEL_PROFILE_SCOPE(&profiler, "Flush");
+                renderer->flushCommands();
             }
 
             audio->update();
@@ -542,6 +560,8 @@ namespace ouzel
 
     void Engine::main()
     {
+        updateThreadId = std::this_thread::get_id();
+
         ouzelMain(args);
 
 #if OUZEL_MULTITHREADED
@@ -551,9 +571,9 @@ namespace ouzel
         {
             if (!paused)
             {
+                // sleeps until the next update to reduce the power consumption
+                framePacer.wait();
                 update();
-
-                // TODO: implement sleep to reduce the power consumption
             }
             else
             {
@@ -575,14 +595,8 @@ namespace ouzel
 
         callback->engine = this;
 
-        updateCallbackAddSet.insert(callback);
-
-        auto setIterator = updateCallbackDeleteSet.find(callback);
-
-        if (setIterator != updateCallbackDeleteSet.end())
-        {
-            updateCallbackDeleteSet.erase(setIterator);
-        }
+        // the callbacks that are scheduled during an update are called from the next update on
+        addedUpdateCallbacks.pushBack(callback);
     }
 
     void Engine::unscheduleUpdate(UpdateCallback* callback)
@@ -592,44 +606,153 @@ namespace ouzel
             callback->engine = nullptr;
         }
 
-        updateCallbackDeleteSet.insert(callback);
+        if (callback->list)
+        {
+            if (callback == nextUpdateCallback) nextUpdateCallback = callback->next;
+            callback->list->remove(callback);
+        }
+    }
+
+    void Engine::linkUpdateCallback(UpdateCallback* callback)
+    {
+        auto bucketIterator = updateBuckets.find(callback->priority);
+
+        if (bucketIterator == updateBuckets.end())
+        {
+            // a new priority, the buckets are never removed, so this happens once for every priority
+            UpdateBucket& bucket = updateBuckets[callback->priority];
+            bucket.priority = callback->priority;
+
+            auto upperBound = std::upper_bound(sortedUpdateBuckets.begin(), sortedUpdateBuckets.end(), &bucket,
+                                               [](const UpdateBucket* a, const UpdateBucket* b) {
+                                                   return a->priority > b->priority;
+                                               });
 
-        auto setIterator = updateCallbackAddSet.find(callback);
+            sortedUpdateBuckets.insert(upperBound, &bucket);
+            callback->bucket = &bucket;
+        }
+        else
+        {
+            callback->bucket = &bucketIterator->second;
+        }
 
-        if (setIterator != updateCallbackAddSet.end())
+        if (callback->interval > 0.0f)
         {
-            updateCallbackAddSet.erase(setIterator);
+            scheduleTimer(callback, timerTime + getIntervalTime(callback->interval));
         }
+        else
+        {
+            callback->bucket->callbacks.pushBack(callback);
+        }
+    }
+
+    uint64_t Engine::getIntervalTime(float interval)
+    {
+        return std::max(static_cast<uint64_t>(interval * 1000000.0f), static_cast<uint64_t>(1));
     }
 
-    void Engine::executeOnUpdateThread(const std::function<void(void)>& func)
+    void Engine::scheduleTimer(UpdateCallback* callback, uint64_t deadline)
     {
-        std::lock_guard<std::mutex> lock(executeMutex);
+        // the slots of the current time are already visited
+        if (deadline <= timerTime) deadline = timerTime + 1;
 
-        executeQueue.push(func);
+        callback->deadline = deadline;
+        timerWheel[(deadline / TIMER_SLOT_TIME) % TIMER_WHEEL_SIZE].pushBack(callback);
     }
 
-    void Engine::executeAll()
+    void Engine::dispatchUpdateCallbacks(float delta)
     {
-        std::function<void(void)> func;
+        uint64_t newTimerTime = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(previousUpdateTime - timerStartTime).count());
 
-        for (;;)
+        // every slot is visited at most once, the callbacks that are due later stay in their slots,
+        // the slot of the previous update is visited again, because its later deadlines were not due then
+        uint64_t firstSlot = timerTime / TIMER_SLOT_TIME;
+        uint64_t slotCount = std::min(newTimerTime / TIMER_SLOT_TIME - firstSlot + 1, static_cast<uint64_t>(TIMER_WHEEL_SIZE));
+
+        for (uint64_t i = 0; i < slotCount; ++i)
         {
+            UpdateCallbackList& slot = timerWheel[(firstSlot + i) % TIMER_WHEEL_SIZE];
+
+            for (UpdateCallback* callback = slot.getFirst(); callback;)
             {
-                std::lock_guard<std::mutex> lock(executeMutex);
-                if (executeQueue.empty()) break;
+                UpdateCallback* next = callback->next;
+
+                if (callback->deadline <= newTimerTime)
+                {
+                    slot.remove(callback);
+                    callback->bucket->dueCallbacks.pushBack(callback);
+                }
 
-                func = std::move(executeQueue.front());
-                executeQueue.pop();
+                callback = next;
             }
+        }
 
-            if (func)
+        timerTime = newTimerTime;
+
+        while (UpdateCallback* callback = addedUpdateCallbacks.getFirst())
+        {
+            addedUpdateCallbacks.remove(callback);
+            linkUpdateCallback(callback);
+        }
+
+        // the callbacks of every update are called before the callbacks with an interval of the same priority
+        for (UpdateBucket* bucket : sortedUpdateBuckets)
+        {
+            for (UpdateCallback* callback = bucket->callbacks.getFirst(); callback; callback = nextUpdateCallback)
             {
-                func();
+                // the callback can remove the next callback
+                nextUpdateCallback = callback->next;
+
+                if (callback->interval > 0.0f)
+                {
+                    // the interval was set after the callback was scheduled
+                    bucket->callbacks.remove(callback);
+                    scheduleTimer(callback, timerTime + getIntervalTime(callback->interval));
+                }
+                else if (callback->callback)
+                {
+                    callback->callback(delta);
+                }
+            }
+
+            nextUpdateCallback = nullptr;
+
+            while (UpdateCallback* callback = bucket->dueCallbacks.getFirst())
+            {
+                bucket->dueCallbacks.remove(callback);
+
+                if (callback->interval <= 0.0f)
+                {
+                    // the interval was cleared, the callback is called on every update from now on
+                    bucket->callbacks.pushBack(callback);
+                    if (callback->callback) callback->callback(delta);
+                    continue;
+                }
+
+                // rescheduled before the call, so that the callback can remove itself
+                uint64_t interval = getIntervalTime(callback->interval);
+                uint64_t deadline = callback->deadline + interval;
+
+                // skip the intervals that were missed
+                if (deadline <= timerTime) deadline = timerTime + interval - (timerTime - callback->deadline) % interval;
+
+                scheduleTimer(callback, deadline);
+
+                if (callback->callback) callback->callback(delta);
             }
         }
     }
 
+    void Engine::executeOnUpdateThread(Function&& func)
+    {
+        executeQueue.push(std::move(func));
+    }
+
+    void Engine::executeAll()
+    {
+        executeQueue.executeAll();
+    }
+
     bool Engine::openURL(const std::string&)
     {
         return false;
@@ -640,8 +763,10 @@ namespace ouzel
         screenSaverEnabled = newScreenSaverEnabled;
     }
 
-    bool Engine::setCurrentThreadName(const std::string&)
+    bool Engine::setCurrentThreadName(const std::string& name)
     {
+        profiler.setThreadName(name);
+
         return false;
     }
 }
@@ -5,6 +5,7 @@
 
 #include <memory>
 #include <set>
+#include <unordered_map>
 #include <vector>
 #include <functional>
 #include <thread>
@@ -14,6 +15,8 @@
 #include "utils/Noncopyable.hpp"
 #include "core/UpdateCallback.hpp"
 #include "core/Timer.hpp"
+#include "core/FramePacer.hpp"
+#include "core/JobSystem.hpp"
 #include "core/Window.hpp"
 #include "graphics/Renderer.hpp"
 #include "audio/Audio.hpp"
@@ -24,6 +27,8 @@
 #include "localization/Localization.hpp"
 #include "network/Network.hpp"
 #include "utils/INI.hpp"
+#include "utils/Profiler.hpp"
+#include "utils/ExecuteQueue.hpp"
 
 void ouzelMain(const std::vector<std::string>& args);
 
@@ -44,6 +49,9 @@ namespace ouzel
         FileSystem* getFileSystem() { return fileSystem.get(); }
         EventDispatcher* getEventDispatcher() { return &eventDispatcher; }
         Timer* getTimer() { return &timer; }
+        FramePacer* getFramePacer() { return &framePacer; }
+        JobSystem* getJobSystem() { return &jobSystem; }
+        Profiler* getProfiler() { return &profiler; }
         Cache* getCache() { return &cache; }
         Window* getWindow() { return &window; }
         graphics::Renderer* getRenderer() const { return renderer.get(); }
@@ -68,7 +76,9 @@ namespace ouzel
         void scheduleUpdate(UpdateCallback* callback);
         void unscheduleUpdate(UpdateCallback* callback);
 
-        void executeOnUpdateThread(const std::function<void(void)>& func);
+        void executeOnUpdateThread(Function&& func);
+        // the thread that runs ouzelMain and the update loop
+        bool isUpdateThread() const { return std::this_thread::get_id() == updateThreadId; }
 
         void update();
 
@@ -85,9 +95,12 @@ namespace ouzel
         virtual void main();
         void executeAll();
 
+        Profiler profiler;
         std::unique_ptr<FileSystem> fileSystem;
         EventDispatcher eventDispatcher;
         Timer timer;
+        FramePacer framePacer;
+        JobSystem jobSystem;
         Window window;
         std::unique_ptr<graphics::Renderer> renderer;
         std::unique_ptr<audio::Audio> audio;
@@ -102,9 +115,23 @@ namespace ouzel
 
         std::chrono::steady_clock::time_point previousUpdateTime;
 
-        std::vector<UpdateCallback*> updateCallbacks;
-        std::set<UpdateCallback*> updateCallbackAddSet;
-        std::set<UpdateCallback*> updateCallbackDeleteSet;
+        static const uint32_t TIMER_WHEEL_SIZE = 256;
+        static const uint64_t TIMER_SLOT_TIME = 1000; // microseconds, the deadlines in a slot are exact
+
+        void linkUpdateCallback(UpdateCallback* callback);
+        static uint64_t getIntervalTime(float interval); // in microseconds
+        void scheduleTimer(UpdateCallback* callback, uint64_t deadline);
+        void dispatchUpdateCallbacks(float delta);
+
+        UpdateCallbackList addedUpdateCallbacks; // linked on the next update
+        std::unordered_map<int32_t, UpdateBucket> updateBuckets;
+        std::vector<UpdateBucket*> sortedUpdateBuckets; // by the descending priority
+        UpdateCallbackList timerWheel[TIMER_WHEEL_SIZE];
+        uint64_t timerTime = 0; // microseconds since the engine was created
+        std::chrono::steady_clock::time_point timerStartTime;
+        UpdateCallback* nextUpdateCallback = nullptr; // next callback of the dispatch loop
+
+        std::atomic<std::thread::id> updateThreadId;
 
 #if OUZEL_MULTITHREADED
         std::thread updateThread;
@@ -112,8 +139,7 @@ namespace ouzel
         std::condition_variable updateCondition;
 #endif
 
-        std::queue<std::function<void(void)>> executeQueue;
-        std::mutex executeMutex;
+        ExecuteQueue executeQueue;
 
         std::atomic<bool> active;
         std::atomic<bool> paused;
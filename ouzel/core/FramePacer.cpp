@@ -0,0 +1,100 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include "FramePacer.hpp"
+#include "Engine.hpp"
+#include "graphics/RenderDevice.hpp"
+#include "math/MathUtils.hpp"
+
+namespace ouzel
+{
+    FramePacer::FramePacer():
+        mode(Mode::VSYNC), targetRate(60.0f), frameTime(0.0f), jitter(0.0f)
+    {
+    }
+
+    void FramePacer::setMode(Mode newMode)
+    {
+        mode = newMode;
+    }
+
+    void FramePacer::setTargetRate(float newTargetRate)
+    {
+        if (newTargetRate > 0.0f)
+        {
+            targetRate = newTargetRate;
+        }
+    }
+
+    void FramePacer::wait()
+    {
+        switch (mode)
+        {
+            case Mode::UNCAPPED:
+                break;
+            case Mode::TARGET_RATE:
+            {
+                std::chrono::steady_clock::duration period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(1.0f / targetRate));
+                std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+
+                // don't try to catch up if the updates are more than a frame late
+                if (!started || currentTime > deadline + period)
+                {
+                    deadline = currentTime;
+                }
+
+                deadline += period;
+                sleepUntil(deadline);
+                break;
+            }
+            case Mode::VSYNC:
+                // the render thread frees a frame after it has presented one
+                sharedEngine->getRenderer()->getDevice()->waitForRefillQueue(std::chrono::milliseconds(100));
+                break;
+        }
+
+        std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+
+        if (started)
+        {
+            float interval = std::chrono::duration_cast<std::chrono::nanoseconds>(currentTime - previousUpdateTime).count() / 1000000000.0f;
+            float currentFrameTime = frameTime;
+            float currentJitter = jitter;
+
+            currentFrameTime += (interval - currentFrameTime) * 0.1f;
+            currentJitter += (fabsf(interval - currentFrameTime) - currentJitter) * 0.1f;
+
+            frameTime = currentFrameTime;
+            jitter = currentJitter;
+        }
+
+        previousUpdateTime = currentTime;
+        started = true;
+    }
+
+    void FramePacer::sleepUntil(const std::chrono::steady_clock::time_point& wakeTime)
+    {
+        std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+        float remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(wakeTime - currentTime).count() / 1000000000.0f;
+
+        // sleep for the most of the time to save power, the sleep can wake up late, so the rest is spun
+        if (remaining > sleepOvershoot)
+        {
+            float sleepTime = remaining - sleepOvershoot;
+            std::this_thread::sleep_for(std::chrono::duration<float>(sleepTime));
+
+            float actualSleepTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - currentTime).count() / 1000000000.0f;
+
+            // decaying peak of the overshoot, grows immediately if the timer gets coarser
+            sleepOvershoot = clamp(std::max(actualSleepTime - sleepTime, sleepOvershoot * 0.99f), 0.0001f, 0.02f);
+        }
+
+        while (std::chrono::steady_clock::now() < wakeTime)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
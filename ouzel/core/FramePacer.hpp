@@ -0,0 +1,56 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include "utils/Noncopyable.hpp"
+
+namespace ouzel
+{
+    class Engine;
+
+    // limits the rate of the update loop
+    class FramePacer: public Noncopyable
+    {
+        friend Engine;
+    public:
+        enum class Mode
+        {
+            UNCAPPED, // update as fast as possible
+            TARGET_RATE, // update at the target rate
+            VSYNC // wait until the render thread has a free frame, so the updates follow the presentation rate
+        };
+
+        void setMode(Mode newMode);
+        Mode getMode() const { return mode; }
+
+        // updates per second for the TARGET_RATE mode
+        void setTargetRate(float newTargetRate);
+        float getTargetRate() const { return targetRate; }
+
+        // smoothed time between two updates in seconds
+        float getFrameTime() const { return frameTime; }
+        // smoothed absolute deviation of the time between two updates from the frame time in seconds
+        float getJitter() const { return jitter; }
+
+    protected:
+        FramePacer();
+
+        // called by the update thread before every update
+        void wait();
+        void sleepUntil(const std::chrono::steady_clock::time_point& wakeTime);
+
+        std::atomic<Mode> mode;
+        std::atomic<float> targetRate;
+
+        std::chrono::steady_clock::time_point deadline;
+        std::chrono::steady_clock::time_point previousUpdateTime;
+        bool started = false;
+
+        float sleepOvershoot = 0.001f; // how late the sleeps wake up, the rest of the wait is spun
+        std::atomic<float> frameTime;
+        std::atomic<float> jitter;
+    };
+}
@@ -0,0 +1,288 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include "JobSystem.hpp"
+
+namespace ouzel
+{
+    JobSystem::JobSystem(uint32_t aWorkerCount):
+        pendingJobCount(0), waitingThreadCount(0)
+    {
+#if OUZEL_MULTITHREADED
+        uint32_t workerCount = aWorkerCount ? aWorkerCount : std::max(std::thread::hardware_concurrency(), 1U);
+
+        for (uint32_t i = 0; i <= workerCount; ++i)
+        {
+            queues.push_back(std::unique_ptr<Queue>(new Queue()));
+        }
+
+        // the workers look up the ids only when they schedule jobs, which is after the constructor has returned
+        for (uint32_t i = 0; i < workerCount; ++i)
+        {
+            workers.push_back(std::thread(&JobSystem::run, this, i));
+            workerIds.push_back(workers.back().get_id());
+        }
+#else
+        (void)aWorkerCount;
+        queues.push_back(std::unique_ptr<Queue>(new Queue()));
+#endif
+    }
+
+    JobSystem::~JobSystem()
+    {
+        stop();
+    }
+
+    void JobSystem::stop()
+    {
+#if OUZEL_MULTITHREADED
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            running = false;
+        }
+
+        startCondition.notify_all();
+
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+
+        workers.clear();
+        workerIds.clear();
+#endif
+    }
+
+    uint32_t JobSystem::getWorkerCount() const
+    {
+#if OUZEL_MULTITHREADED
+        return static_cast<uint32_t>(workers.size());
+#else
+        return 0;
+#endif
+    }
+
+    JobHandle JobSystem::schedule(const std::function<void(void)>& function,
+                                  const std::vector<JobHandle>& dependencies)
+    {
+        std::shared_ptr<Job> job = std::make_shared<Job>(function);
+
+        for (const JobHandle& dependency : dependencies)
+        {
+            if (!dependency.job) continue;
+
+            std::unique_lock<std::mutex> lock(dependency.job->dependentMutex);
+
+            if (!dependency.job->finished)
+            {
+                ++job->waitCount;
+                dependency.job->dependents.push_back(job);
+            }
+        }
+
+        // the last finished dependency enqueues the job
+        if (--job->waitCount == 0)
+        {
+            enqueue(job);
+        }
+
+        return JobHandle(job);
+    }
+
+    void JobSystem::wait(const JobHandle& handle)
+    {
+        if (!handle.job) return;
+
+        uint32_t queueIndex = getQueueIndex();
+
+        while (!handle.job->finished)
+        {
+            if (std::shared_ptr<Job> job = findJob(queueIndex))
+            {
+                execute(job);
+            }
+            else
+            {
+#if OUZEL_MULTITHREADED
+                std::unique_lock<std::mutex> lock(mutex);
+                ++waitingThreadCount;
+                finishCondition.wait(lock, [this, &handle]() { return handle.job->finished || pendingJobCount > 0; });
+                --waitingThreadCount;
+#endif
+            }
+        }
+    }
+
+    void JobSystem::parallelFor(uint32_t count, const std::function<void(uint32_t)>& function, uint32_t batchSize)
+    {
+        if (count == 0) return;
+
+        uint32_t threadCount = getWorkerCount() + 1;
+
+        if (threadCount == 1 || count == 1)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                function(i);
+            }
+
+            return;
+        }
+
+        // a few batches per thread, so that the threads that finish early can steal the rest
+        if (batchSize == 0) batchSize = std::max(count / (threadCount * 4), 1U);
+
+        std::vector<JobHandle> handles;
+        handles.reserve((count + batchSize - 1) / batchSize);
+
+        for (uint32_t start = 0; start < count; start += batchSize)
+        {
+            uint32_t end = std::min(start + batchSize, count);
+
+            handles.push_back(schedule([&function, start, end]() {
+                for (uint32_t i = start; i < end; ++i)
+                {
+                    function(i);
+                }
+            }));
+        }
+
+        for (const JobHandle& handle : handles)
+        {
+            wait(handle);
+        }
+    }
+
+    void JobSystem::enqueue(const std::shared_ptr<Job>& job)
+    {
+        if (getWorkerCount() == 0)
+        {
+            execute(job);
+            return;
+        }
+
+#if OUZEL_MULTITHREADED
+        Queue& queue = *queues[getQueueIndex()];
+
+        // counted before it is pushed, so that the count does not go below zero when the job is stolen right away
+        ++pendingJobCount;
+
+        {
+            std::unique_lock<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back(job);
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+        }
+
+        startCondition.notify_one();
+
+        if (waitingThreadCount > 0) finishCondition.notify_all();
+#endif
+    }
+
+    std::shared_ptr<Job> JobSystem::findJob(uint32_t queueIndex)
+    {
+        std::shared_ptr<Job> result;
+
+        if (pendingJobCount == 0) return result;
+
+        const uint32_t queueCount = static_cast<uint32_t>(queues.size());
+
+        // the newest job of the own queue is the most likely to have its data in the cache
+        {
+            Queue& queue = *queues[queueIndex];
+            std::unique_lock<std::mutex> lock(queue.mutex);
+
+            if (!queue.jobs.empty())
+            {
+                result = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+            }
+        }
+
+        // steal the oldest jobs from the other queues
+        for (uint32_t i = 1; !result && i < queueCount; ++i)
+        {
+            Queue& queue = *queues[(queueIndex + i) % queueCount];
+            std::unique_lock<std::mutex> lock(queue.mutex);
+
+            if (!queue.jobs.empty())
+            {
+                result = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+            }
+        }
+
+        if (result) --pendingJobCount;
+
+        return result;
+    }
+
+    void JobSystem::execute(const std::shared_ptr<Job>& job)
+    {
+        job->function();
+
+        std::vector<std::shared_ptr<Job>> dependents;
+
+        {
+            std::unique_lock<std::mutex> lock(job->dependentMutex);
+            job->finished = true;
+            dependents.swap(job->dependents);
+        }
+
+        for (const std::shared_ptr<Job>& dependent : dependents)
+        {
+            if (--dependent->waitCount == 0)
+            {
+                enqueue(dependent);
+            }
+        }
+
+#if OUZEL_MULTITHREADED
+        if (waitingThreadCount > 0)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            finishCondition.notify_all();
+        }
+#endif
+    }
+
+    uint32_t JobSystem::getQueueIndex() const
+    {
+#if OUZEL_MULTITHREADED
+        std::thread::id threadId = std::this_thread::get_id();
+
+        for (uint32_t i = 0; i < workerIds.size(); ++i)
+        {
+            if (workerIds[i] == threadId) return i;
+        }
+#endif
+
+        return static_cast<uint32_t>(queues.size() - 1);
+    }
+
+#if OUZEL_MULTITHREADED
+    void JobSystem::run(uint32_t workerIndex)
+    {
+        for (;;)
+        {
+            if (std::shared_ptr<Job> job = findJob(workerIndex))
+            {
+                execute(job);
+            }
+            else
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+
+                // the remaining jobs are run before the worker exits
+                if (!running && pendingJobCount == 0) break;
+
+                startCondition.wait(lock, [this]() { return !running || pendingJobCount > 0; });
+            }
+        }
+    }
+#endif
+}
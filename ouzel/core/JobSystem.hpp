@@ -0,0 +1,112 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include "Setup.h"
+#if OUZEL_MULTITHREADED
+#include <thread>
+#include <condition_variable>
+#endif
+#include "utils/Noncopyable.hpp"
+
+namespace ouzel
+{
+    class JobSystem;
+    class JobHandle;
+
+    class Job: public Noncopyable
+    {
+        friend JobSystem;
+        friend JobHandle;
+    public:
+        explicit Job(const std::function<void(void)>& aFunction):
+            function(aFunction), waitCount(1), finished(false)
+        {
+        }
+
+    protected:
+        std::function<void(void)> function;
+        std::atomic<uint32_t> waitCount; // unfinished dependencies, plus one until the job is scheduled
+        std::atomic<bool> finished;
+
+        std::mutex dependentMutex;
+        std::vector<std::shared_ptr<Job>> dependents; // jobs that wait for this job
+    };
+
+    // reference to a scheduled job, used to wait for the job or to start other jobs after it
+    class JobHandle
+    {
+        friend JobSystem;
+    public:
+        JobHandle() {}
+
+        bool isValid() const { return job != nullptr; }
+        bool isFinished() const { return !job || job->finished; }
+
+    protected:
+        explicit JobHandle(const std::shared_ptr<Job>& aJob): job(aJob) {}
+
+        std::shared_ptr<Job> job;
+    };
+
+    // pool of worker threads, every worker has its own queue and steals jobs from the others when it runs out of them
+    class JobSystem: public Noncopyable
+    {
+    public:
+        // 0 starts one worker for every hardware core
+        explicit JobSystem(uint32_t aWorkerCount = 0);
+        ~JobSystem();
+
+        // runs the remaining jobs and stops the workers, jobs scheduled after this run on the calling thread
+        void stop();
+
+        uint32_t getWorkerCount() const;
+
+        // runs the function after all the dependencies have finished
+        JobHandle schedule(const std::function<void(void)>& function,
+                           const std::vector<JobHandle>& dependencies = std::vector<JobHandle>());
+
+        // runs other jobs on the calling thread until the job has finished
+        void wait(const JobHandle& handle);
+
+        // calls the function for every index from 0 to count - 1 in batches of batchSize indices (0 picks the size)
+        // and returns after all the calls have finished, can be called from jobs
+        void parallelFor(uint32_t count, const std::function<void(uint32_t)>& function, uint32_t batchSize = 0);
+
+    protected:
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<std::shared_ptr<Job>> jobs;
+        };
+
+        void enqueue(const std::shared_ptr<Job>& job);
+        std::shared_ptr<Job> findJob(uint32_t queueIndex);
+        void execute(const std::shared_ptr<Job>& job);
+        uint32_t getQueueIndex() const;
+
+#if OUZEL_MULTITHREADED
+        void run(uint32_t workerIndex);
+
+        std::vector<std::thread> workers;
+        std::vector<std::thread::id> workerIds;
+        std::condition_variable startCondition; // workers wait for jobs
+        std::condition_variable finishCondition; // threads in wait() wait for jobs to finish
+#endif
+        // one queue for every worker and the last one for the other threads
+        std::vector<std::unique_ptr<Queue>> queues;
+
+        std::mutex mutex;
+        bool running = true;
+        std::atomic<uint32_t> pendingJobCount;
+        std::atomic<uint32_t> waitingThreadCount;
+    };
+}
@@ -19,4 +19,29 @@ namespace ouzel
             engine = nullptr;
         }
     }
+
+    void UpdateCallbackList::pushBack(UpdateCallback* callback)
+    {
+        callback->list = this;
+        callback->previous = last;
+        callback->next = nullptr;
+
+        if (last) last->next = callback;
+        else first = callback;
+
+        last = callback;
+    }
+
+    void UpdateCallbackList::remove(UpdateCallback* callback)
+    {
+        if (callback->previous) callback->previous->next = callback->next;
+        else first = callback->next;
+
+        if (callback->next) callback->next->previous = callback->previous;
+        else last = callback->previous;
+
+        callback->list = nullptr;
+        callback->previous = nullptr;
+        callback->next = nullptr;
+    }
 }
@@ -9,16 +9,34 @@
 namespace ouzel
 {
     class Engine;
+    class UpdateCallbackList;
+    struct UpdateBucket;
 
     class UpdateCallback
     {
         friend Engine;
+        friend UpdateCallbackList;
     public:
         static const int32_t PRIORITY_MAX = 0x1000;
 
         UpdateCallback(int32_t aPriority = 0): priority(aPriority) {}
         ~UpdateCallback();
 
+        // the copy is not scheduled
+        UpdateCallback(const UpdateCallback& other):
+            callback(other.callback), interval(other.interval), priority(other.priority)
+        {
+        }
+
+        UpdateCallback& operator=(const UpdateCallback& other)
+        {
+            callback = other.callback;
+            interval = other.interval;
+            priority = other.priority;
+
+            return *this;
+        }
+
         void remove();
 
         std::function<void(float)> callback;
@@ -27,6 +45,34 @@ namespace ouzel
     protected:
         int32_t priority;
         Engine* engine = nullptr;
-        float timeSinceLastUpdate = 0.0f;
+
+        // the engine keeps the scheduled callbacks in intrusive lists
+        UpdateCallbackList* list = nullptr;
+        UpdateCallback* previous = nullptr;
+        UpdateCallback* next = nullptr;
+        UpdateBucket* bucket = nullptr;
+        uint64_t deadline = 0; // in microseconds, for the callbacks with an interval
+    };
+
+    class UpdateCallbackList
+    {
+    public:
+        UpdateCallback* getFirst() const { return first; }
+        bool isEmpty() const { return first == nullptr; }
+
+        void pushBack(UpdateCallback* callback);
+        void remove(UpdateCallback* callback);
+
+    private:
+        UpdateCallback* first = nullptr;
+        UpdateCallback* last = nullptr;
+    };
+
+    // scheduled callbacks with the same priority
+    struct UpdateBucket
+    {
+        int32_t priority;
+        UpdateCallbackList callbacks; // called on every update
+        UpdateCallbackList dueCallbacks; // callbacks with an interval that are called on this update
     };
 }
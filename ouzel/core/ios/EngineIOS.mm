@@ -117,6 +117,8 @@ namespace ouzel
 
     bool EngineIOS::setCurrentThreadName(const std::string& name)
     {
+        profiler.setThreadName(name);
+
         [[NSThread currentThread] setName:[NSString stringWithCString:name.c_str() encoding:NSUTF8StringEncoding]];
 
         return true;
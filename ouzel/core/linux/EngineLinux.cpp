@@ -200,6 +200,8 @@ namespace ouzel
 
     bool EngineLinux::setCurrentThreadName(const std::string& name)
     {
+        profiler.setThreadName(name);
+
         return pthread_setname_np(pthread_self(), name.c_str()) == 0;
     }
 
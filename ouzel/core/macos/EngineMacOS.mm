@@ -139,6 +139,8 @@ namespace ouzel
 
     bool EngineMacOS::setCurrentThreadName(const std::string& name)
     {
+        profiler.setThreadName(name);
+
         [[NSThread currentThread] setName:[NSString stringWithCString:name.c_str() encoding:NSUTF8StringEncoding]];
 
         return true;
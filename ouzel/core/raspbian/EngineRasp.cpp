@@ -49,6 +49,8 @@ namespace ouzel
 
     bool EngineRasp::setCurrentThreadName(const std::string& name)
     {
+        profiler.setThreadName(name);
+
         return pthread_setname_np(pthread_self(), name.c_str()) == 0;
     }
 
@@ -186,6 +186,8 @@ namespace ouzel
 
     bool EngineWin::setCurrentThreadName(const std::string& name)
     {
+        profiler.setThreadName(name);
+
 #ifndef __GNUC__ // clang and gcc do not support SEH exceptions
         THREADNAME_INFO info;
         info.dwType = 0x1000;
@@ -1,11 +1,13 @@
 // Copyright (C) 2017 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <algorithm>
 #include "Buffer.hpp"
 #include "BufferResource.hpp"
 #include "Renderer.hpp"
 #include "RenderDevice.hpp"
 #include "core/Engine.hpp"
+#include "utils/Log.hpp"
 
 namespace ouzel
 {
@@ -59,17 +61,49 @@ namespace ouzel
 
         bool Buffer::setData(const void* newData, uint32_t newSize)
         {
-            return setData(std::vector<uint8_t>(static_cast<const uint8_t*>(newData),
-                                                static_cast<const uint8_t*>(newData) + newSize));
+            if (!sharedEngine->isUpdateThread())
+            {
+                return setData(std::vector<uint8_t>(static_cast<const uint8_t*>(newData),
+                                                    static_cast<const uint8_t*>(newData) + newSize));
+            }
+
+            uint8_t* streamData = reserveData(newSize);
+
+            if (!streamData)
+            {
+                return false;
+            }
+
+            std::copy(static_cast<const uint8_t*>(newData), static_cast<const uint8_t*>(newData) + newSize, streamData);
+
+            return true;
         }
 
         bool Buffer::setData(const std::vector<uint8_t>& newData)
         {
-            sharedEngine->getRenderer()->executeOnRenderThread(std::bind(&BufferResource::setData,
-                                                                         resource,
-                                                                         newData));
+            if (sharedEngine->isUpdateThread())
+            {
+                return setData(newData.data(), static_cast<uint32_t>(newData.size()));
+            }
+
+            // the streaming memory of the frame is owned by the update thread
+            BufferResource* bufferResource = resource;
+            sharedEngine->getRenderer()->executeOnRenderThread([bufferResource, newData]() {
+                bufferResource->setData(newData.data(), static_cast<uint32_t>(newData.size()));
+            });
 
             return true;
         }
+
+        uint8_t* Buffer::reserveData(uint32_t newSize)
+        {
+            if (!sharedEngine->isUpdateThread())
+            {
+                Log(Log::Level::ERR) << "Buffer data can be reserved only on the update thread";
+                return nullptr;
+            }
+
+            return sharedEngine->getRenderer()->getDevice()->reserveStreamData(resource, newSize);
+        }
     } // namespace graphics
 } // namespace ouzel
@@ -35,9 +35,17 @@ namespace ouzel
             bool init(Usage newUsage, const void* newData, uint32_t newSize, uint32_t newFlags = 0);
             bool init(Usage newUsage, const std::vector<uint8_t>& newData, uint32_t newFlags = 0);
 
+            // on the update thread the data is copied to the streaming memory of the current frame,
+            // on the other threads it is passed to the render thread
             bool setData(const void* newData, uint32_t newSize);
             bool setData(const std::vector<uint8_t>& newData);
 
+            // returns memory for newSize bytes that are uploaded to the buffer before the current frame is drawn,
+            // can be filled directly instead of passing a copy to setData,
+            // must be called on the update thread (returns null otherwise), but the memory can be filled on any thread
+            // until the frame is flushed, other reservations do not move it
+            uint8_t* reserveData(uint32_t newSize);
+
             BufferResource* getResource() const { return resource; }
 
             uint32_t getFlags() const { return flags; }
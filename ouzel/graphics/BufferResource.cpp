@@ -2,6 +2,9 @@
 // This file is part of the Ouzel engine.
 
 #include "BufferResource.hpp"
+#include "RenderDevice.hpp"
+#include "RenderRecorder.hpp"
+#include "core/Engine.hpp"
 
 namespace ouzel
 {
@@ -30,17 +33,24 @@ namespace ouzel
             flags = newFlags;
             data = newData;
 
+            sharedEngine->getRenderer()->getDevice()->addBufferUpload(static_cast<uint32_t>(data.size()));
+
             return true;
         }
 
-        bool BufferResource::setData(const std::vector<uint8_t>& newData)
+        bool BufferResource::setData(const void* newData, uint32_t newSize)
         {
             if (!(flags & Buffer::DYNAMIC))
             {
                 return false;
             }
 
-            data = newData;
+            // reuses the allocated storage
+            data.assign(static_cast<const uint8_t*>(newData), static_cast<const uint8_t*>(newData) + newSize);
+
+            RenderDevice* renderDevice = sharedEngine->getRenderer()->getDevice();
+            renderDevice->addBufferUpload(newSize);
+            if (RenderRecorder* recorder = renderDevice->getRecorder()) recorder->recordBufferData(this, newData, newSize);
 
             return true;
         }
@@ -13,17 +13,19 @@ namespace ouzel
     namespace graphics
     {
         class Renderer;
+        class RenderRecorder;
 
         class BufferResource: public RenderResource
         {
             friend Renderer;
+            friend RenderRecorder;
         public:
             virtual ~BufferResource();
 
             virtual bool init(Buffer::Usage newUsage, uint32_t newFlags = 0, uint32_t newSize = 0);
             virtual bool init(Buffer::Usage newUsage, const std::vector<uint8_t>& newData, uint32_t newFlags = 0);
 
-            virtual bool setData(const std::vector<uint8_t>& newData);
+            virtual bool setData(const void* newData, uint32_t newSize);
 
             uint32_t getFlags() const { return flags; }
             Buffer::Usage getUsage() const { return usage; }
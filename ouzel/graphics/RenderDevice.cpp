@@ -3,7 +3,12 @@
 
 #include <algorithm>
 #include "RenderDevice.hpp"
+#include "BufferResource.hpp"
+#include "RenderRecorder.hpp"
+#include "math/MathUtils.hpp"
 #include "utils/Log.hpp"
+#include "utils/Utils.hpp"
+#include "core/Engine.hpp"
 
 namespace ouzel
 {
@@ -13,7 +18,11 @@ namespace ouzel
             driver(aDriver),
             projectionTransform(Matrix4::IDENTITY),
             renderTargetProjectionTransform(Matrix4::IDENTITY),
+            removedStateChangeCount(0),
+            pipeliningDepth(2),
             refillQueue(true),
+            updateStallTime(0),
+            renderStallTime(0),
             currentFPS(0.0f),
             accumulatedFPS(0.0f)
         {
@@ -70,38 +79,120 @@ namespace ouzel
                 currentAccumulatedFPS = 0.0f;
             }
 
-            std::vector<DrawCommand> drawCommands;
+            const DrawQueue* drawQueue = nullptr;
             {
-#if OUZEL_MULTITHREADED
                 std::unique_lock<std::mutex> lock(drawQueueMutex);
-                queueCondition.wait(lock, [this]() { return queueFinished; });
+#if OUZEL_MULTITHREADED
+                if (pendingFrameCount == 0)
+                {
+                    std::chrono::steady_clock::time_point waitStartTime = std::chrono::steady_clock::now();
+                    queueCondition.wait(lock, [this]() { return pendingFrameCount > 0; });
+                    uint64_t waitTime = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - waitStartTime).count());
+                    renderStallTime += waitTime;
+                    frameStatistics.waitTime = waitTime / 1000000000.0f;
+                }
 #endif
 
-                drawCommands = drawQueue;
-                drawQueue.clear();
-
-                queueFinished = false;
+                if (pendingFrameCount > 0)
+                {
+                    drawQueue = &drawQueues[drawQueueIndex];
+                }
             }
 
-            // refills the draw queue
-            refillQueue = true;
-
-            std::vector<std::unique_ptr<RenderResource>> deleteResources; // will be cleared at the end of the scope
             {
                 std::lock_guard<std::mutex> lock(resourceMutex);
-                deleteResources = std::move(resourceDeleteSet);
+                frameStatistics.resourcesCreated = createdResourceCount;
+                createdResourceCount = 0;
+            }
+
+            if (!drawQueue)
+            {
+                // nothing was queued yet (possible only without a separate render thread)
+                currentDrawQueue = &drawQueues[drawQueueIndex];
+                ++currentFrame;
+                bool result = draw(std::vector<DrawCommand>());
+                publishStatistics();
+                return result;
             }
 
+            // only the functions that were queued before the frame was finished, the rest belong to the next frames
             executeAll();
 
+            DrawQueue& frame = drawQueues[drawQueueIndex];
+            currentDrawQueue = &frame;
+
+            for (const StreamUpload& streamUpload : frame.streamUploads)
+            {
+                streamUpload.buffer->setData(streamUpload.data, streamUpload.size);
+            }
+
+            if (recorder)
+            {
+                // the commands are captured in the submission order, so that the replay can be used to compare sorting
+                recorder->recordFrame(frame.drawCommands, frame.shaderConstantRanges, frame.shaderConstantData);
+                // deleted resources are released only after the frame is drawn
+                recorder->recordDeletes(frame.deleteResources);
+
+                if (recorder->isFinished())
+                {
+                    recorder->save();
+                    recorder.reset();
+                }
+            }
+
+            if (drawCommandSorting)
+            {
+                std::chrono::steady_clock::time_point sortStartTime = std::chrono::steady_clock::now();
+                sortDrawCommands(frame.drawCommands);
+                frameStatistics.sortTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - sortStartTime).count() / 1000000000.0f;
+            }
+
             ++currentFrame;
 
-            if (!draw(drawCommands))
+            countStateChanges(frame.drawCommands, frameStatistics);
+
+            std::chrono::steady_clock::time_point drawStartTime = std::chrono::steady_clock::now();
+            bool result;
             {
-                return false;
+                OUZEL_PROFILE_SCOPE(sharedEngine->getProfiler(), "Device draw");
+                result = draw(frame.drawCommands);
             }
+            frameStatistics.drawTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - drawStartTime).count() / 1000000000.0f;
 
-            return true;
+            // the resources deleted MAX_PIPELINING_DEPTH frames ago are no longer used by any frame in flight,
+            // the storage is kept, so the next frame in this slot does not allocate
+            frame.deleteResources.swap(retiringResources[currentFrame % MAX_PIPELINING_DEPTH]);
+
+            frameStatistics.resourcesDeleted = static_cast<uint32_t>(frame.deleteResources.size());
+            publishStatistics();
+
+            frame.deleteResources.clear();
+            frame.drawCommands.clear();
+            frame.shaderConstantRanges.clear();
+            frame.shaderConstantData.clear();
+            frame.streamUploads.clear();
+            frame.streamChunkIndex = 0;
+            frame.streamChunkSize = 0;
+
+            {
+                std::lock_guard<std::mutex> lock(drawQueueMutex);
+                drawQueueIndex = (drawQueueIndex + 1) % DRAW_QUEUE_COUNT;
+                --pendingFrameCount;
+
+                if (queueFull && pendingFrameCount < pipeliningDepth)
+                {
+                    queueFull = false;
+                    updateStallTime += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - queueFullTime).count());
+                }
+
+                refillQueue = pendingFrameCount < pipeliningDepth;
+            }
+
+#if OUZEL_MULTITHREADED
+            refillCondition.notify_one();
+#endif
+
+            return result;
         }
 
         void RenderDevice::setClearColorBuffer(bool clear)
@@ -129,79 +220,450 @@ namespace ouzel
             size = newSize;
         }
 
+        void RenderDevice::setDrawCommandSorting(bool newDrawCommandSorting)
+        {
+            drawCommandSorting = newDrawCommandSorting;
+
+            if (!drawCommandSorting)
+            {
+                removedStateChangeCount = 0;
+            }
+        }
+
+        static inline uint64_t getSortId(std::unordered_map<const void*, uint32_t>& ids, const void* resource, uint32_t bits)
+        {
+            // resources get dense ids in the order they first appear in the frame, ids that don't fit share the last value
+            auto result = ids.insert(std::make_pair(resource, static_cast<uint32_t>(ids.size())));
+            uint64_t maxId = (1ULL << bits) - 1;
+
+            return std::min(static_cast<uint64_t>(result.first->second), maxId);
+        }
+
+        void RenderDevice::sortDrawCommands(std::vector<DrawCommand>& drawCommands)
+        {
+            if (drawCommands.size() < 2)
+            {
+                removedStateChangeCount = 0;
+                return;
+            }
+
+            uint32_t stateChangesBefore = countStateChanges(drawCommands);
+
+            for (std::unordered_map<const void*, uint32_t>& ids : sortResourceIds)
+            {
+                ids.clear();
+            }
+
+            // key layout (from the most significant bit):
+            // render target (8 bits), blend state (8 bits), shader (12 bits), texture (16 bits), mesh buffer (20 bits)
+            sortKeys.resize(drawCommands.size());
+
+            for (uint32_t i = 0; i < drawCommands.size(); ++i)
+            {
+                const DrawCommand& drawCommand = drawCommands[i];
+
+                uint64_t key = getSortId(sortResourceIds[0], drawCommand.renderTarget, 8) << 56;
+                key |= getSortId(sortResourceIds[1], drawCommand.blendState, 8) << 48;
+                key |= getSortId(sortResourceIds[2], drawCommand.shader, 12) << 36;
+                key |= getSortId(sortResourceIds[3], drawCommand.textures[0], 16) << 20;
+                key |= getSortId(sortResourceIds[4], drawCommand.meshBuffer, 20);
+
+                sortKeys[i] = std::make_pair(key, i);
+            }
+
+            sortKeysTemp.resize(sortKeys.size());
+
+            // commands can only be reordered inside a range that has the same order group
+            uint32_t rangeStart = 0;
+
+            while (rangeStart < drawCommands.size())
+            {
+                uint32_t rangeEnd = rangeStart + 1;
+
+                while (rangeEnd < drawCommands.size() &&
+                       drawCommands[rangeEnd].orderGroup == drawCommands[rangeStart].orderGroup)
+                {
+                    ++rangeEnd;
+                }
+
+                if (rangeEnd - rangeStart > 1)
+                {
+                    // stable LSD radix sort, one byte per pass
+                    std::pair<uint64_t, uint32_t>* source = sortKeys.data() + rangeStart;
+                    std::pair<uint64_t, uint32_t>* destination = sortKeysTemp.data() + rangeStart;
+                    uint32_t count = rangeEnd - rangeStart;
+
+                    for (uint32_t shift = 0; shift < 64; shift += 8)
+                    {
+                        uint32_t offsets[256] = {0};
+
+                        for (uint32_t i = 0; i < count; ++i)
+                        {
+                            ++offsets[(source[i].first >> shift) & 0xFF];
+                        }
+
+                        // skip the pass if all keys have the same byte
+                        if (offsets[(source[0].first >> shift) & 0xFF] == count)
+                        {
+                            continue;
+                        }
+
+                        uint32_t total = 0;
+
+                        for (uint32_t& offset : offsets)
+                        {
+                            uint32_t current = offset;
+                            offset = total;
+                            total += current;
+                        }
+
+                        for (uint32_t i = 0; i < count; ++i)
+                        {
+                            destination[offsets[(source[i].first >> shift) & 0xFF]++] = source[i];
+                        }
+
+                        std::swap(source, destination);
+                    }
+
+                    if (source != sortKeys.data() + rangeStart)
+                    {
+                        std::copy(source, source + count, sortKeys.data() + rangeStart);
+                    }
+                }
+
+                rangeStart = rangeEnd;
+            }
+
+            sortedDrawCommands.clear();
+            sortedDrawCommands.reserve(drawCommands.size());
+
+            for (const std::pair<uint64_t, uint32_t>& sortKey : sortKeys)
+            {
+                sortedDrawCommands.push_back(drawCommands[sortKey.second]);
+            }
+
+            drawCommands.swap(sortedDrawCommands);
+
+            uint32_t stateChangesAfter = countStateChanges(drawCommands);
+
+            removedStateChangeCount = (stateChangesBefore > stateChangesAfter) ? stateChangesBefore - stateChangesAfter : 0;
+        }
+
+        uint32_t RenderDevice::countStateChanges(const std::vector<DrawCommand>& drawCommands)
+        {
+            uint32_t result = 0;
+            const DrawCommand* previous = nullptr;
+
+            for (const DrawCommand& drawCommand : drawCommands)
+            {
+                if (!previous || previous->renderTarget != drawCommand.renderTarget) ++result;
+                if (!previous || previous->blendState != drawCommand.blendState) ++result;
+                if (!previous || previous->shader != drawCommand.shader) ++result;
+                if (!previous || !std::equal(std::begin(previous->textures), std::end(previous->textures), std::begin(drawCommand.textures))) ++result;
+                if (!previous || previous->meshBuffer != drawCommand.meshBuffer) ++result;
+
+                previous = &drawCommand;
+            }
+
+            return result;
+        }
+
+        void RenderDevice::countStateChanges(const std::vector<DrawCommand>& drawCommands, RenderStatistics& result)
+        {
+            const DrawCommand* previous = nullptr;
+
+            result.drawCalls = static_cast<uint32_t>(drawCommands.size());
+
+            for (const DrawCommand& drawCommand : drawCommands)
+            {
+                if (!previous || previous->shader != drawCommand.shader) ++result.shaderChanges;
+                if (!previous || !std::equal(std::begin(previous->textures), std::end(previous->textures), std::begin(drawCommand.textures))) ++result.textureChanges;
+                if (!previous || previous->blendState != drawCommand.blendState) ++result.blendStateChanges;
+                if (!previous || previous->renderTarget != drawCommand.renderTarget) ++result.renderTargetChanges;
+                if (!previous || previous->viewport != drawCommand.viewport) ++result.viewportChanges;
+
+                previous = &drawCommand;
+            }
+        }
+
+        void RenderDevice::publishStatistics()
+        {
+            frameStatistics.frame = currentFrame;
+
+            {
+                std::lock_guard<std::mutex> lock(statisticsMutex);
+                statistics = frameStatistics;
+            }
+
+            frameStatistics = RenderStatistics();
+        }
+
+        void RenderDevice::startRecording(const std::string& filename, uint32_t frameCount)
+        {
+            recorder.reset(new RenderRecorder(filename, frameCount, driver));
+        }
+
+        void RenderDevice::stopRecording()
+        {
+            if (recorder)
+            {
+                recorder->save();
+                recorder.reset();
+            }
+        }
+
+        RenderStatistics RenderDevice::getStatistics() const
+        {
+            std::lock_guard<std::mutex> lock(statisticsMutex);
+            return statistics;
+        }
+
         std::vector<Size2> RenderDevice::getSupportedResolutions() const
         {
             return std::vector<Size2>();
         }
 
-        void RenderDevice::deleteResource(RenderResource* resource)
+        void RenderDevice::addResource(RenderResource* resource)
         {
             std::lock_guard<std::mutex> lock(resourceMutex);
 
-            auto resourceIterator = std::find_if(resources.begin(), resources.end(), [resource](const std::unique_ptr<RenderResource>& ptr) {
-                return ptr.get() == resource;
-            });
+            uint32_t slot;
 
-            if (resourceIterator != resources.end())
+            if (freeResourceSlots.empty())
             {
-                resourceDeleteSet.push_back(std::move(*resourceIterator));
-                resources.erase(resourceIterator);
+                slot = static_cast<uint32_t>(resourceSlots.size());
+                resourceSlots.push_back(ResourceSlot());
             }
+            else
+            {
+                slot = freeResourceSlots.back();
+                freeResourceSlots.pop_back();
+            }
+
+            ResourceSlot& resourceSlot = resourceSlots[slot];
+            resourceSlot.resource.reset(resource);
+            resource->slot = slot;
+            resource->generation = resourceSlot.generation;
+
+            ++createdResourceCount;
         }
 
-        bool RenderDevice::addDrawCommand(const DrawCommand& drawCommand)
+        void RenderDevice::deleteResource(RenderResource* resource)
         {
-            std::lock_guard<std::mutex> lock(drawQueueMutex);
+            std::lock_guard<std::mutex> lock(resourceMutex);
 
-            drawQueue.push_back(drawCommand);
+            if (resource->slot < resourceSlots.size())
+            {
+                ResourceSlot& resourceSlot = resourceSlots[resource->slot];
 
-            return true;
+                // the generation check rejects resources that were already deleted
+                if (resourceSlot.generation == resource->generation &&
+                    resourceSlot.resource.get() == resource)
+                {
+                    resourceDeleteSet.push_back(std::move(resourceSlot.resource));
+                    ++resourceSlot.generation;
+                    freeResourceSlots.push_back(resource->slot);
+                }
+            }
         }
 
-        void RenderDevice::flushCommands()
+        void RenderDevice::releaseResources()
+        {
+            for (DrawQueue& drawQueue : drawQueues)
+            {
+                drawQueue.deleteResources.clear();
+            }
+
+            for (std::vector<std::unique_ptr<RenderResource>>& resources : retiringResources)
+            {
+                resources.clear();
+            }
+
+            std::lock_guard<std::mutex> lock(resourceMutex);
+
+            resourceDeleteSet.clear();
+            resourceSlots.clear();
+            freeResourceSlots.clear();
+        }
+
+        void RenderDevice::setPipeliningDepth(uint32_t newPipeliningDepth)
         {
             std::lock_guard<std::mutex> lock(drawQueueMutex);
-            refillQueue = false;
 
-            queueFinished = true;
-            drawCallCount = static_cast<uint32_t>(drawQueue.size());
+            pipeliningDepth = clamp(newPipeliningDepth, 1U, MAX_PIPELINING_DEPTH);
+            refillQueue = pendingFrameCount < pipeliningDepth;
 
 #if OUZEL_MULTITHREADED
-            queueCondition.notify_one();
+            refillCondition.notify_one();
 #endif
         }
 
-        bool RenderDevice::generateScreenshot(const std::string&)
+        void RenderDevice::waitForRefillQueue(const std::chrono::steady_clock::duration& timeout)
+        {
+#if OUZEL_MULTITHREADED
+            std::unique_lock<std::mutex> lock(drawQueueMutex);
+            refillCondition.wait_for(lock, timeout, [this]() { return pendingFrameCount < pipeliningDepth; });
+#else
+            OUZEL_UNUSED(timeout);
+#endif
+        }
+
+        bool RenderDevice::addDrawCommand(const DrawCommand& drawCommand,
+                                          std::initializer_list<Renderer::ShaderConstant> pixelShaderConstants,
+                                          std::initializer_list<Renderer::ShaderConstant> vertexShaderConstants)
         {
+            // the queue that is being filled is not accessed by the render thread until it is flushed
+            DrawQueue& drawQueue = drawQueues[fillQueueIndex];
+
+            drawQueue.drawCommands.push_back(drawCommand);
+            DrawCommand& queuedCommand = drawQueue.drawCommands.back();
+
+            queuedCommand.pixelShaderConstantStart = static_cast<uint32_t>(drawQueue.shaderConstantRanges.size());
+            queuedCommand.pixelShaderConstantCount = static_cast<uint32_t>(pixelShaderConstants.size());
+
+            for (const Renderer::ShaderConstant& shaderConstant : pixelShaderConstants)
+            {
+                ShaderConstantRange range = {static_cast<uint32_t>(drawQueue.shaderConstantData.size()), shaderConstant.size};
+                drawQueue.shaderConstantRanges.push_back(range);
+                drawQueue.shaderConstantData.insert(drawQueue.shaderConstantData.end(), shaderConstant.data, shaderConstant.data + shaderConstant.size);
+            }
+
+            queuedCommand.vertexShaderConstantStart = static_cast<uint32_t>(drawQueue.shaderConstantRanges.size());
+            queuedCommand.vertexShaderConstantCount = static_cast<uint32_t>(vertexShaderConstants.size());
+
+            for (const Renderer::ShaderConstant& shaderConstant : vertexShaderConstants)
+            {
+                ShaderConstantRange range = {static_cast<uint32_t>(drawQueue.shaderConstantData.size()), shaderConstant.size};
+                drawQueue.shaderConstantRanges.push_back(range);
+                drawQueue.shaderConstantData.insert(drawQueue.shaderConstantData.end(), shaderConstant.data, shaderConstant.data + shaderConstant.size);
+            }
+
             return true;
         }
 
-        void RenderDevice::executeOnRenderThread(const std::function<void(void)>& func)
+        bool RenderDevice::addDrawCommand(const DrawCommand& drawCommand,
+                                          const ShaderConstantRange* shaderConstantRanges,
+                                          const float* shaderConstantData)
         {
-            std::lock_guard<std::mutex> lock(executeMutex);
+            DrawQueue& drawQueue = drawQueues[fillQueueIndex];
+
+            drawQueue.drawCommands.push_back(drawCommand);
+            DrawCommand& queuedCommand = drawQueue.drawCommands.back();
+
+            queuedCommand.pixelShaderConstantStart = static_cast<uint32_t>(drawQueue.shaderConstantRanges.size());
+
+            for (uint32_t i = 0; i < drawCommand.pixelShaderConstantCount; ++i)
+            {
+                const ShaderConstantRange& sourceRange = shaderConstantRanges[drawCommand.pixelShaderConstantStart + i];
+                ShaderConstantRange range = {static_cast<uint32_t>(drawQueue.shaderConstantData.size()), sourceRange.size};
+                drawQueue.shaderConstantRanges.push_back(range);
+                drawQueue.shaderConstantData.insert(drawQueue.shaderConstantData.end(), shaderConstantData + sourceRange.offset, shaderConstantData + sourceRange.offset + sourceRange.size);
+            }
+
+            queuedCommand.vertexShaderConstantStart = static_cast<uint32_t>(drawQueue.shaderConstantRanges.size());
 
-            executeQueue.push(func);
+            for (uint32_t i = 0; i < drawCommand.vertexShaderConstantCount; ++i)
+            {
+                const ShaderConstantRange& sourceRange = shaderConstantRanges[drawCommand.vertexShaderConstantStart + i];
+                ShaderConstantRange range = {static_cast<uint32_t>(drawQueue.shaderConstantData.size()), sourceRange.size};
+                drawQueue.shaderConstantRanges.push_back(range);
+                drawQueue.shaderConstantData.insert(drawQueue.shaderConstantData.end(), shaderConstantData + sourceRange.offset, shaderConstantData + sourceRange.offset + sourceRange.size);
+            }
+
+            return true;
         }
 
-        void RenderDevice::executeAll()
+        uint8_t* RenderDevice::reserveStreamData(BufferResource* buffer, uint32_t size)
         {
-            std::function<void(void)> func;
+            // the queue that is being filled is never drawn, so its streaming memory can be written without locking
+            DrawQueue& drawQueue = drawQueues[fillQueueIndex];
+
+            // aligned, so that the reserved memory can be filled with vertices directly
+            uint32_t offset = (drawQueue.streamChunkSize + 15) & ~15U;
 
-            for (;;)
+            if (drawQueue.streamChunkIndex >= drawQueue.streamChunks.size() ||
+                offset + size > drawQueue.streamChunks[drawQueue.streamChunkIndex].size())
             {
+                // continue in the next chunk, the chunks that already have reservations are never resized
+                if (drawQueue.streamChunkIndex < drawQueue.streamChunks.size() && drawQueue.streamChunkSize > 0)
                 {
-                    std::lock_guard<std::mutex> lock(executeMutex);
-                    if (executeQueue.empty()) break;
+                    ++drawQueue.streamChunkIndex;
+                }
+
+                offset = 0;
+
+                if (drawQueue.streamChunkIndex >= drawQueue.streamChunks.size())
+                {
+                    // grow geometrically, the chunks are reused by the following frames in this slot
+                    size_t chunkSize = drawQueue.streamChunks.empty() ? STREAM_CHUNK_SIZE : drawQueue.streamChunks.back().size() * 2;
+                    drawQueue.streamChunks.push_back(std::vector<uint8_t>(std::max(static_cast<size_t>(size), chunkSize)));
+                }
+                else if (size > drawQueue.streamChunks[drawQueue.streamChunkIndex].size())
+                {
+                    // nothing was reserved in this chunk in the current frame, so it can be reallocated
+                    drawQueue.streamChunks[drawQueue.streamChunkIndex].resize(size);
+                }
+            }
+
+            drawQueue.streamChunkSize = offset + size;
+
+            uint8_t* data = drawQueue.streamChunks[drawQueue.streamChunkIndex].data() + offset;
+
+            StreamUpload streamUpload = {buffer, data, size};
+            drawQueue.streamUploads.push_back(streamUpload);
+
+            return data;
+        }
 
-                    func = std::move(executeQueue.front());
-                    executeQueue.pop();
+        void RenderDevice::flushCommands()
+        {
+            std::lock_guard<std::mutex> lock(drawQueueMutex);
+
+            if (pendingFrameCount < pipeliningDepth)
+            {
+                DrawQueue& drawQueue = drawQueues[fillQueueIndex];
+                drawCallCount = static_cast<uint32_t>(drawQueue.drawCommands.size());
+
+                // the functions pushed by this thread before the marker are executed before the frame is drawn
+                executeQueue.pushMarker();
+
+                {
+                    // the deletes are batched per frame, the vector of the frame was emptied when it was drawn
+                    std::lock_guard<std::mutex> resourceLock(resourceMutex);
+                    drawQueue.deleteResources.swap(resourceDeleteSet);
                 }
 
-                if (func)
+                fillQueueIndex = (fillQueueIndex + 1) % DRAW_QUEUE_COUNT;
+                ++fillFrame;
+                ++pendingFrameCount;
+
+                if (pendingFrameCount >= pipeliningDepth)
                 {
-                    func();
+                    queueFull = true;
+                    queueFullTime = std::chrono::steady_clock::now();
                 }
             }
+
+            refillQueue = pendingFrameCount < pipeliningDepth;
+
+#if OUZEL_MULTITHREADED
+            queueCondition.notify_one();
+#endif
+        }
+
+        bool RenderDevice::generateScreenshot(const std::string&)
+        {
+            return true;
+        }
+
+        void RenderDevice::executeOnRenderThread(Function&& func)
+        {
+            executeQueue.push(std::move(func));
+        }
+
+        void RenderDevice::executeAll()
+        {
+            executeQueue.executeToMarker();
         }
     } // namespace graphics
 } // namespace ouzel
@@ -3,8 +3,12 @@
 
 #pragma once
 
+#include <unordered_map>
+#include <utility>
 #include "utils/Noncopyable.hpp"
+#include "utils/ExecuteQueue.hpp"
 #include "graphics/Renderer.hpp"
+#include "graphics/RenderStatistics.hpp"
 #include "graphics/Vertex.hpp"
 #include "graphics/RenderResource.hpp"
 #include "graphics/BlendState.hpp"
@@ -21,6 +25,8 @@ namespace ouzel
         class MeshBufferResource;
         class ShaderResource;
         class TextureResource;
+        class RenderRecorder;
+        class RenderReplay;
 
         class RenderDevice: public Noncopyable
         {
@@ -30,6 +36,7 @@ namespace ouzel
             friend MeshBuffer;
             friend Shader;
             friend Texture;
+            friend RenderReplay;
         public:
             virtual ~RenderDevice();
 
@@ -57,15 +64,40 @@ namespace ouzel
             virtual std::vector<Size2> getSupportedResolutions() const;
 
             bool getRefillQueue() const { return refillQueue; }
+            // blocks the update thread until the render thread has a free frame or the timeout expires
+            void waitForRefillQueue(const std::chrono::steady_clock::duration& timeout);
 
+            static const uint32_t MAX_PIPELINING_DEPTH = 3;
+
+            // number of frames that can be queued before the update thread has to wait for the render thread
+            void setPipeliningDepth(uint32_t newPipeliningDepth);
+            uint32_t getPipeliningDepth() const { return pipeliningDepth; }
+
+            // total time in seconds the update thread had no free frame to fill
+            float getUpdateStallTime() const { return updateStallTime / 1000000000.0f; }
+            // total time in seconds the render thread waited for a finished frame
+            float getRenderStallTime() const { return renderStallTime / 1000000000.0f; }
+
+            // range of floats in the per-frame shader constant arena
+            struct ShaderConstantRange
+            {
+                uint32_t offset;
+                uint32_t size;
+            };
+
+            // plain data, shader constants are stored in the per-frame arena
             struct DrawCommand
             {
-                std::vector<TextureResource*> textures;
+                TextureResource* textures[Texture::LAYERS];
                 ShaderResource* shader;
-                std::vector<std::vector<float>> pixelShaderConstants;
-                std::vector<std::vector<float>> vertexShaderConstants;
+                uint32_t pixelShaderConstantStart;
+                uint32_t pixelShaderConstantCount;
+                uint32_t vertexShaderConstantStart;
+                uint32_t vertexShaderConstantCount;
                 BlendStateResource* blendState;
                 MeshBufferResource* meshBuffer;
+                BufferResource* instanceBuffer; // per-instance attributes, null if the draw is not instanced
+                uint32_t instanceCount;
                 uint32_t indexCount;
                 Renderer::DrawMode drawMode;
                 uint32_t startIndex;
@@ -77,11 +109,25 @@ namespace ouzel
                 bool scissorTest;
                 Rectangle scissorRectangle;
                 Renderer::CullMode cullMode;
+                uint32_t orderGroup;
             };
 
-            bool addDrawCommand(const DrawCommand& drawCommand);
+            bool addDrawCommand(const DrawCommand& drawCommand,
+                                std::initializer_list<Renderer::ShaderConstant> pixelShaderConstants,
+                                std::initializer_list<Renderer::ShaderConstant> vertexShaderConstants);
+            // adds a draw command with the shader constants from a ranges array (used by the replay),
+            // the constant starts of the command are indices into the ranges
+            bool addDrawCommand(const DrawCommand& drawCommand,
+                                const ShaderConstantRange* shaderConstantRanges,
+                                const float* shaderConstantData);
             void flushCommands();
 
+            // reserves size bytes in the streaming memory of the frame that is being filled, must be called on the update thread,
+            // the data is uploaded to the buffer before the frame is drawn and the memory is reused
+            // only after the render thread has finished the frame,
+            // the memory never moves, so the pointer stays valid (and can be filled on any thread) until flushCommands
+            uint8_t* reserveStreamData(BufferResource* buffer, uint32_t size);
+
             Vector2 convertScreenToNormalizedLocation(const Vector2& position)
             {
                 return Vector2(position.x / size.width,
@@ -96,6 +142,26 @@ namespace ouzel
 
             uint32_t getDrawCallCount() const { return drawCallCount; }
 
+            // statistics of the last drawn frame, can be called from any thread
+            RenderStatistics getStatistics() const;
+
+            // captures the next frameCount frames to a file, must be called on the render thread
+            void startRecording(const std::string& filename, uint32_t frameCount);
+            void stopRecording();
+            RenderRecorder* getRecorder() const { return recorder.get(); }
+
+            // called by the resources on the render thread
+            void addBufferUpload(uint32_t bytes) { frameStatistics.bufferBytesUploaded += bytes; }
+            void addTextureUpload(uint32_t bytes) { frameStatistics.textureBytesUploaded += bytes; }
+
+            virtual void setDrawCommandSorting(bool newDrawCommandSorting);
+            bool isDrawCommandSortingEnabled() const { return drawCommandSorting; }
+            uint32_t getRemovedStateChangeCount() const { return removedStateChangeCount; }
+
+            uint32_t getCurrentFrame() const { return currentFrame; }
+            // number of the frame that the update thread is filling, the frames that are not flushed are merged into the next one
+            uint32_t getFillFrame() const { return fillFrame; }
+
             uint16_t getAPIMajorVersion() const { return apiMajorVersion; }
             uint16_t getAPIMinorVersion() const { return apiMinorVersion; }
 
@@ -103,6 +169,7 @@ namespace ouzel
             bool isMultisamplingSupported() const { return multisamplingSupported; }
             bool isAnisotropicFilteringSupported() const { return anisotropicFilteringSupported; }
             bool isRenderTargetsSupported() const { return renderTargetsSupported; }
+            bool isInstancingSupported() const { return instancingSupported; }
 
             const Matrix4& getProjectionTransform(bool renderTarget) const
             {
@@ -112,7 +179,7 @@ namespace ouzel
             float getFPS() const { return currentFPS; }
             float getAccumulatedFPS() const { return accumulatedFPS; }
 
-            void executeOnRenderThread(const std::function<void(void)>& func);
+            void executeOnRenderThread(Function&& func);
 
         protected:
             RenderDevice(Renderer::Driver aDriver);
@@ -134,7 +201,30 @@ namespace ouzel
             virtual ShaderResource* createShader() = 0;
             virtual MeshBufferResource* createMeshBuffer() = 0;
             virtual BufferResource* createBuffer() = 0;
+
+            // takes the ownership of the resource, constant time (reuses a free slot of the resource table)
+            void addResource(RenderResource* resource);
+            // constant time, the resource is destroyed on the render thread after the frame that is being filled is drawn
             virtual void deleteResource(RenderResource* resource);
+            // destroys all resources, called by the destructors of the devices while the graphics context is still alive
+            void releaseResources();
+
+            void sortDrawCommands(std::vector<DrawCommand>& drawCommands);
+            static uint32_t countStateChanges(const std::vector<DrawCommand>& drawCommands);
+            static void countStateChanges(const std::vector<DrawCommand>& drawCommands, RenderStatistics& result);
+            void publishStatistics();
+
+            const float* getShaderConstant(uint32_t index, uint32_t& size) const
+            {
+                const ShaderConstantRange& range = currentDrawQueue->shaderConstantRanges[index];
+                size = range.size;
+                return currentDrawQueue->shaderConstantData.data() + range.offset;
+            }
+
+            const float* getShaderConstant(uint32_t index) const
+            {
+                return currentDrawQueue->shaderConstantData.data() + currentDrawQueue->shaderConstantRanges[index].offset;
+            }
 
             virtual bool draw(const std::vector<DrawCommand>& drawCommands) = 0;
             virtual bool generateScreenshot(const std::string& filename);
@@ -160,6 +250,7 @@ namespace ouzel
             bool multisamplingSupported = true;
             bool anisotropicFilteringSupported = true;
             bool renderTargetsSupported = true;
+            bool instancingSupported = true;
 
             Matrix4 projectionTransform;
             Matrix4 renderTargetProjectionTransform;
@@ -170,18 +261,79 @@ namespace ouzel
             bool clearColorBuffer = true;
             bool clearDepthBuffer = false;
 
+            struct ResourceSlot
+            {
+                std::unique_ptr<RenderResource> resource;
+                uint32_t generation = 0;
+            };
+
             std::mutex resourceMutex;
-            std::vector<std::unique_ptr<RenderResource>> resources;
-            std::vector<std::unique_ptr<RenderResource>> resourceDeleteSet;
+            std::vector<ResourceSlot> resourceSlots;
+            std::vector<uint32_t> freeResourceSlots;
+            std::vector<std::unique_ptr<RenderResource>> resourceDeleteSet; // deleted since the last flush
+            uint32_t createdResourceCount = 0; // created since the last frame was drawn
 
             uint32_t drawCallCount = 0;
 
-            std::vector<DrawCommand> drawQueue;
+            RenderStatistics frameStatistics; // filled by the render thread
+            mutable std::mutex statisticsMutex;
+            RenderStatistics statistics; // last published frame
+
+            std::unique_ptr<RenderRecorder> recorder;
+
+            bool drawCommandSorting = false;
+            std::atomic<uint32_t> removedStateChangeCount;
+            std::vector<std::pair<uint64_t, uint32_t>> sortKeys;
+            std::vector<std::pair<uint64_t, uint32_t>> sortKeysTemp;
+            std::vector<DrawCommand> sortedDrawCommands;
+            std::unordered_map<const void*, uint32_t> sortResourceIds[5];
+
+            struct StreamUpload
+            {
+                BufferResource* buffer;
+                const uint8_t* data;
+                uint32_t size;
+            };
+
+            static const uint32_t STREAM_CHUNK_SIZE = 64 * 1024;
+
+            struct DrawQueue
+            {
+                std::vector<DrawCommand> drawCommands;
+                std::vector<ShaderConstantRange> shaderConstantRanges;
+                std::vector<float> shaderConstantData;
+                // buffer data that is uploaded before the frame is drawn, the chunks are chained instead of reallocated,
+                // so that the memory that was already reserved does not move
+                std::vector<std::vector<uint8_t>> streamChunks;
+                uint32_t streamChunkIndex = 0; // chunk that is being filled
+                uint32_t streamChunkSize = 0; // bytes used in the chunk that is being filled
+                std::vector<StreamUpload> streamUploads;
+                std::vector<std::unique_ptr<RenderResource>> deleteResources; // resources deleted while the frame was filled
+            };
+
+            // ring of frames, the update thread fills one while the render thread draws another,
+            // the extra queue makes sure that the queue being filled is never the one being drawn
+            static const uint32_t DRAW_QUEUE_COUNT = MAX_PIPELINING_DEPTH + 1;
+            DrawQueue drawQueues[DRAW_QUEUE_COUNT];
+            uint32_t fillQueueIndex = 0; // owned by the update thread
+            uint32_t fillFrame = 0; // owned by the update thread
+            uint32_t drawQueueIndex = 0;
+            uint32_t pendingFrameCount = 0; // finished frames that are not drawn yet
+            // resources of the last drawn frames, released only after the frames that the device may still be executing retire
+            std::vector<std::unique_ptr<RenderResource>> retiringResources[MAX_PIPELINING_DEPTH];
+            std::atomic<uint32_t> pipeliningDepth;
+            const DrawQueue* currentDrawQueue = nullptr;
+
             std::mutex drawQueueMutex;
             std::condition_variable queueCondition;
-            bool queueFinished = false;
+            std::condition_variable refillCondition;
             std::atomic<bool> refillQueue;
 
+            bool queueFull = false;
+            std::chrono::steady_clock::time_point queueFullTime;
+            std::atomic<uint64_t> updateStallTime; // in nanoseconds
+            std::atomic<uint64_t> renderStallTime; // in nanoseconds
+
             std::atomic<float> currentFPS;
             std::chrono::steady_clock::time_point previousFrameTime;
 
@@ -189,8 +341,7 @@ namespace ouzel
             float currentAccumulatedFPS = 0.0f;
             std::atomic<float> accumulatedFPS;
 
-            std::queue<std::function<void(void)>> executeQueue;
-            std::mutex executeMutex;
+            ExecuteQueue executeQueue; // the functions of every finished frame end with a marker
         };
     } // namespace graphics
 } // namespace ouzel
@@ -0,0 +1,351 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <cstring>
+#include "RenderRecorder.hpp"
+#include "BlendStateResource.hpp"
+#include "BufferResource.hpp"
+#include "MeshBufferResource.hpp"
+#include "ShaderResource.hpp"
+#include "TextureResource.hpp"
+#include "core/Engine.hpp"
+#include "utils/Log.hpp"
+#include "utils/Utils.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        RenderRecorder::RenderRecorder(const std::string& aFilename, uint32_t aFrameCount, Renderer::Driver driver):
+            filename(aFilename), frameCount(aFrameCount)
+        {
+            putBytes("ORCP", 4);
+            putUInt32(VERSION);
+            putUInt32(static_cast<uint32_t>(driver));
+            frameCountOffset = data.size();
+            putUInt32(0); // frame count is written when the capture is saved
+        }
+
+        void RenderRecorder::recordBufferData(BufferResource* buffer, const void* newData, uint32_t size)
+        {
+            uint32_t id = getId(buffer);
+            if (!id) return;
+
+            putUInt8(static_cast<uint8_t>(Record::BUFFER_DATA));
+            putUInt32(id);
+            putUInt32(size);
+            putBytes(newData, size);
+        }
+
+        void RenderRecorder::recordTextureData(TextureResource* texture, const std::vector<uint8_t>& newData, const Size2& size)
+        {
+            uint32_t id = getId(texture);
+            if (!id) return;
+
+            putUInt8(static_cast<uint8_t>(Record::TEXTURE_DATA));
+            putUInt32(id);
+            putFloat(size.width);
+            putFloat(size.height);
+            putUInt32(static_cast<uint32_t>(newData.size()));
+            putBytes(newData.data(), static_cast<uint32_t>(newData.size()));
+        }
+
+        void RenderRecorder::recordDeletes(const std::vector<std::unique_ptr<RenderResource>>& deletedResources)
+        {
+            for (const std::unique_ptr<RenderResource>& resource : deletedResources)
+            {
+                auto i = resourceIds.find(resource.get());
+
+                if (i != resourceIds.end())
+                {
+                    putUInt8(static_cast<uint8_t>(Record::DELETE_RESOURCE));
+                    putUInt32(i->second);
+
+                    // the address can be reused by a new resource
+                    resourceIds.erase(i);
+                }
+            }
+        }
+
+        void RenderRecorder::recordFrame(const std::vector<RenderDevice::DrawCommand>& drawCommands,
+                                         const std::vector<RenderDevice::ShaderConstantRange>& shaderConstantRanges,
+                                         const std::vector<float>& shaderConstantData)
+        {
+            if (isFinished()) return;
+
+            // resources are written before the frame that uses them
+            std::vector<uint32_t> ids;
+            ids.reserve(drawCommands.size() * (Texture::LAYERS + 5));
+
+            for (const RenderDevice::DrawCommand& drawCommand : drawCommands)
+            {
+                for (TextureResource* texture : drawCommand.textures)
+                {
+                    ids.push_back(addTexture(texture));
+                }
+
+                ids.push_back(addShader(drawCommand.shader));
+                ids.push_back(addBlendState(drawCommand.blendState));
+                ids.push_back(addMeshBuffer(drawCommand.meshBuffer));
+                ids.push_back(addBuffer(drawCommand.instanceBuffer));
+                ids.push_back(addTexture(drawCommand.renderTarget));
+            }
+
+            putUInt8(static_cast<uint8_t>(Record::FRAME));
+            putUInt32(static_cast<uint32_t>(drawCommands.size()));
+            putUInt32(static_cast<uint32_t>(shaderConstantRanges.size()));
+            putUInt32(static_cast<uint32_t>(shaderConstantData.size()));
+
+            for (const RenderDevice::ShaderConstantRange& range : shaderConstantRanges)
+            {
+                putUInt32(range.offset);
+                putUInt32(range.size);
+            }
+
+            for (float value : shaderConstantData)
+            {
+                putFloat(value);
+            }
+
+            const uint32_t* id = ids.data();
+
+            for (const RenderDevice::DrawCommand& drawCommand : drawCommands)
+            {
+                for (uint32_t i = 0; i < Texture::LAYERS + 5; ++i)
+                {
+                    putUInt32(*id++);
+                }
+
+                putUInt32(drawCommand.pixelShaderConstantStart);
+                putUInt32(drawCommand.pixelShaderConstantCount);
+                putUInt32(drawCommand.vertexShaderConstantStart);
+                putUInt32(drawCommand.vertexShaderConstantCount);
+                putUInt32(drawCommand.instanceCount);
+                putUInt32(drawCommand.indexCount);
+                putUInt8(static_cast<uint8_t>(drawCommand.drawMode));
+                putUInt32(drawCommand.startIndex);
+                putRectangle(drawCommand.viewport);
+                putUInt8((drawCommand.depthWrite ? 0x01 : 0) |
+                         (drawCommand.depthTest ? 0x02 : 0) |
+                         (drawCommand.wireframe ? 0x04 : 0) |
+                         (drawCommand.scissorTest ? 0x08 : 0));
+                putRectangle(drawCommand.scissorRectangle);
+                putUInt8(static_cast<uint8_t>(drawCommand.cullMode));
+                putUInt32(drawCommand.orderGroup);
+            }
+
+            ++recordedFrames;
+        }
+
+        bool RenderRecorder::save()
+        {
+            encodeUInt32Little(data.data() + frameCountOffset, recordedFrames);
+
+            if (!sharedEngine->getFileSystem()->writeFile(filename, data))
+            {
+                return false;
+            }
+
+            Log(Log::Level::INFO) << "Recorded " << recordedFrames << " frames to " << filename;
+
+            return true;
+        }
+
+        uint32_t RenderRecorder::getId(RenderResource* resource) const
+        {
+            auto i = resourceIds.find(resource);
+
+            return (i != resourceIds.end()) ? i->second : 0;
+        }
+
+        uint32_t RenderRecorder::addBlendState(BlendStateResource* blendState)
+        {
+            if (!blendState) return 0;
+            if (uint32_t id = getId(blendState)) return id;
+
+            uint32_t id = nextId++;
+            resourceIds[blendState] = id;
+
+            putUInt8(static_cast<uint8_t>(Record::BLEND_STATE));
+            putUInt32(id);
+            putUInt8(blendState->isBlendingEnabled() ? 1 : 0);
+            putUInt8(static_cast<uint8_t>(blendState->getColorBlendSource()));
+            putUInt8(static_cast<uint8_t>(blendState->getColorBlendDest()));
+            putUInt8(static_cast<uint8_t>(blendState->getColorOperation()));
+            putUInt8(static_cast<uint8_t>(blendState->getAlphaBlendSource()));
+            putUInt8(static_cast<uint8_t>(blendState->getAlphaBlendDest()));
+            putUInt8(static_cast<uint8_t>(blendState->getAlphaOperation()));
+            putUInt8(blendState->getColorMask());
+
+            return id;
+        }
+
+        uint32_t RenderRecorder::addTexture(TextureResource* texture)
+        {
+            if (!texture) return 0;
+            if (uint32_t id = getId(texture)) return id;
+
+            uint32_t id = nextId++;
+            resourceIds[texture] = id;
+
+            putUInt8(static_cast<uint8_t>(Record::TEXTURE));
+            putUInt32(id);
+            putFloat(texture->size.width);
+            putFloat(texture->size.height);
+            putUInt32(texture->flags);
+            putUInt32(texture->mipmaps);
+            putUInt32(texture->sampleCount);
+            putUInt32(static_cast<uint32_t>(texture->pixelFormat));
+            putUInt32(static_cast<uint32_t>(texture->filter));
+            putUInt32(static_cast<uint32_t>(texture->addressX));
+            putUInt32(static_cast<uint32_t>(texture->addressY));
+            putUInt32(texture->maxAnisotropy);
+            putUInt8(texture->clearColorBuffer ? 1 : 0);
+            putUInt8(texture->clearDepthBuffer ? 1 : 0);
+            putUInt32(texture->clearColor.getIntValue());
+            putFloat(texture->clearDepth);
+
+            // render targets don't have any data
+            if (texture->flags & Texture::RENDER_TARGET)
+            {
+                putUInt32(0);
+            }
+            else
+            {
+                putUInt32(static_cast<uint32_t>(texture->levels.size()));
+
+                for (const Texture::Level& level : texture->levels)
+                {
+                    putFloat(level.size.width);
+                    putFloat(level.size.height);
+                    putUInt32(level.pitch);
+                    putUInt32(static_cast<uint32_t>(level.data.size()));
+                    putBytes(level.data.data(), static_cast<uint32_t>(level.data.size()));
+                }
+            }
+
+            return id;
+        }
+
+        uint32_t RenderRecorder::addShader(ShaderResource* shader)
+        {
+            if (!shader) return 0;
+            if (uint32_t id = getId(shader)) return id;
+
+            uint32_t id = nextId++;
+            resourceIds[shader] = id;
+
+            putUInt8(static_cast<uint8_t>(Record::SHADER));
+            putUInt32(id);
+            putUInt32(static_cast<uint32_t>(shader->pixelShaderData.size()));
+            putBytes(shader->pixelShaderData.data(), static_cast<uint32_t>(shader->pixelShaderData.size()));
+            putUInt32(static_cast<uint32_t>(shader->vertexShaderData.size()));
+            putBytes(shader->vertexShaderData.data(), static_cast<uint32_t>(shader->vertexShaderData.size()));
+            putVertexAttributes(shader->vertexAttributes);
+            putConstantInfo(shader->pixelShaderConstantInfo);
+            putConstantInfo(shader->vertexShaderConstantInfo);
+            putUInt32(shader->pixelShaderAlignment);
+            putUInt32(shader->vertexShaderAlignment);
+            putString(shader->pixelShaderFunction);
+            putString(shader->vertexShaderFunction);
+
+            return id;
+        }
+
+        uint32_t RenderRecorder::addBuffer(BufferResource* buffer)
+        {
+            if (!buffer) return 0;
+            if (uint32_t id = getId(buffer)) return id;
+
+            uint32_t id = nextId++;
+            resourceIds[buffer] = id;
+
+            putUInt8(static_cast<uint8_t>(Record::BUFFER));
+            putUInt32(id);
+            putUInt32(static_cast<uint32_t>(buffer->usage));
+            putUInt32(buffer->flags);
+            putUInt32(static_cast<uint32_t>(buffer->data.size()));
+            putBytes(buffer->data.data(), static_cast<uint32_t>(buffer->data.size()));
+
+            return id;
+        }
+
+        uint32_t RenderRecorder::addMeshBuffer(MeshBufferResource* meshBuffer)
+        {
+            if (!meshBuffer) return 0;
+            if (uint32_t id = getId(meshBuffer)) return id;
+
+            uint32_t indexBufferId = addBuffer(meshBuffer->getIndexBuffer());
+            uint32_t vertexBufferId = addBuffer(meshBuffer->getVertexBuffer());
+
+            uint32_t id = nextId++;
+            resourceIds[meshBuffer] = id;
+
+            putUInt8(static_cast<uint8_t>(Record::MESH_BUFFER));
+            putUInt32(id);
+            putUInt32(meshBuffer->getIndexSize());
+            putUInt32(indexBufferId);
+            putVertexAttributes(meshBuffer->getVertexAttributes());
+            putUInt32(vertexBufferId);
+
+            return id;
+        }
+
+        void RenderRecorder::putUInt32(uint32_t value)
+        {
+            size_t offset = data.size();
+            data.resize(offset + sizeof(value));
+            encodeUInt32Little(data.data() + offset, value);
+        }
+
+        void RenderRecorder::putFloat(float value)
+        {
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            putUInt32(bits);
+        }
+
+        void RenderRecorder::putBytes(const void* bytes, uint32_t size)
+        {
+            data.insert(data.end(), static_cast<const uint8_t*>(bytes), static_cast<const uint8_t*>(bytes) + size);
+        }
+
+        void RenderRecorder::putString(const std::string& value)
+        {
+            putUInt32(static_cast<uint32_t>(value.length()));
+            putBytes(value.data(), static_cast<uint32_t>(value.length()));
+        }
+
+        void RenderRecorder::putVertexAttributes(const std::vector<VertexAttribute>& vertexAttributes)
+        {
+            putUInt32(static_cast<uint32_t>(vertexAttributes.size()));
+
+            for (const VertexAttribute& vertexAttribute : vertexAttributes)
+            {
+                putUInt8(static_cast<uint8_t>(vertexAttribute.usage));
+                putUInt32(vertexAttribute.index);
+                putUInt8(static_cast<uint8_t>(vertexAttribute.dataType));
+                putUInt8(vertexAttribute.normalized ? 1 : 0);
+            }
+        }
+
+        void RenderRecorder::putConstantInfo(const std::vector<Shader::ConstantInfo>& constantInfo)
+        {
+            putUInt32(static_cast<uint32_t>(constantInfo.size()));
+
+            for (const Shader::ConstantInfo& info : constantInfo)
+            {
+                putString(info.name);
+                putUInt8(static_cast<uint8_t>(info.dataType));
+            }
+        }
+
+        void RenderRecorder::putRectangle(const Rectangle& rectangle)
+        {
+            putFloat(rectangle.position.x);
+            putFloat(rectangle.position.y);
+            putFloat(rectangle.size.width);
+            putFloat(rectangle.size.height);
+        }
+    } // namespace graphics
+} // namespace ouzel
@@ -0,0 +1,80 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "utils/Noncopyable.hpp"
+#include "graphics/RenderDevice.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        // serializes the draw command stream and the resources it uses to a binary capture that can be replayed by RenderReplay,
+        // all methods are called on the render thread
+        class RenderRecorder: public Noncopyable
+        {
+        public:
+            static const uint32_t VERSION = 1;
+
+            enum class Record: uint8_t
+            {
+                BLEND_STATE,
+                TEXTURE,
+                SHADER,
+                BUFFER,
+                MESH_BUFFER,
+                BUFFER_DATA,
+                TEXTURE_DATA,
+                DELETE_RESOURCE,
+                FRAME
+            };
+
+            RenderRecorder(const std::string& aFilename, uint32_t aFrameCount, Renderer::Driver driver);
+
+            // resources are captured when a draw command uses them for the first time,
+            // updates are captured only for the resources that are already in the capture
+            void recordBufferData(BufferResource* buffer, const void* data, uint32_t size);
+            void recordTextureData(TextureResource* texture, const std::vector<uint8_t>& data, const Size2& size);
+            void recordDeletes(const std::vector<std::unique_ptr<RenderResource>>& deletedResources);
+            void recordFrame(const std::vector<RenderDevice::DrawCommand>& drawCommands,
+                             const std::vector<RenderDevice::ShaderConstantRange>& shaderConstantRanges,
+                             const std::vector<float>& shaderConstantData);
+
+            bool isFinished() const { return recordedFrames >= frameCount; }
+            bool save();
+
+        protected:
+            uint32_t getId(RenderResource* resource) const;
+
+            uint32_t addBlendState(BlendStateResource* blendState);
+            uint32_t addTexture(TextureResource* texture);
+            uint32_t addShader(ShaderResource* shader);
+            uint32_t addBuffer(BufferResource* buffer);
+            uint32_t addMeshBuffer(MeshBufferResource* meshBuffer);
+
+            void putUInt8(uint8_t value) { data.push_back(value); }
+            void putUInt32(uint32_t value);
+            void putFloat(float value);
+            void putBytes(const void* bytes, uint32_t size);
+            void putString(const std::string& value);
+            void putVertexAttributes(const std::vector<VertexAttribute>& vertexAttributes);
+            void putConstantInfo(const std::vector<Shader::ConstantInfo>& constantInfo);
+            void putRectangle(const Rectangle& rectangle);
+
+            std::string filename;
+            uint32_t frameCount;
+            uint32_t recordedFrames = 0;
+            std::vector<uint8_t> data;
+            size_t frameCountOffset = 0;
+
+            // 0 is the id of the null resource
+            std::unordered_map<RenderResource*, uint32_t> resourceIds;
+            uint32_t nextId = 1;
+        };
+    } // namespace graphics
+} // namespace ouzel
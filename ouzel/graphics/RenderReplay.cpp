@@ -0,0 +1,898 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include "RenderReplay.hpp"
+#include "RenderRecorder.hpp"
+#include "BlendStateResource.hpp"
+#include "BufferResource.hpp"
+#include "MeshBufferResource.hpp"
+#include "ShaderResource.hpp"
+#include "TextureResource.hpp"
+#include "core/Engine.hpp"
+#include "utils/Log.hpp"
+#include "utils/Utils.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        RenderReplay::RenderReplay()
+        {
+            updateCallback.callback = std::bind(&RenderReplay::update, this, std::placeholders::_1);
+        }
+
+        RenderReplay::~RenderReplay()
+        {
+            if (sharedEngine) deleteResources();
+        }
+
+        bool RenderReplay::init(const std::string& filename)
+        {
+            frames.clear();
+            offset = 0;
+            resourceRecordCount = 0;
+
+            if (!sharedEngine->getFileSystem()->readFile(filename, data))
+            {
+                return false;
+            }
+
+            uint32_t version;
+            uint32_t driver;
+            uint32_t frameCount;
+
+            if (data.size() < 4 || memcmp(data.data(), "ORCP", 4) != 0)
+            {
+                Log(Log::Level::ERR) << "Invalid capture " << filename;
+                return false;
+            }
+
+            offset = 4;
+
+            if (!getUInt32(version) || !getUInt32(driver) || !getUInt32(frameCount))
+            {
+                Log(Log::Level::ERR) << "Invalid capture " << filename;
+                return false;
+            }
+
+            if (version != RenderRecorder::VERSION)
+            {
+                Log(Log::Level::ERR) << "Unsupported capture version " << version;
+                return false;
+            }
+
+            Renderer::Driver currentDriver = sharedEngine->getRenderer()->getDevice()->getDriver();
+
+            if (currentDriver != Renderer::Driver::EMPTY && currentDriver != static_cast<Renderer::Driver>(driver))
+            {
+                Log(Log::Level::WARN) << "Capture was recorded with a different graphics driver, shaders will fail to compile";
+            }
+
+            // the count is not trusted, every frame record takes at least its type and three counts
+            frames.reserve(std::min(static_cast<size_t>(frameCount), (data.size() - offset) / (1 + 3 * sizeof(uint32_t))));
+            frames.push_back(Frame());
+
+            while (offset < data.size())
+            {
+                uint8_t record;
+
+                if (!getUInt8(record))
+                {
+                    Log(Log::Level::ERR) << "Truncated capture " << filename;
+                    frames.clear();
+                    data.clear();
+                    return false;
+                }
+
+                bool result = false;
+
+                switch (static_cast<RenderRecorder::Record>(record))
+                {
+                    case RenderRecorder::Record::BLEND_STATE: result = parseBlendState(frames.back()); break;
+                    case RenderRecorder::Record::TEXTURE: result = parseTexture(frames.back()); break;
+                    case RenderRecorder::Record::SHADER: result = parseShader(frames.back()); break;
+                    case RenderRecorder::Record::BUFFER: result = parseBuffer(frames.back()); break;
+                    case RenderRecorder::Record::MESH_BUFFER: result = parseMeshBuffer(frames.back()); break;
+                    case RenderRecorder::Record::BUFFER_DATA: result = parseBufferData(frames.back()); break;
+                    case RenderRecorder::Record::TEXTURE_DATA: result = parseTextureData(frames.back()); break;
+                    case RenderRecorder::Record::DELETE_RESOURCE: result = parseDeleteResource(frames.back()); break;
+                    case RenderRecorder::Record::FRAME:
+                        result = parseFrame(frames.back());
+                        frames.push_back(Frame());
+                        break;
+                }
+
+                if (!result)
+                {
+                    Log(Log::Level::ERR) << "Invalid record " << static_cast<uint32_t>(record) << " in capture " << filename;
+                    frames.clear();
+                    data.clear();
+                    return false;
+                }
+            }
+
+            // resource records after the last frame are not needed
+            frames.pop_back();
+
+            data.clear();
+            data.shrink_to_fit();
+
+            return true;
+        }
+
+        void RenderReplay::start(uint32_t newLoopCount, bool newExitWhenFinished)
+        {
+            loopCount = newLoopCount;
+            exitWhenFinished = newExitWhenFinished;
+            currentFrame = 0;
+            currentLoop = 0;
+            finished = frames.empty();
+            results.clear();
+            results.reserve(frames.size() * loopCount);
+            renderResults.clear();
+            lastRenderFrame = sharedEngine->getRenderer()->getStatistics().frame;
+
+            if (!finished)
+            {
+                sharedEngine->scheduleUpdate(&updateCallback);
+            }
+        }
+
+        void RenderReplay::update(float)
+        {
+            if (finished) return;
+
+            RenderDevice* renderDevice = sharedEngine->getRenderer()->getDevice();
+
+#if OUZEL_MULTITHREADED
+            // the engine flushes the commands right after the update callbacks only if the device accepts a new frame
+            while (!renderDevice->getRefillQueue())
+            {
+                if (!sharedEngine->isActive()) return;
+                renderDevice->waitForRefillQueue(std::chrono::milliseconds(100));
+            }
+#else
+            if (!renderDevice->getRefillQueue()) return;
+#endif
+
+            submitFrame(frames[currentFrame]);
+
+            RenderStatistics statistics = renderDevice->getStatistics();
+
+            if (statistics.frame != lastRenderFrame)
+            {
+                lastRenderFrame = statistics.frame;
+                renderResults.push_back(statistics);
+            }
+
+            if (++currentFrame >= frames.size())
+            {
+                currentFrame = 0;
+                deleteResources();
+
+                if (++currentLoop >= loopCount)
+                {
+                    finished = true;
+                    updateCallback.remove();
+                    report();
+
+                    if (exitWhenFinished) sharedEngine->exit();
+                }
+            }
+        }
+
+        void RenderReplay::submitFrame(const Frame& frame)
+        {
+            RenderDevice* renderDevice = sharedEngine->getRenderer()->getDevice();
+            FrameResult result;
+
+            std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+            for (const std::function<void(void)>& resourceCommand : frame.resourceCommands)
+            {
+                resourceCommand();
+            }
+
+            std::chrono::steady_clock::time_point submitStartTime = std::chrono::steady_clock::now();
+
+            for (const Command& command : frame.commands)
+            {
+                RenderDevice::DrawCommand drawCommand = command.drawCommand;
+
+                for (uint32_t layer = 0; layer < Texture::LAYERS; ++layer)
+                {
+                    drawCommand.textures[layer] = getResource<TextureResource>(command.textures[layer]);
+                }
+
+                drawCommand.shader = getResource<ShaderResource>(command.shader);
+                drawCommand.blendState = getResource<BlendStateResource>(command.blendState);
+                drawCommand.meshBuffer = getResource<MeshBufferResource>(command.meshBuffer);
+                drawCommand.instanceBuffer = getResource<BufferResource>(command.instanceBuffer);
+                drawCommand.renderTarget = getResource<TextureResource>(command.renderTarget);
+
+                renderDevice->addDrawCommand(drawCommand, frame.shaderConstantRanges.data(), frame.shaderConstantData.data());
+            }
+
+            std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+
+            result.drawCalls = static_cast<uint32_t>(frame.commands.size());
+            result.resourceTime = std::chrono::duration_cast<std::chrono::nanoseconds>(submitStartTime - startTime).count() / 1000000000.0f;
+            result.submitTime = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - submitStartTime).count() / 1000000000.0f;
+
+            results.push_back(result);
+        }
+
+        void RenderReplay::report() const
+        {
+            if (results.empty()) return;
+
+            float totalSubmitTime = 0.0f;
+            float minSubmitTime = results.front().submitTime;
+            float maxSubmitTime = results.front().submitTime;
+
+            for (uint32_t i = 0; i < results.size(); ++i)
+            {
+                const FrameResult& result = results[i];
+
+                Log(Log::Level::INFO) << "Frame " << i << ": " << result.drawCalls << " draw calls, " <<
+                    "resources " << result.resourceTime * 1000.0f << " ms, " <<
+                    "submit " << result.submitTime * 1000.0f << " ms";
+
+                totalSubmitTime += result.submitTime;
+                minSubmitTime = std::min(minSubmitTime, result.submitTime);
+                maxSubmitTime = std::max(maxSubmitTime, result.submitTime);
+            }
+
+            Log(Log::Level::INFO) << "Submit time: average " << totalSubmitTime * 1000.0f / results.size() << " ms, " <<
+                "min " << minSubmitTime * 1000.0f << " ms, " <<
+                "max " << maxSubmitTime * 1000.0f << " ms";
+
+            if (!renderResults.empty())
+            {
+                float totalSortTime = 0.0f;
+                float totalDrawTime = 0.0f;
+
+                for (const RenderStatistics& statistics : renderResults)
+                {
+                    totalSortTime += statistics.sortTime;
+                    totalDrawTime += statistics.drawTime;
+                }
+
+                Log(Log::Level::INFO) << "Render thread (" << renderResults.size() << " sampled frames): " <<
+                    "sort average " << totalSortTime * 1000.0f / renderResults.size() << " ms, " <<
+                    "draw average " << totalDrawTime * 1000.0f / renderResults.size() << " ms";
+            }
+        }
+
+        void RenderReplay::deleteResources()
+        {
+            RenderDevice* renderDevice = sharedEngine->getRenderer()->getDevice();
+
+            for (RenderResource* resource : resources)
+            {
+                if (resource) renderDevice->deleteResource(resource);
+            }
+
+            resources.clear();
+        }
+
+        void RenderReplay::setResource(uint32_t id, RenderResource* resource)
+        {
+            // the ids were checked by addResourceId while parsing
+            if (id >= resources.size()) resources.resize(id + 1);
+
+            resources[id] = resource;
+        }
+
+        bool RenderReplay::addResourceId(uint32_t id)
+        {
+            // the recorder numbers the resources from 1 in the order they are created
+            ++resourceRecordCount;
+
+            return id != 0 && id <= resourceRecordCount;
+        }
+
+        // the values of the capture are checked before they are cast to the enums
+        template<class T>
+        static bool isValid(uint32_t value, T last)
+        {
+            return value <= static_cast<uint32_t>(last);
+        }
+
+        bool RenderReplay::parseBlendState(Frame& frame)
+        {
+            uint32_t id;
+            uint8_t enableBlending;
+            uint8_t colorBlendSource;
+            uint8_t colorBlendDest;
+            uint8_t colorOperation;
+            uint8_t alphaBlendSource;
+            uint8_t alphaBlendDest;
+            uint8_t alphaOperation;
+            uint8_t colorMask;
+
+            if (!getUInt32(id) ||
+                !getUInt8(enableBlending) ||
+                !getUInt8(colorBlendSource) ||
+                !getUInt8(colorBlendDest) ||
+                !getUInt8(colorOperation) ||
+                !getUInt8(alphaBlendSource) ||
+                !getUInt8(alphaBlendDest) ||
+                !getUInt8(alphaOperation) ||
+                !getUInt8(colorMask))
+            {
+                return false;
+            }
+
+            if (!addResourceId(id) ||
+                !isValid(colorBlendSource, BlendState::BlendFactor::INV_BLEND_FACTOR) ||
+                !isValid(colorBlendDest, BlendState::BlendFactor::INV_BLEND_FACTOR) ||
+                !isValid(colorOperation, BlendState::BlendOperation::MAX) ||
+                !isValid(alphaBlendSource, BlendState::BlendFactor::INV_BLEND_FACTOR) ||
+                !isValid(alphaBlendDest, BlendState::BlendFactor::INV_BLEND_FACTOR) ||
+                !isValid(alphaOperation, BlendState::BlendOperation::MAX))
+            {
+                return false;
+            }
+
+            frame.resourceCommands.push_back([this, id, enableBlending,
+                                              colorBlendSource, colorBlendDest, colorOperation,
+                                              alphaBlendSource, alphaBlendDest, alphaOperation,
+                                              colorMask]() {
+                BlendStateResource* blendState = sharedEngine->getRenderer()->getDevice()->createBlendState();
+                setResource(id, blendState);
+
+                sharedEngine->getRenderer()->executeOnRenderThread(std::bind(&BlendStateResource::init,
+                                                                             blendState,
+                                                                             enableBlending != 0,
+                                                                             static_cast<BlendState::BlendFactor>(colorBlendSource),
+                                                                             static_cast<BlendState::BlendFactor>(colorBlendDest),
+                                                                             static_cast<BlendState::BlendOperation>(colorOperation),
+                                                                             static_cast<BlendState::BlendFactor>(alphaBlendSource),
+                                                                             static_cast<BlendState::BlendFactor>(alphaBlendDest),
+                                                                             static_cast<BlendState::BlendOperation>(alphaOperation),
+                                                                             colorMask));
+            });
+
+            return true;
+        }
+
+        bool RenderReplay::parseTexture(Frame& frame)
+        {
+            uint32_t id;
+            Size2 size;
+            uint32_t flags;
+            uint32_t mipmaps;
+            uint32_t sampleCount;
+            uint32_t pixelFormat;
+            uint32_t filter;
+            uint32_t addressX;
+            uint32_t addressY;
+            uint32_t maxAnisotropy;
+            uint8_t clearColorBuffer;
+            uint8_t clearDepthBuffer;
+            uint32_t clearColor;
+            float clearDepth;
+            uint32_t levelCount;
+
+            if (!getUInt32(id) ||
+                !getFloat(size.width) ||
+                !getFloat(size.height) ||
+                !getUInt32(flags) ||
+                !getUInt32(mipmaps) ||
+                !getUInt32(sampleCount) ||
+                !getUInt32(pixelFormat) ||
+                !getUInt32(filter) ||
+                !getUInt32(addressX) ||
+                !getUInt32(addressY) ||
+                !getUInt32(maxAnisotropy) ||
+                !getUInt8(clearColorBuffer) ||
+                !getUInt8(clearDepthBuffer) ||
+                !getUInt32(clearColor) ||
+                !getFloat(clearDepth) ||
+                !getUInt32(levelCount))
+            {
+                return false;
+            }
+
+            if (!addResourceId(id) ||
+                !isValid(pixelFormat, PixelFormat::RGBA32_FLOAT) ||
+                !isValid(filter, Texture::Filter::TRILINEAR) ||
+                !isValid(addressX, Texture::Address::MIRROR_REPEAT) ||
+                !isValid(addressY, Texture::Address::MIRROR_REPEAT))
+            {
+                return false;
+            }
+
+            // every level takes at least its size, pitch and data size
+            if (levelCount > (data.size() - offset) / (4 * sizeof(uint32_t)))
+            {
+                return false;
+            }
+
+            std::vector<Texture::Level> levels(levelCount);
+
+            for (Texture::Level& level : levels)
+            {
+                if (!getFloat(level.size.width) ||
+                    !getFloat(level.size.height) ||
+                    !getUInt32(level.pitch) ||
+                    !getBytes(level.data))
+                {
+                    return false;
+                }
+            }
+
+            frame.resourceCommands.push_back([this, id, size, flags, mipmaps, sampleCount, pixelFormat,
+                                              filter, addressX, addressY, maxAnisotropy,
+                                              clearColorBuffer, clearDepthBuffer, clearColor, clearDepth, levels]() {
+                TextureResource* texture = sharedEngine->getRenderer()->getDevice()->createTexture();
+                setResource(id, texture);
+
+                sharedEngine->getRenderer()->executeOnRenderThread([texture, size, flags, mipmaps, sampleCount, pixelFormat,
+                                                                    filter, addressX, addressY, maxAnisotropy,
+                                                                    clearColorBuffer, clearDepthBuffer, clearColor, clearDepth, levels]() {
+                    if (levels.empty())
+                    {
+                        texture->init(size, flags, mipmaps, sampleCount, static_cast<PixelFormat>(pixelFormat));
+                    }
+                    else
+                    {
+                        texture->init(levels, size, flags, static_cast<PixelFormat>(pixelFormat));
+                    }
+
+                    texture->setFilter(static_cast<Texture::Filter>(filter));
+                    texture->setAddressX(static_cast<Texture::Address>(addressX));
+                    texture->setAddressY(static_cast<Texture::Address>(addressY));
+                    texture->setMaxAnisotropy(maxAnisotropy);
+                    texture->setClearColorBuffer(clearColorBuffer != 0);
+                    texture->setClearDepthBuffer(clearDepthBuffer != 0);
+                    texture->setClearColor(Color(clearColor));
+                    texture->setClearDepth(clearDepth);
+                });
+            });
+
+            return true;
+        }
+
+        bool RenderReplay::parseShader(Frame& frame)
+        {
+            uint32_t id;
+            std::vector<uint8_t> pixelShaderData;
+            std::vector<uint8_t> vertexShaderData;
+            std::vector<VertexAttribute> vertexAttributes;
+            std::vector<Shader::ConstantInfo> pixelShaderConstantInfo;
+            std::vector<Shader::ConstantInfo> vertexShaderConstantInfo;
+            uint32_t pixelShaderAlignment;
+            uint32_t vertexShaderAlignment;
+            std::string pixelShaderFunction;
+            std::string vertexShaderFunction;
+
+            if (!getUInt32(id) ||
+                !getBytes(pixelShaderData) ||
+                !getBytes(vertexShaderData) ||
+                !getVertexAttributes(vertexAttributes) ||
+                !getConstantInfo(pixelShaderConstantInfo) ||
+                !getConstantInfo(vertexShaderConstantInfo) ||
+                !getUInt32(pixelShaderAlignment) ||
+                !getUInt32(vertexShaderAlignment) ||
+                !getString(pixelShaderFunction) ||
+                !getString(vertexShaderFunction))
+            {
+                return false;
+            }
+
+            if (!addResourceId(id))
+            {
+                return false;
+            }
+
+            frame.resourceCommands.push_back([this, id, pixelShaderData, vertexShaderData, vertexAttributes,
+                                              pixelShaderConstantInfo, vertexShaderConstantInfo,
+                                              pixelShaderAlignment, vertexShaderAlignment,
+                                              pixelShaderFunction, vertexShaderFunction]() {
+                ShaderResource* shader = sharedEngine->getRenderer()->getDevice()->createShader();
+                setResource(id, shader);
+
+                sharedEngine->getRenderer()->executeOnRenderThread(std::bind(&ShaderResource::init,
+                                                                             shader,
+                                                                             pixelShaderData,
+                                                                             vertexShaderData,
+                                                                             vertexAttributes,
+                                                                             pixelShaderConstantInfo,
+                                                                             vertexShaderConstantInfo,
+                                                                             pixelShaderAlignment,
+                                                                             vertexShaderAlignment,
+                                                                             pixelShaderFunction,
+                                                                             vertexShaderFunction));
+            });
+
+            return true;
+        }
+
+        bool RenderReplay::parseBuffer(Frame& frame)
+        {
+            uint32_t id;
+            uint32_t usage;
+            uint32_t flags;
+            std::vector<uint8_t> bufferData;
+
+            if (!getUInt32(id) ||
+                !getUInt32(usage) ||
+                !getUInt32(flags) ||
+                !getBytes(bufferData))
+            {
+                return false;
+            }
+
+            if (!addResourceId(id) ||
+                !isValid(usage, Buffer::Usage::VERTEX))
+            {
+                return false;
+            }
+
+            frame.resourceCommands.push_back([this, id, usage, flags, bufferData]() {
+                BufferResource* buffer = sharedEngine->getRenderer()->getDevice()->createBuffer();
+                setResource(id, buffer);
+
+                sharedEngine->getRenderer()->executeOnRenderThread(std::bind(static_cast<bool(BufferResource::*)(Buffer::Usage, const std::vector<uint8_t>&, uint32_t)>(&BufferResource::init),
+                                                                             buffer,
+                                                                             static_cast<Buffer::Usage>(usage),
+                                                                             bufferData,
+                                                                             flags));
+            });
+
+            return true;
+        }
+
+        bool RenderReplay::parseMeshBuffer(Frame& frame)
+        {
+            uint32_t id;
+            uint32_t indexSize;
+            uint32_t indexBufferId;
+            std::vector<VertexAttribute> vertexAttributes;
+            uint32_t vertexBufferId;
+
+            if (!getUInt32(id) ||
+                !getUInt32(indexSize) ||
+                !getUInt32(indexBufferId) ||
+                !getVertexAttributes(vertexAttributes) ||
+                !getUInt32(vertexBufferId))
+            {
+                return false;
+            }
+
+            if (!addResourceId(id))
+            {
+                return false;
+            }
+
+            frame.resourceCommands.push_back([this, id, indexSize, indexBufferId, vertexAttributes, vertexBufferId]() {
+                MeshBufferResource* meshBuffer = sharedEngine->getRenderer()->getDevice()->createMeshBuffer();
+                setResource(id, meshBuffer);
+
+                sharedEngine->getRenderer()->executeOnRenderThread(std::bind(&MeshBufferResource::init,
+                                                                             meshBuffer,
+                                                                             indexSize,
+                                                                             getResource<BufferResource>(indexBufferId),
+                                                                             vertexAttributes,
+                                                                             getResource<BufferResource>(vertexBufferId)));
+            });
+
+            return true;
+        }
+
+        bool RenderReplay::parseBufferData(Frame& frame)
+        {
+            uint32_t id;
+            std::vector<uint8_t> bufferData;
+
+            if (!getUInt32(id) ||
+                !getBytes(bufferData))
+            {
+                return false;
+            }
+
+            frame.resourceCommands.push_back([this, id, bufferData]() {
+                // same path as Buffer::setData
+                uint8_t* streamData = sharedEngine->getRenderer()->getDevice()->reserveStreamData(getResource<BufferResource>(id),
+                                                                                                  static_cast<uint32_t>(bufferData.size()));
+                std::copy(bufferData.begin(), bufferData.end(), streamData);
+            });
+
+            return true;
+        }
+
+        bool RenderReplay::parseTextureData(Frame& frame)
+        {
+            uint32_t id;
+            Size2 size;
+            std::vector<uint8_t> textureData;
+
+            if (!getUInt32(id) ||
+                !getFloat(size.width) ||
+                !getFloat(size.height) ||
+                !getBytes(textureData))
+            {
+                return false;
+            }
+
+            frame.resourceCommands.push_back([this, id, size, textureData]() {
+                sharedEngine->getRenderer()->executeOnRenderThread(std::bind(&TextureResource::setData,
+                                                                             getResource<TextureResource>(id),
+                                                                             textureData,
+                                                                             size));
+            });
+
+            return true;
+        }
+
+        bool RenderReplay::parseDeleteResource(Frame& frame)
+        {
+            uint32_t id;
+
+            if (!getUInt32(id))
+            {
+                return false;
+            }
+
+            frame.resourceCommands.push_back([this, id]() {
+                if (RenderResource* resource = getResource<RenderResource>(id))
+                {
+                    sharedEngine->getRenderer()->getDevice()->deleteResource(resource);
+                    resources[id] = nullptr;
+                }
+            });
+
+            return true;
+        }
+
+        bool RenderReplay::parseFrame(Frame& frame)
+        {
+            uint32_t commandCount;
+            uint32_t rangeCount;
+            uint32_t constantCount;
+
+            if (!getUInt32(commandCount) ||
+                !getUInt32(rangeCount) ||
+                !getUInt32(constantCount))
+            {
+                return false;
+            }
+
+            // the counts are checked against the remaining data before anything is allocated
+            if (rangeCount > (data.size() - offset) / (2 * sizeof(uint32_t)))
+            {
+                return false;
+            }
+
+            frame.shaderConstantRanges.resize(rangeCount);
+
+            for (RenderDevice::ShaderConstantRange& range : frame.shaderConstantRanges)
+            {
+                if (!getUInt32(range.offset) ||
+                    !getUInt32(range.size))
+                {
+                    return false;
+                }
+
+                // compared with a subtraction, so that the sum can't wrap around
+                if (range.offset > constantCount ||
+                    range.size > constantCount - range.offset)
+                {
+                    return false;
+                }
+            }
+
+            if (constantCount > (data.size() - offset) / sizeof(float))
+            {
+                return false;
+            }
+
+            frame.shaderConstantData.resize(constantCount);
+
+            for (float& value : frame.shaderConstantData)
+            {
+                if (!getFloat(value))
+                {
+                    return false;
+                }
+            }
+
+            if (commandCount > (data.size() - offset) / (Texture::LAYERS * sizeof(uint32_t)))
+            {
+                return false;
+            }
+
+            frame.commands.resize(commandCount);
+
+            for (Command& command : frame.commands)
+            {
+                RenderDevice::DrawCommand& drawCommand = command.drawCommand;
+                uint8_t drawMode;
+                uint8_t depthFlags;
+                uint8_t cullMode;
+
+                for (uint32_t& texture : command.textures)
+                {
+                    if (!getUInt32(texture))
+                    {
+                        return false;
+                    }
+                }
+
+                if (!getUInt32(command.shader) ||
+                    !getUInt32(command.blendState) ||
+                    !getUInt32(command.meshBuffer) ||
+                    !getUInt32(command.instanceBuffer) ||
+                    !getUInt32(command.renderTarget) ||
+                    !getUInt32(drawCommand.pixelShaderConstantStart) ||
+                    !getUInt32(drawCommand.pixelShaderConstantCount) ||
+                    !getUInt32(drawCommand.vertexShaderConstantStart) ||
+                    !getUInt32(drawCommand.vertexShaderConstantCount) ||
+                    !getUInt32(drawCommand.instanceCount) ||
+                    !getUInt32(drawCommand.indexCount) ||
+                    !getUInt8(drawMode) ||
+                    !getUInt32(drawCommand.startIndex) ||
+                    !getRectangle(drawCommand.viewport) ||
+                    !getUInt8(depthFlags) ||
+                    !getRectangle(drawCommand.scissorRectangle) ||
+                    !getUInt8(cullMode) ||
+                    !getUInt32(drawCommand.orderGroup))
+                {
+                    return false;
+                }
+
+                if (drawCommand.pixelShaderConstantStart > rangeCount ||
+                    drawCommand.pixelShaderConstantCount > rangeCount - drawCommand.pixelShaderConstantStart ||
+                    drawCommand.vertexShaderConstantStart > rangeCount ||
+                    drawCommand.vertexShaderConstantCount > rangeCount - drawCommand.vertexShaderConstantStart)
+                {
+                    return false;
+                }
+
+                if (!isValid(drawMode, Renderer::DrawMode::TRIANGLE_STRIP) ||
+                    !isValid(cullMode, Renderer::CullMode::BACK))
+                {
+                    return false;
+                }
+
+                drawCommand.drawMode = static_cast<Renderer::DrawMode>(drawMode);
+                drawCommand.depthWrite = (depthFlags & 0x01) != 0;
+                drawCommand.depthTest = (depthFlags & 0x02) != 0;
+                drawCommand.wireframe = (depthFlags & 0x04) != 0;
+                drawCommand.scissorTest = (depthFlags & 0x08) != 0;
+                drawCommand.cullMode = static_cast<Renderer::CullMode>(cullMode);
+            }
+
+            return true;
+        }
+
+        bool RenderReplay::getUInt8(uint8_t& value)
+        {
+            if (offset + sizeof(value) > data.size()) return false;
+
+            value = data[offset];
+            offset += sizeof(value);
+
+            return true;
+        }
+
+        bool RenderReplay::getUInt32(uint32_t& value)
+        {
+            if (offset + sizeof(value) > data.size()) return false;
+
+            value = decodeUInt32Little(data.data() + offset);
+            offset += sizeof(value);
+
+            return true;
+        }
+
+        bool RenderReplay::getFloat(float& value)
+        {
+            uint32_t bits;
+            if (!getUInt32(bits)) return false;
+
+            memcpy(&value, &bits, sizeof(value));
+
+            return true;
+        }
+
+        bool RenderReplay::getBytes(std::vector<uint8_t>& bytes)
+        {
+            uint32_t size;
+            if (!getUInt32(size)) return false;
+            if (offset + size > data.size()) return false;
+
+            bytes.assign(data.begin() + static_cast<std::ptrdiff_t>(offset), data.begin() + static_cast<std::ptrdiff_t>(offset + size));
+            offset += size;
+
+            return true;
+        }
+
+        bool RenderReplay::getString(std::string& value)
+        {
+            uint32_t length;
+            if (!getUInt32(length)) return false;
+            if (offset + length > data.size()) return false;
+
+            value.assign(reinterpret_cast<const char*>(data.data() + offset), length);
+            offset += length;
+
+            return true;
+        }
+
+        bool RenderReplay::getVertexAttributes(std::vector<VertexAttribute>& vertexAttributes)
+        {
+            uint32_t count;
+            if (!getUInt32(count)) return false;
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                uint8_t usage;
+                uint32_t index;
+                uint8_t dataType;
+                uint8_t normalized;
+
+                if (!getUInt8(usage) ||
+                    !getUInt32(index) ||
+                    !getUInt8(dataType) ||
+                    !getUInt8(normalized))
+                {
+                    return false;
+                }
+
+                if (!isValid(usage, VertexAttribute::Usage::INSTANCE_DATA) ||
+                    !isValid(dataType, DataType::FLOAT_MATRIX4))
+                {
+                    return false;
+                }
+
+                vertexAttributes.push_back(VertexAttribute(static_cast<VertexAttribute::Usage>(usage),
+                                                           index,
+                                                           static_cast<DataType>(dataType),
+                                                           normalized != 0));
+            }
+
+            return true;
+        }
+
+        bool RenderReplay::getConstantInfo(std::vector<Shader::ConstantInfo>& constantInfo)
+        {
+            uint32_t count;
+            if (!getUInt32(count)) return false;
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                std::string name;
+                uint8_t dataType;
+
+                if (!getString(name) ||
+                    !getUInt8(dataType))
+                {
+                    return false;
+                }
+
+                if (!isValid(dataType, DataType::FLOAT_MATRIX4))
+                {
+                    return false;
+                }
+
+                constantInfo.push_back(Shader::ConstantInfo(name, static_cast<DataType>(dataType)));
+            }
+
+            return true;
+        }
+
+        bool RenderReplay::getRectangle(Rectangle& rectangle)
+        {
+            return getFloat(rectangle.position.x) &&
+                getFloat(rectangle.position.y) &&
+                getFloat(rectangle.size.width) &&
+                getFloat(rectangle.size.height);
+        }
+    } // namespace graphics
+} // namespace ouzel
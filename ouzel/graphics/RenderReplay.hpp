@@ -0,0 +1,116 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "utils/Noncopyable.hpp"
+#include "core/UpdateCallback.hpp"
+#include "graphics/RenderDevice.hpp"
+#include "graphics/RenderStatistics.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        // feeds a capture written by RenderRecorder to the render device of the engine as fast as the device accepts frames,
+        // the capture should be replayed with the driver it was recorded with or with the empty driver
+        class RenderReplay: public Noncopyable
+        {
+        public:
+            struct FrameResult
+            {
+                uint32_t drawCalls = 0;
+                float resourceTime = 0.0f; // seconds spent creating and updating resources
+                float submitTime = 0.0f; // seconds spent adding the draw commands
+            };
+
+            RenderReplay();
+            ~RenderReplay();
+
+            bool init(const std::string& filename);
+
+            // replays the capture loopCount times from the update thread
+            void start(uint32_t newLoopCount = 1, bool newExitWhenFinished = false);
+            bool isFinished() const { return finished; }
+
+            uint32_t getFrameCount() const { return static_cast<uint32_t>(frames.size()); }
+            const std::vector<FrameResult>& getResults() const { return results; }
+            // statistics of the frames drawn by the render thread (sampled after each submitted frame)
+            const std::vector<RenderStatistics>& getRenderResults() const { return renderResults; }
+
+            void report() const;
+
+        protected:
+            struct Command
+            {
+                RenderDevice::DrawCommand drawCommand;
+                uint32_t textures[Texture::LAYERS];
+                uint32_t shader;
+                uint32_t blendState;
+                uint32_t meshBuffer;
+                uint32_t instanceBuffer;
+                uint32_t renderTarget;
+            };
+
+            struct Frame
+            {
+                std::vector<std::function<void(void)>> resourceCommands;
+                std::vector<Command> commands;
+                std::vector<RenderDevice::ShaderConstantRange> shaderConstantRanges;
+                std::vector<float> shaderConstantData;
+            };
+
+            void update(float delta);
+            void submitFrame(const Frame& frame);
+            void deleteResources();
+
+            template<class T> T* getResource(uint32_t id) const
+            {
+                return (id < resources.size()) ? static_cast<T*>(resources[id]) : nullptr;
+            }
+            void setResource(uint32_t id, RenderResource* resource);
+            bool addResourceId(uint32_t id);
+
+            bool parseBlendState(Frame& frame);
+            bool parseTexture(Frame& frame);
+            bool parseShader(Frame& frame);
+            bool parseBuffer(Frame& frame);
+            bool parseMeshBuffer(Frame& frame);
+            bool parseBufferData(Frame& frame);
+            bool parseTextureData(Frame& frame);
+            bool parseDeleteResource(Frame& frame);
+            bool parseFrame(Frame& frame);
+
+            bool getUInt8(uint8_t& value);
+            bool getUInt32(uint32_t& value);
+            bool getFloat(float& value);
+            bool getBytes(std::vector<uint8_t>& bytes);
+            bool getString(std::string& value);
+            bool getVertexAttributes(std::vector<VertexAttribute>& vertexAttributes);
+            bool getConstantInfo(std::vector<Shader::ConstantInfo>& constantInfo);
+            bool getRectangle(Rectangle& rectangle);
+
+            std::vector<uint8_t> data; // only used while parsing
+            size_t offset = 0;
+
+            std::vector<Frame> frames;
+            std::vector<RenderResource*> resources; // indexed by the id in the capture
+            uint32_t resourceRecordCount = 0; // resource records parsed so far, no id of the capture is greater
+
+            UpdateCallback updateCallback;
+            uint32_t currentFrame = 0;
+            uint32_t loopCount = 1;
+            uint32_t currentLoop = 0;
+            bool exitWhenFinished = false;
+            bool finished = false;
+            uint32_t lastRenderFrame = 0;
+
+            std::vector<FrameResult> results;
+            std::vector<RenderStatistics> renderResults;
+        };
+    } // namespace graphics
+} // namespace ouzel
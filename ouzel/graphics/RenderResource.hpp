@@ -3,19 +3,32 @@
 
 #pragma once
 
+#include <cstdint>
 #include "utils/Noncopyable.hpp"
 
 namespace ouzel
 {
     namespace graphics
     {
+        class RenderDevice;
+
         class RenderResource: public Noncopyable
         {
+            friend RenderDevice;
         public:
             RenderResource() {}
             virtual ~RenderResource() {}
 
             virtual bool reload() { return true; }
+
+            // slot of the resource in the resource table of the render device
+            uint32_t getSlot() const { return slot; }
+            // generation of the slot when the resource was added, slots are reused with a new generation
+            uint32_t getGeneration() const { return generation; }
+
+        private:
+            uint32_t slot = 0;
+            uint32_t generation = 0;
         };
     } // namespace graphics
 } // namespace ouzel
@@ -0,0 +1,36 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        // counters of the last frame that was drawn by the render thread
+        struct RenderStatistics
+        {
+            uint32_t frame = 0;
+            uint32_t drawCalls = 0;
+
+            // state changes between consecutive draw commands
+            uint32_t shaderChanges = 0;
+            uint32_t textureChanges = 0;
+            uint32_t blendStateChanges = 0;
+            uint32_t renderTargetChanges = 0;
+            uint32_t viewportChanges = 0;
+
+            uint64_t bufferBytesUploaded = 0;
+            uint64_t textureBytesUploaded = 0;
+
+            uint32_t resourcesCreated = 0;
+            uint32_t resourcesDeleted = 0;
+
+            float waitTime = 0.0f; // seconds the render thread waited for the frame
+            float sortTime = 0.0f; // seconds spent sorting the draw commands
+            float drawTime = 0.0f; // seconds spent in draw
+        };
+    } // namespace graphics
+} // namespace ouzel
@@ -10,10 +10,15 @@
 #include "BlendStateResource.hpp"
 #include "MeshBufferResource.hpp"
 #include "BufferResource.hpp"
+#include "Buffer.hpp"
+#include "MeshBuffer.hpp"
+#include "BlendState.hpp"
+#include "Shader.hpp"
 #include "events/EventHandler.hpp"
 #include "events/EventDispatcher.hpp"
 #include "core/Window.hpp"
 #include "utils/Log.hpp"
+#include "utils/Utils.hpp"
 
 #if OUZEL_PLATFORM_MACOS
 #include "graphics/metal/macos/RenderDeviceMetalMacOS.hpp"
@@ -217,12 +222,24 @@ namespace ouzel
             whitePixelTexture->init({255, 255, 255, 255}, Size2(1.0f, 1.0f), 0, 1);
             sharedEngine->getCache()->setTexture(TEXTURE_WHITE_PIXEL, whitePixelTexture);
 
+            for (uint32_t i = 0; i < 2; ++i)
+            {
+                batchIndexBuffers[i] = std::make_shared<Buffer>();
+                batchIndexBuffers[i]->init(Buffer::Usage::INDEX, Buffer::DYNAMIC);
+
+                batchVertexBuffers[i] = std::make_shared<Buffer>();
+                batchVertexBuffers[i]->init(Buffer::Usage::VERTEX, Buffer::DYNAMIC);
+
+                batchMeshBuffers[i] = std::make_shared<MeshBuffer>();
+                batchMeshBuffers[i]->init(sizeof(uint32_t), batchIndexBuffers[i], VertexPCT::ATTRIBUTES, batchVertexBuffers[i]);
+            }
+
             return true;
         }
 
-        void Renderer::executeOnRenderThread(const std::function<void(void)>& func)
+        void Renderer::executeOnRenderThread(Function&& func)
         {
-            device->executeOnRenderThread(func);
+            device->executeOnRenderThread(std::move(func));
         }
 
         void Renderer::setClearColorBuffer(bool clear)
@@ -267,10 +284,52 @@ namespace ouzel
             return true;
         }
 
-        bool Renderer::addDrawCommand(const std::vector<std::shared_ptr<Texture>>& textures,
+        void Renderer::setDrawCommandSorting(bool newDrawCommandSorting)
+        {
+            drawCommandSorting = newDrawCommandSorting;
+
+            executeOnRenderThread(std::bind(&RenderDevice::setDrawCommandSorting, device.get(), newDrawCommandSorting));
+        }
+
+        void Renderer::setPipeliningDepth(uint32_t newPipeliningDepth)
+        {
+            device->setPipeliningDepth(newPipeliningDepth);
+        }
+
+        uint32_t Renderer::getPipeliningDepth() const
+        {
+            return device->getPipeliningDepth();
+        }
+
+        RenderStatistics Renderer::getStatistics() const
+        {
+            return device->getStatistics();
+        }
+
+        void Renderer::startRecording(const std::string& filename, uint32_t frameCount)
+        {
+            executeOnRenderThread(std::bind(&RenderDevice::startRecording, device.get(), filename, frameCount));
+        }
+
+        void Renderer::stopRecording()
+        {
+            executeOnRenderThread(std::bind(&RenderDevice::stopRecording, device.get()));
+        }
+
+        float Renderer::getUpdateStallTime() const
+        {
+            return device->getUpdateStallTime();
+        }
+
+        float Renderer::getRenderStallTime() const
+        {
+            return device->getRenderStallTime();
+        }
+
+        bool Renderer::addDrawCommand(const std::shared_ptr<Texture> (&textures)[Texture::LAYERS],
                                       const std::shared_ptr<Shader>& shader,
-                                      const std::vector<std::vector<float>>& pixelShaderConstants,
-                                      const std::vector<std::vector<float>>& vertexShaderConstants,
+                                      std::initializer_list<ShaderConstant> pixelShaderConstants,
+                                      std::initializer_list<ShaderConstant> vertexShaderConstants,
                                       const std::shared_ptr<BlendState>& blendState,
                                       const std::shared_ptr<MeshBuffer>& meshBuffer,
                                       uint32_t indexCount,
@@ -285,6 +344,53 @@ namespace ouzel
                                       const Rectangle& scissorRectangle,
                                       CullMode cullMode)
         {
+            return addDrawCommand(textures,
+                                  shader,
+                                  pixelShaderConstants,
+                                  vertexShaderConstants,
+                                  blendState,
+                                  meshBuffer,
+                                  indexCount,
+                                  drawMode,
+                                  startIndex,
+                                  nullptr,
+                                  0,
+                                  renderTarget,
+                                  viewport,
+                                  depthWrite,
+                                  depthTest,
+                                  wireframe,
+                                  scissorTest,
+                                  scissorRectangle,
+                                  cullMode);
+        }
+
+        bool Renderer::addDrawCommand(const std::shared_ptr<Texture> (&textures)[Texture::LAYERS],
+                                      const std::shared_ptr<Shader>& shader,
+                                      std::initializer_list<ShaderConstant> pixelShaderConstants,
+                                      std::initializer_list<ShaderConstant> vertexShaderConstants,
+                                      const std::shared_ptr<BlendState>& blendState,
+                                      const std::shared_ptr<MeshBuffer>& meshBuffer,
+                                      uint32_t indexCount,
+                                      DrawMode drawMode,
+                                      uint32_t startIndex,
+                                      const std::shared_ptr<Buffer>& instanceBuffer,
+                                      uint32_t instanceCount,
+                                      const std::shared_ptr<Texture>& renderTarget,
+                                      const Rectangle& viewport,
+                                      bool depthWrite,
+                                      bool depthTest,
+                                      bool wireframe,
+                                      bool scissorTest,
+                                      const Rectangle& scissorRectangle,
+                                      CullMode cullMode)
+        {
+            // keep the submission order of the batched draws
+            if (!flushBatch())
+            {
+                return false;
+            }
+
             if (!shader)
             {
                 Log(Log::Level::ERR) << "No shader passed to render queue";
@@ -303,20 +409,32 @@ namespace ouzel
                 return false;
             }
 
-            std::vector<TextureResource*> drawTextures;
-
-            for (const std::shared_ptr<Texture>& texture : textures)
+            if (instanceBuffer)
             {
-                drawTextures.push_back(texture ? texture->getResource() : nullptr);
+                if (instanceBuffer->getUsage() != Buffer::Usage::VERTEX)
+                {
+                    Log(Log::Level::ERR) << "Invalid instance buffer passed to render queue";
+                    return false;
+                }
+
+                if (!device->isInstancingSupported())
+                {
+                    Log(Log::Level::ERR) << "Instancing is not supported by the render device";
+                    return false;
+                }
+
+                // nothing to draw
+                if (instanceCount == 0) return true;
             }
 
             RenderDevice::DrawCommand drawCommand = {
-                drawTextures,
+                {nullptr},
                 shader->getResource(),
-                pixelShaderConstants,
-                vertexShaderConstants,
+                0, 0, 0, 0, // filled by the render device
                 blendState->getResource(),
                 meshBuffer->getResource(),
+                instanceBuffer ? instanceBuffer->getResource() : nullptr,
+                instanceBuffer ? instanceCount : 0,
                 indexCount,
                 drawMode,
                 startIndex,
@@ -327,10 +445,175 @@ namespace ouzel
                 wireframe,
                 scissorTest,
                 scissorRectangle,
-                cullMode
+                cullMode,
+                orderGroup
             };
 
-            return device->addDrawCommand(drawCommand);
+            for (uint32_t layer = 0; layer < Texture::LAYERS; ++layer)
+            {
+                drawCommand.textures[layer] = textures[layer] ? textures[layer]->getResource() : nullptr;
+            }
+
+            return device->addDrawCommand(drawCommand, pixelShaderConstants, vertexShaderConstants);
+        }
+
+        bool Renderer::addBatchedDrawCommand(const std::shared_ptr<Texture> (&textures)[Texture::LAYERS],
+                                             const std::shared_ptr<Shader>& shader,
+                                             const std::shared_ptr<BlendState>& blendState,
+                                             const std::vector<uint16_t>& indices,
+                                             const std::vector<VertexPCT>& vertices,
+                                             const Matrix4& transform,
+                                             Color color,
+                                             const Matrix4& renderViewProjection,
+                                             const std::shared_ptr<Texture>& renderTarget,
+                                             const Rectangle& viewport,
+                                             bool depthWrite,
+                                             bool depthTest,
+                                             bool wireframe,
+                                             bool scissorTest,
+                                             const Rectangle& scissorRectangle,
+                                             CullMode cullMode)
+        {
+            if (!shader)
+            {
+                Log(Log::Level::ERR) << "No shader passed to render queue";
+                return false;
+            }
+
+            if (!blendState)
+            {
+                Log(Log::Level::ERR) << "No blend state passed to render queue";
+                return false;
+            }
+
+            if (batch.indexCount > 0 &&
+                (!std::equal(std::begin(textures), std::end(textures), std::begin(batch.textures)) ||
+                 batch.shader != shader ||
+                 batch.blendState != blendState ||
+                 !std::equal(std::begin(batch.renderViewProjection.m), std::end(batch.renderViewProjection.m), std::begin(renderViewProjection.m)) ||
+                 batch.renderTarget != renderTarget ||
+                 batch.viewport != viewport ||
+                 batch.depthWrite != depthWrite ||
+                 batch.depthTest != depthTest ||
+                 batch.wireframe != wireframe ||
+                 batch.scissorTest != scissorTest ||
+                 (scissorTest && batch.scissorRectangle != scissorRectangle) ||
+                 batch.cullMode != cullMode ||
+                 (drawCommandSorting && batch.orderGroup != orderGroup)))
+            {
+                if (!flushBatch())
+                {
+                    return false;
+                }
+            }
+
+            if (batch.indexCount == 0)
+            {
+                std::copy(std::begin(textures), std::end(textures), std::begin(batch.textures));
+                batch.shader = shader;
+                batch.blendState = blendState;
+                batch.renderViewProjection = renderViewProjection;
+                batch.renderTarget = renderTarget;
+                batch.viewport = viewport;
+                batch.depthWrite = depthWrite;
+                batch.depthTest = depthTest;
+                batch.wireframe = wireframe;
+                batch.scissorTest = scissorTest;
+                batch.scissorRectangle = scissorRectangle;
+                batch.cullMode = cullMode;
+                batch.orderGroup = orderGroup;
+                batch.startIndex = static_cast<uint32_t>(batchIndices.size());
+            }
+
+            uint32_t baseVertex = static_cast<uint32_t>(batchVertices.size());
+
+            for (uint16_t index : indices)
+            {
+                batchIndices.push_back(baseVertex + index);
+            }
+
+            float colorR = color.normR();
+            float colorG = color.normG();
+            float colorB = color.normB();
+            float colorA = color.normA();
+
+            for (const VertexPCT& vertex : vertices)
+            {
+                VertexPCT batchVertex = vertex;
+                transform.transformPoint(batchVertex.position);
+                batchVertex.color.r = static_cast<uint8_t>(vertex.color.r * colorR);
+                batchVertex.color.g = static_cast<uint8_t>(vertex.color.g * colorG);
+                batchVertex.color.b = static_cast<uint8_t>(vertex.color.b * colorB);
+                batchVertex.color.a = static_cast<uint8_t>(vertex.color.a * colorA);
+
+                batchVertices.push_back(batchVertex);
+            }
+
+            batch.indexCount += static_cast<uint32_t>(indices.size());
+
+            return true;
+        }
+
+        bool Renderer::flushBatch()
+        {
+            if (batch.indexCount == 0)
+            {
+                return true;
+            }
+
+            // the color is already baked into the vertices
+            float colorVector[] = {1.0f, 1.0f, 1.0f, 1.0f};
+
+            RenderDevice::DrawCommand drawCommand = {
+                {nullptr},
+                batch.shader->getResource(),
+                0, 0, 0, 0, // filled by the render device
+                batch.blendState->getResource(),
+                batchMeshBuffers[batchBufferIndex]->getResource(),
+                nullptr, 0,
+                batch.indexCount,
+                DrawMode::TRIANGLE_LIST,
+                batch.startIndex,
+                batch.renderTarget ? batch.renderTarget->getResource() : nullptr,
+                batch.viewport,
+                batch.depthWrite,
+                batch.depthTest,
+                batch.wireframe,
+                batch.scissorTest,
+                batch.scissorRectangle,
+                batch.cullMode,
+                batch.orderGroup
+            };
+
+            for (uint32_t layer = 0; layer < Texture::LAYERS; ++layer)
+            {
+                drawCommand.textures[layer] = batch.textures[layer] ? batch.textures[layer]->getResource() : nullptr;
+                batch.textures[layer].reset();
+            }
+
+            batch.indexCount = 0;
+            batch.shader.reset();
+            batch.blendState.reset();
+            batch.renderTarget.reset();
+
+            return device->addDrawCommand(drawCommand, {colorVector}, {batch.renderViewProjection.m});
+        }
+
+        void Renderer::flushCommands()
+        {
+            flushBatch();
+
+            if (!batchVertices.empty())
+            {
+                batchIndexBuffers[batchBufferIndex]->setData(batchIndices.data(), static_cast<uint32_t>(getVectorSize(batchIndices)));
+                batchVertexBuffers[batchBufferIndex]->setData(batchVertices.data(), static_cast<uint32_t>(getVectorSize(batchVertices)));
+
+                batchIndices.clear();
+                batchVertices.clear();
+                batchBufferIndex = (batchBufferIndex + 1) % 2;
+            }
+
+            device->flushCommands();
         }
     } // namespace graphics
 } // namespace ouzel
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <cstdint>
+#include <initializer_list>
 #include <vector>
 #include <string>
 #include <queue>
@@ -13,11 +14,14 @@
 #include <atomic>
 #include <condition_variable>
 #include "utils/Noncopyable.hpp"
+#include "utils/Function.hpp"
 #include "math/Rectangle.hpp"
 #include "math/Matrix4.hpp"
 #include "math/Size2.hpp"
 #include "math/Color.hpp"
 #include "graphics/Texture.hpp"
+#include "graphics/Vertex.hpp"
+#include "graphics/RenderStatistics.hpp"
 
 namespace ouzel
 {
@@ -28,6 +32,7 @@ namespace ouzel
     {
         const std::string SHADER_TEXTURE = "shaderTexture";
         const std::string SHADER_COLOR = "shaderColor";
+        const std::string SHADER_DISTANCE_FIELD = "shaderDistanceField";
 
         const std::string BLEND_NO_BLEND = "blendNoBlend";
         const std::string BLEND_ADD = "blendAdd";
@@ -39,6 +44,7 @@ namespace ouzel
 
         class RenderDevice;
         class BlendState;
+        class Buffer;
         class MeshBuffer;
         class Shader;
 
@@ -72,13 +78,25 @@ namespace ouzel
                 BACK
             };
 
+            // view to the shader constant data, the data is copied to the per-frame arena when the draw command is added
+            struct ShaderConstant
+            {
+                ShaderConstant(const float* aData, uint32_t aSize):
+                    data(aData), size(aSize) {}
+                template<size_t N> ShaderConstant(const float (&aData)[N]):
+                    data(aData), size(static_cast<uint32_t>(N)) {}
+
+                const float* data;
+                uint32_t size;
+            };
+
             ~Renderer();
 
             static std::set<Driver> getAvailableRenderDrivers();
 
             RenderDevice* getDevice() const { return device.get(); }
 
-            void executeOnRenderThread(const std::function<void(void)>& func);
+            void executeOnRenderThread(Function&& func);
 
             void setClearColorBuffer(bool clear);
             bool getClearColorBuffer() const { return clearColorBuffer; }
@@ -96,10 +114,32 @@ namespace ouzel
 
             bool saveScreenshot(const std::string& filename);
 
-            bool addDrawCommand(const std::vector<std::shared_ptr<Texture>>& textures,
+            void setDrawCommandSorting(bool newDrawCommandSorting);
+            bool isDrawCommandSortingEnabled() const { return drawCommandSorting; }
+
+            // number of frames the update thread can queue ahead of the render thread (1 - 3)
+            void setPipeliningDepth(uint32_t newPipeliningDepth);
+            uint32_t getPipeliningDepth() const;
+
+            // counters of the last frame that the render thread has drawn
+            RenderStatistics getStatistics() const;
+
+            // writes the draw commands and the resources of the next frameCount frames to a capture file that can be replayed with RenderReplay
+            void startRecording(const std::string& filename, uint32_t frameCount);
+            void stopRecording();
+
+            // total time in seconds the update thread had to wait for a free frame
+            float getUpdateStallTime() const;
+            // total time in seconds the render thread had to wait for a finished frame
+            float getRenderStallTime() const;
+
+            // draw commands from different order groups are never reordered by the sorting stage
+            void beginOrderGroup() { ++orderGroup; }
+
+            bool addDrawCommand(const std::shared_ptr<Texture> (&textures)[Texture::LAYERS],
                                 const std::shared_ptr<Shader>& shader,
-                                const std::vector<std::vector<float>>& pixelShaderConstants,
-                                const std::vector<std::vector<float>>& vertexShaderConstants,
+                                std::initializer_list<ShaderConstant> pixelShaderConstants,
+                                std::initializer_list<ShaderConstant> vertexShaderConstants,
                                 const std::shared_ptr<BlendState>& blendState,
                                 const std::shared_ptr<MeshBuffer>& meshBuffer,
                                 uint32_t indexCount,
@@ -114,6 +154,50 @@ namespace ouzel
                                 const Rectangle& scissorRectangle,
                                 CullMode cullMode);
 
+            // draws the mesh instanceCount times, the per-instance vertex attributes of the shader are read from the instance buffer
+            bool addDrawCommand(const std::shared_ptr<Texture> (&textures)[Texture::LAYERS],
+                                const std::shared_ptr<Shader>& shader,
+                                std::initializer_list<ShaderConstant> pixelShaderConstants,
+                                std::initializer_list<ShaderConstant> vertexShaderConstants,
+                                const std::shared_ptr<BlendState>& blendState,
+                                const std::shared_ptr<MeshBuffer>& meshBuffer,
+                                uint32_t indexCount,
+                                DrawMode drawMode,
+                                uint32_t startIndex,
+                                const std::shared_ptr<Buffer>& instanceBuffer,
+                                uint32_t instanceCount,
+                                const std::shared_ptr<Texture>& renderTarget,
+                                const Rectangle& viewport,
+                                bool depthWrite,
+                                bool depthTest,
+                                bool wireframe,
+                                bool scissorTest,
+                                const Rectangle& scissorRectangle,
+                                CullMode cullMode);
+
+            // pre-transforms the vertices on the CPU and merges them with the previous compatible batched draw
+            bool addBatchedDrawCommand(const std::shared_ptr<Texture> (&textures)[Texture::LAYERS],
+                                       const std::shared_ptr<Shader>& shader,
+                                       const std::shared_ptr<BlendState>& blendState,
+                                       const std::vector<uint16_t>& indices,
+                                       const std::vector<VertexPCT>& vertices,
+                                       const Matrix4& transform,
+                                       Color color,
+                                       const Matrix4& renderViewProjection,
+                                       const std::shared_ptr<Texture>& renderTarget,
+                                       const Rectangle& viewport,
+                                       bool depthWrite,
+                                       bool depthTest,
+                                       bool wireframe,
+                                       bool scissorTest,
+                                       const Rectangle& scissorRectangle,
+                                       CullMode cullMode);
+
+            void setBatching(bool newBatching) { batching = newBatching; }
+            bool isBatchingEnabled() const { return batching; }
+
+            void flushCommands();
+
         protected:
             Renderer(Driver aDriver);
             bool init(Window* newWindow,
@@ -126,14 +210,47 @@ namespace ouzel
                       bool newDebugRenderer);
 
             void setSize(const Size2& newSize);
+            bool flushBatch();
 
             std::unique_ptr<RenderDevice> device;
 
+            struct Batch
+            {
+                std::shared_ptr<Texture> textures[Texture::LAYERS];
+                std::shared_ptr<Shader> shader;
+                std::shared_ptr<BlendState> blendState;
+                Matrix4 renderViewProjection;
+                std::shared_ptr<Texture> renderTarget;
+                Rectangle viewport;
+                bool depthWrite = false;
+                bool depthTest = false;
+                bool wireframe = false;
+                bool scissorTest = false;
+                Rectangle scissorRectangle;
+                CullMode cullMode = CullMode::NONE;
+                uint32_t orderGroup = 0;
+                uint32_t startIndex = 0;
+                uint32_t indexCount = 0;
+            };
+
+            bool batching = true;
+            Batch batch;
+            std::vector<uint32_t> batchIndices;
+            std::vector<VertexPCT> batchVertices;
+
+            // two sets of streaming buffers, so that the next frame does not overwrite data that is not drawn yet
+            uint32_t batchBufferIndex = 0;
+            std::shared_ptr<Buffer> batchIndexBuffers[2];
+            std::shared_ptr<Buffer> batchVertexBuffers[2];
+            std::shared_ptr<MeshBuffer> batchMeshBuffers[2];
+
             Size2 size;
             Color clearColor;
             float clearDepth = 1.0;
             bool clearColorBuffer = true;
             bool clearDepthBuffer = false;
+            bool drawCommandSorting = false;
+            uint32_t orderGroup = 0;
         };
     } // namespace graphics
 } // namespace ouzel
@@ -32,10 +32,18 @@ namespace ouzel
             vertexShaderConstantInfo = newVertexShaderConstantInfo;
 
             vertexSize = 0;
+            instanceSize = 0;
 
             for (const VertexAttribute& vertexAttribute : vertexAttributes)
             {
-                vertexSize += getDataTypeSize(vertexAttribute.dataType);
+                if (vertexAttribute.isPerInstance())
+                {
+                    instanceSize += getDataTypeSize(vertexAttribute.dataType);
+                }
+                else
+                {
+                    vertexSize += getDataTypeSize(vertexAttribute.dataType);
+                }
             }
 
             if (newPixelShaderDataAlignment)
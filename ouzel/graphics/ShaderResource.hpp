@@ -17,10 +17,12 @@ namespace ouzel
     namespace graphics
     {
         class Renderer;
+        class RenderRecorder;
 
         class ShaderResource: public RenderResource
         {
             friend Renderer;
+            friend RenderRecorder;
         public:
             virtual ~ShaderResource();
 
@@ -36,6 +38,7 @@ namespace ouzel
 
             const std::vector<VertexAttribute>& getVertexAttributes() const { return vertexAttributes; }
             uint32_t getVertexSize() const { return vertexSize; }
+            uint32_t getInstanceSize() const { return instanceSize; }
 
             uint32_t getPixelShaderAlignment() const { return pixelShaderAlignment; }
             uint32_t getVertexShaderAlignment() const { return vertexShaderAlignment; }
@@ -45,6 +48,7 @@ namespace ouzel
 
             std::vector<VertexAttribute> vertexAttributes;
             uint32_t vertexSize = 0;
+            uint32_t instanceSize = 0; // size of the per-instance attributes
 
             std::vector<uint8_t> pixelShaderData;
             std::vector<uint8_t> vertexShaderData;
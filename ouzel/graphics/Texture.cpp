@@ -150,6 +150,16 @@ namespace ouzel
             return true;
         }
 
+        bool Texture::setRegionData(const std::vector<uint8_t>& newData, const Rectangle& region)
+        {
+            sharedEngine->getRenderer()->executeOnRenderThread(std::bind(&TextureResource::setRegionData,
+                                                                         resource,
+                                                                         newData,
+                                                                         region));
+
+            return true;
+        }
+
         Texture::Filter Texture::getFilter() const
         {
             return filter;
@@ -9,6 +9,7 @@
 #include "utils/Noncopyable.hpp"
 #include "graphics/PixelFormat.hpp"
 #include "math/Color.hpp"
+#include "math/Rectangle.hpp"
 #include "math/Size2.hpp"
 
 namespace ouzel
@@ -82,6 +83,8 @@ namespace ouzel
             bool setSize(const Size2& newSize);
 
             bool setData(const std::vector<uint8_t>& newData, const Size2& newSize);
+            // replaces only the pixels of the region, newData contains the rows of the region without padding
+            bool setRegionData(const std::vector<uint8_t>& newData, const Rectangle& region);
 
             uint32_t getFlags() const { return flags; }
             uint32_t getMipmaps() const { return mipmaps; }
@@ -5,6 +5,7 @@
 #include "TextureResource.hpp"
 #include "Renderer.hpp"
 #include "RenderDevice.hpp"
+#include "RenderRecorder.hpp"
 #include "core/Engine.hpp"
 #include "math/MathUtils.hpp"
 
@@ -63,6 +64,8 @@ namespace ouzel
                 return false;
             }
 
+            sharedEngine->getRenderer()->getDevice()->addTextureUpload(getDataSize());
+
             return true;
         }
 
@@ -78,6 +81,8 @@ namespace ouzel
             sampleCount = 1;
             pixelFormat = newPixelFormat;
 
+            sharedEngine->getRenderer()->getDevice()->addTextureUpload(getDataSize());
+
             return true;
         }
 
@@ -129,9 +134,25 @@ namespace ouzel
                 return false;
             }
 
+            RenderDevice* renderDevice = sharedEngine->getRenderer()->getDevice();
+            renderDevice->addTextureUpload(getDataSize());
+            if (RenderRecorder* recorder = renderDevice->getRecorder()) recorder->recordTextureData(this, newData, newSize);
+
             return true;
         }
 
+        uint32_t TextureResource::getDataSize() const
+        {
+            uint32_t result = 0;
+
+            for (const Texture::Level& level : levels)
+            {
+                result += static_cast<uint32_t>(level.data.size());
+            }
+
+            return result;
+        }
+
         bool TextureResource::calculateSizes(const Size2& newSize)
         {
             levels.clear();
@@ -529,6 +550,93 @@ namespace ouzel
             return true;
         }
 
+        bool TextureResource::setRegionData(const std::vector<uint8_t>& newData, const Rectangle& region)
+        {
+            if (!(flags & Texture::DYNAMIC) || flags & Texture::RENDER_TARGET || levels.empty())
+            {
+                return false;
+            }
+
+            if (region.position.x < 0.0f || region.position.y < 0.0f ||
+                region.size.width <= 0.0f || region.size.height <= 0.0f ||
+                region.position.x + region.size.width > size.width ||
+                region.position.y + region.size.height > size.height)
+            {
+                return false;
+            }
+
+            uint32_t pixelSize = getPixelSize(pixelFormat);
+            uint32_t regionX = static_cast<uint32_t>(region.position.x);
+            uint32_t regionY = static_cast<uint32_t>(region.position.y);
+            uint32_t regionPitch = static_cast<uint32_t>(region.size.width) * pixelSize;
+            uint32_t regionHeight = static_cast<uint32_t>(region.size.height);
+
+            if (newData.size() < regionPitch * regionHeight)
+            {
+                return false;
+            }
+
+            for (uint32_t row = 0; row < regionHeight; ++row)
+            {
+                std::copy(newData.begin() + row * regionPitch,
+                          newData.begin() + (row + 1) * regionPitch,
+                          levels[0].data.begin() + (regionY + row) * levels[0].pitch + regionX * pixelSize);
+            }
+
+            // only the affected pixels of the smaller levels are downsampled again
+            for (uint32_t level = 1; level < static_cast<uint32_t>(levels.size()); ++level)
+            {
+                uint32_t x, y, width, height;
+                getLevelRegion(level, region, x, y, width, height);
+
+                uint32_t previousWidth = static_cast<uint32_t>(levels[level - 1].size.width);
+                uint32_t previousHeight = static_cast<uint32_t>(levels[level - 1].size.height);
+                uint32_t previousPitch = levels[level - 1].pitch;
+
+                for (uint32_t row = y; row < y + height; ++row)
+                {
+                    const uint8_t* source = levels[level - 1].data.data() + row * 2 * previousPitch + x * 2 * pixelSize;
+                    uint8_t* destination = levels[level].data.data() + row * levels[level].pitch + x * pixelSize;
+
+                    uint32_t sourceWidth = std::min(width * 2, previousWidth - x * 2);
+                    uint32_t sourceHeight = std::min(2U, previousHeight - row * 2);
+
+                    if (pixelFormat == PixelFormat::RGBA8_UNORM) imageRGBA8Downsample2x2(sourceWidth, sourceHeight, previousPitch, source, destination);
+                    else if (pixelFormat == PixelFormat::RG8_UNORM) imageRG8Downsample2x2(sourceWidth, sourceHeight, previousPitch, source, destination);
+                    else if (pixelFormat == PixelFormat::R8_UNORM) imageR8Downsample2x2(sourceWidth, sourceHeight, previousPitch, source, destination);
+                    else if (pixelFormat == PixelFormat::A8_UNORM) imageA8Downsample2x2(sourceWidth, sourceHeight, previousPitch, source, destination);
+                }
+            }
+
+            RenderDevice* renderDevice = sharedEngine->getRenderer()->getDevice();
+            renderDevice->addTextureUpload(regionPitch * regionHeight);
+            if (RenderRecorder* recorder = renderDevice->getRecorder()) recorder->recordTextureData(this, levels[0].data, size);
+
+            return true;
+        }
+
+        void TextureResource::getLevelRegion(uint32_t level, const Rectangle& region,
+                                             uint32_t& x, uint32_t& y, uint32_t& width, uint32_t& height) const
+        {
+            uint32_t left = static_cast<uint32_t>(region.position.x);
+            uint32_t top = static_cast<uint32_t>(region.position.y);
+            uint32_t right = left + static_cast<uint32_t>(region.size.width);
+            uint32_t bottom = top + static_cast<uint32_t>(region.size.height);
+
+            for (uint32_t i = 1; i <= level && i < static_cast<uint32_t>(levels.size()); ++i)
+            {
+                left /= 2;
+                top /= 2;
+                right = std::min((right + 1) / 2, static_cast<uint32_t>(levels[i].size.width));
+                bottom = std::min((bottom + 1) / 2, static_cast<uint32_t>(levels[i].size.height));
+            }
+
+            x = left;
+            y = top;
+            width = (right > left) ? right - left : 0;
+            height = (bottom > top) ? bottom - top : 0;
+        }
+
         bool TextureResource::setFilter(Texture::Filter newFilter)
         {
             filter = newFilter;
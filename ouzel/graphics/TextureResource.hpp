@@ -9,6 +9,7 @@
 #include "graphics/RenderResource.hpp"
 #include "graphics/Texture.hpp"
 #include "math/Color.hpp"
+#include "math/Rectangle.hpp"
 #include "math/Size2.hpp"
 
 namespace ouzel
@@ -16,10 +17,12 @@ namespace ouzel
     namespace graphics
     {
         class Renderer;
+        class RenderRecorder;
 
         class TextureResource: public RenderResource
         {
             friend Renderer;
+            friend RenderRecorder;
         public:
             virtual ~TextureResource();
 
@@ -42,6 +45,7 @@ namespace ouzel
             const Size2& getSize() const { return size; }
 
             virtual bool setData(const std::vector<uint8_t>& newData, const Size2& newSize);
+            virtual bool setRegionData(const std::vector<uint8_t>& newData, const Rectangle& region);
 
             uint32_t getFlags() const { return flags; }
             uint32_t getMipmaps() const { return mipmaps; }
@@ -81,7 +85,11 @@ namespace ouzel
             TextureResource();
 
             bool calculateSizes(const Size2& newSize);
+            uint32_t getDataSize() const;
             bool calculateData(const std::vector<uint8_t>& newData);
+            // the part of the level that is affected by a change of the region of the first level
+            void getLevelRegion(uint32_t level, const Rectangle& region,
+                                uint32_t& x, uint32_t& y, uint32_t& width, uint32_t& height) const;
 
             Size2 size;
             uint32_t flags = 0;
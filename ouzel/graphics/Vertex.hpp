@@ -28,11 +28,25 @@ namespace ouzel
                 POSITION_TRANSFORMED,
                 POINT_SIZE,
                 TANGENT,
-                TEXTURE_COORDINATES
+                TEXTURE_COORDINATES,
+                // per-instance data, read from the instance buffer of an instanced draw
+                INSTANCE_POSITION,
+                INSTANCE_COLOR,
+                INSTANCE_TRANSFORM, // one row of the matrix per index
+                INSTANCE_DATA
             };
 
             VertexAttribute(Usage aUsage, uint32_t aIndex, DataType aDataType, bool aNormalized):
                 usage(aUsage), index(aIndex), dataType(aDataType), normalized(aNormalized) {}
+
+            bool isPerInstance() const
+            {
+                return usage == Usage::INSTANCE_POSITION ||
+                    usage == Usage::INSTANCE_COLOR ||
+                    usage == Usage::INSTANCE_TRANSFORM ||
+                    usage == Usage::INSTANCE_DATA;
+            }
+
             Usage usage = Usage::NONE;
             uint32_t index = 0;
             DataType dataType = DataType::NONE;
@@ -56,9 +56,9 @@ namespace ouzel
             return true;
         }
 
-        bool BufferResourceD3D11::setData(const std::vector<uint8_t>& newData)
+        bool BufferResourceD3D11::setData(const void* newData, uint32_t newSize)
         {
-            if (!BufferResource::setData(newData))
+            if (!BufferResource::setData(newData, newSize))
             {
                 return false;
             }
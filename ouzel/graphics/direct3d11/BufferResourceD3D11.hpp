@@ -25,7 +25,7 @@ namespace ouzel
             virtual bool init(Buffer::Usage newUsage, uint32_t newFlags = 0, uint32_t newSize = 0) override;
             virtual bool init(Buffer::Usage newUsage, const std::vector<uint8_t>& newData, uint32_t newFlags = 0) override;
 
-            virtual bool setData(const std::vector<uint8_t>& newData) override;
+            virtual bool setData(const void* newData, uint32_t newSize) override;
 
             ID3D11Buffer* getBuffer() const { return buffer; }
 
@@ -42,8 +42,7 @@ namespace ouzel
 
             if (renderThread.joinable()) renderThread.join();
 
-            resourceDeleteSet.clear();
-            resources.clear();
+            releaseResources();
 
             for (ID3D11DepthStencilState* depthStencilState : depthStencilStates)
             {
@@ -560,7 +559,7 @@ namespace ouzel
                 // pixel shader constants
                 const std::vector<ShaderResourceD3D11::Location>& pixelShaderConstantLocations = shaderD3D11->getPixelShaderConstantLocations();
 
-                if (drawCommand.pixelShaderConstants.size() > pixelShaderConstantLocations.size())
+                if (drawCommand.pixelShaderConstantCount > pixelShaderConstantLocations.size())
                 {
                     Log(Log::Level::ERR) << "Invalid pixel shader constant size";
                     return false;
@@ -568,18 +567,19 @@ namespace ouzel
 
                 shaderData.clear();
 
-                for (size_t i = 0; i < drawCommand.pixelShaderConstants.size(); ++i)
+                for (uint32_t i = 0; i < drawCommand.pixelShaderConstantCount; ++i)
                 {
                     const ShaderResourceD3D11::Location& pixelShaderConstantLocation = pixelShaderConstantLocations[i];
-                    const std::vector<float>& pixelShaderConstant = drawCommand.pixelShaderConstants[i];
+                    uint32_t pixelShaderConstantSize;
+                    const float* pixelShaderConstant = getShaderConstant(drawCommand.pixelShaderConstantStart + i, pixelShaderConstantSize);
 
-                    if (sizeof(float) * pixelShaderConstant.size() != pixelShaderConstantLocation.size)
+                    if (sizeof(float) * pixelShaderConstantSize != pixelShaderConstantLocation.size)
                     {
                         Log(Log::Level::ERR) << "Invalid pixel shader constant size";
                         return false;
                     }
 
-                    shaderData.insert(shaderData.end(), pixelShaderConstant.begin(), pixelShaderConstant.end());
+                    shaderData.insert(shaderData.end(), pixelShaderConstant, pixelShaderConstant + pixelShaderConstantSize);
                 }
 
                 if (!uploadBuffer(shaderD3D11->getPixelShaderConstantBuffer(),
@@ -595,7 +595,7 @@ namespace ouzel
                 // vertex shader constants
                 const std::vector<ShaderResourceD3D11::Location>& vertexShaderConstantLocations = shaderD3D11->getVertexShaderConstantLocations();
 
-                if (drawCommand.vertexShaderConstants.size() > vertexShaderConstantLocations.size())
+                if (drawCommand.vertexShaderConstantCount > vertexShaderConstantLocations.size())
                 {
                     Log(Log::Level::ERR) << "Invalid vertex shader constant size";
                     return false;
@@ -603,18 +603,19 @@ namespace ouzel
 
                 shaderData.clear();
 
-                for (size_t i = 0; i < drawCommand.vertexShaderConstants.size(); ++i)
+                for (uint32_t i = 0; i < drawCommand.vertexShaderConstantCount; ++i)
                 {
                     const ShaderResourceD3D11::Location& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
-                    const std::vector<float>& vertexShaderConstant = drawCommand.vertexShaderConstants[i];
+                    uint32_t vertexShaderConstantSize;
+                    const float* vertexShaderConstant = getShaderConstant(drawCommand.vertexShaderConstantStart + i, vertexShaderConstantSize);
 
-                    if (sizeof(float) * vertexShaderConstant.size() != vertexShaderConstantLocation.size)
+                    if (sizeof(float) * vertexShaderConstantSize != vertexShaderConstantLocation.size)
                     {
                         Log(Log::Level::ERR) << "Invalid pixel shader constant size";
                         return false;
                     }
 
-                    shaderData.insert(shaderData.end(), vertexShaderConstant.begin(), vertexShaderConstant.end());
+                    shaderData.insert(shaderData.end(), vertexShaderConstant, vertexShaderConstant + vertexShaderConstantSize);
                 }
 
                 if (!uploadBuffer(shaderD3D11->getVertexShaderConstantBuffer(),
@@ -643,12 +644,7 @@ namespace ouzel
 
                 for (uint32_t layer = 0; layer < Texture::LAYERS; ++layer)
                 {
-                    TextureResourceD3D11* textureD3D11 = nullptr;
-
-                    if (drawCommand.textures.size() > layer)
-                    {
-                        textureD3D11 = static_cast<TextureResourceD3D11*>(drawCommand.textures[layer]);
-                    }
+                    TextureResourceD3D11* textureD3D11 = static_cast<TextureResourceD3D11*>(drawCommand.textures[layer]);
 
                     if (textureD3D11)
                     {
@@ -698,10 +694,17 @@ namespace ouzel
                     continue;
                 }
 
-                ID3D11Buffer* buffers[] = {vertexBufferD3D11->getBuffer()};
-                UINT strides[] = {meshBufferD3D11->getVertexSize()};
-                UINT offsets[] = {0};
-                context->IASetVertexBuffers(0, 1, buffers, strides, offsets);
+                BufferResourceD3D11* instanceBufferD3D11 = static_cast<BufferResourceD3D11*>(drawCommand.instanceBuffer);
+
+                if (instanceBufferD3D11 && !instanceBufferD3D11->getBuffer())
+                {
+                    continue;
+                }
+
+                ID3D11Buffer* buffers[] = {vertexBufferD3D11->getBuffer(), instanceBufferD3D11 ? instanceBufferD3D11->getBuffer() : nullptr};
+                UINT strides[] = {meshBufferD3D11->getVertexSize(), shaderD3D11->getInstanceSize()};
+                UINT offsets[] = {0, 0};
+                context->IASetVertexBuffers(0, instanceBufferD3D11 ? 2 : 1, buffers, strides, offsets);
                 context->IASetIndexBuffer(indexBufferD3D11->getBuffer(), meshBufferD3D11->getIndexFormat(), 0);
 
                 D3D_PRIMITIVE_TOPOLOGY topology;
@@ -725,7 +728,14 @@ namespace ouzel
                     indexCount = (indexBufferD3D11->getSize() / meshBufferD3D11->getIndexSize()) - drawCommand.startIndex;
                 }
 
-                context->DrawIndexed(indexCount, drawCommand.startIndex, 0);
+                if (instanceBufferD3D11)
+                {
+                    context->DrawIndexedInstanced(indexCount, drawCommand.instanceCount, drawCommand.startIndex, 0, 0);
+                }
+                else
+                {
+                    context->DrawIndexed(indexCount, drawCommand.startIndex, 0);
+                }
             }
 
             swapChain->Present(swapInterval, 0);
@@ -904,46 +914,36 @@ namespace ouzel
 
         BlendStateResource* RenderDeviceD3D11::createBlendState()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             BlendStateResource* blendState = new BlendStateResourceD3D11(this);
-            resources.push_back(std::unique_ptr<RenderResource>(blendState));
+            addResource(blendState);
             return blendState;
         }
 
         TextureResource* RenderDeviceD3D11::createTexture()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             TextureResource* texture = new TextureResourceD3D11(this);
-            resources.push_back(std::unique_ptr<RenderResource>(texture));
+            addResource(texture);
             return texture;
         }
 
         ShaderResource* RenderDeviceD3D11::createShader()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             ShaderResource* shader = new ShaderResourceD3D11(this);
-            resources.push_back(std::unique_ptr<RenderResource>(shader));
+            addResource(shader);
             return shader;
         }
 
         MeshBufferResource* RenderDeviceD3D11::createMeshBuffer()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             MeshBufferResource* meshBuffer = new MeshBufferResourceD3D11();
-            resources.push_back(std::unique_ptr<RenderResource>(meshBuffer));
+            addResource(meshBuffer);
             return meshBuffer;
         }
 
         BufferResource* RenderDeviceD3D11::createBuffer()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             BufferResource* buffer = new BufferResourceD3D11(this);
-            resources.push_back(std::unique_ptr<RenderResource>(buffer));
+            addResource(buffer);
             return buffer;
         }
 
@@ -162,6 +162,7 @@ namespace ouzel
             std::vector<D3D11_INPUT_ELEMENT_DESC> vertexInputElements;
 
             UINT offset = 0;
+            UINT instanceOffset = 0;
 
             for (const VertexAttribute& vertexAttribute : vertexAttributes)
             {
@@ -207,17 +208,42 @@ namespace ouzel
                     case VertexAttribute::Usage::TEXTURE_COORDINATES:
                         usage = "TEXCOORD";
                         break;
+                    case VertexAttribute::Usage::INSTANCE_POSITION:
+                        usage = "INSTANCEPOSITION";
+                        break;
+                    case VertexAttribute::Usage::INSTANCE_COLOR:
+                        usage = "INSTANCECOLOR";
+                        break;
+                    case VertexAttribute::Usage::INSTANCE_TRANSFORM:
+                        usage = "INSTANCETRANSFORM";
+                        break;
+                    case VertexAttribute::Usage::INSTANCE_DATA:
+                        usage = "INSTANCEDATA";
+                        break;
                     default:
                         Log(Log::Level::ERR) << "Invalid vertex attribute usage";
                         return false;
                 }
 
-                vertexInputElements.push_back({
-                    usage, vertexAttribute.index,
-                    vertexFormat,
-                    0, offset, D3D11_INPUT_PER_VERTEX_DATA, 0
-                });
-                offset += getDataTypeSize(vertexAttribute.dataType);
+                if (vertexAttribute.isPerInstance())
+                {
+                    // per-instance attributes are read from the second input slot
+                    vertexInputElements.push_back({
+                        usage, vertexAttribute.index,
+                        vertexFormat,
+                        1, instanceOffset, D3D11_INPUT_PER_INSTANCE_DATA, 1
+                    });
+                    instanceOffset += getDataTypeSize(vertexAttribute.dataType);
+                }
+                else
+                {
+                    vertexInputElements.push_back({
+                        usage, vertexAttribute.index,
+                        vertexFormat,
+                        0, offset, D3D11_INPUT_PER_VERTEX_DATA, 0
+                    });
+                    offset += getDataTypeSize(vertexAttribute.dataType);
+                }
             }
 
             if (inputLayout) inputLayout->Release();
@@ -201,66 +201,93 @@ namespace ouzel
             }
             else if (!(flags & Texture::RENDER_TARGET))
             {
-                if (flags & Texture::DYNAMIC)
+                if (!uploadLevels())
                 {
-                    for (size_t level = 0; level < levels.size(); ++level)
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        bool TextureResourceD3D11::setRegionData(const std::vector<uint8_t>& newData, const Rectangle& region)
+        {
+            if (!TextureResource::setRegionData(newData, region))
+            {
+                return false;
+            }
+
+            if (!texture)
+            {
+                Log(Log::Level::ERR) << "Texture not initialized";
+                return false;
+            }
+
+            // dynamic textures can only be mapped with discard, so the whole levels are written
+            return uploadLevels();
+        }
+
+        bool TextureResourceD3D11::uploadLevels()
+        {
+            if (flags & Texture::DYNAMIC)
+            {
+                for (size_t level = 0; level < levels.size(); ++level)
+                {
+                    if (!levels[level].data.empty())
                     {
-                        if (!levels[level].data.empty())
+                        D3D11_MAPPED_SUBRESOURCE mappedSubresource;
+                        mappedSubresource.pData = nullptr;
+                        mappedSubresource.RowPitch = 0;
+                        mappedSubresource.DepthPitch = 0;
+                    
+                        HRESULT hr = renderDeviceD3D11->getContext()->Map(texture, static_cast<UINT>(level),
+                                                                          (level == 0) ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE,
+                                                                          0, &mappedSubresource);
+
+                        if (FAILED(hr))
                         {
-                            D3D11_MAPPED_SUBRESOURCE mappedSubresource;
-                            mappedSubresource.pData = nullptr;
-                            mappedSubresource.RowPitch = 0;
-                            mappedSubresource.DepthPitch = 0;
-                        
-                            HRESULT hr = renderDeviceD3D11->getContext()->Map(texture, static_cast<UINT>(level),
-                                                                              (level == 0) ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE,
-                                                                              0, &mappedSubresource);
-
-                            if (FAILED(hr))
-                            {
-                                Log(Log::Level::ERR) << "Failed to map Direct3D 11 texture, error: " << hr;
-                                return false;
-                            }
+                            Log(Log::Level::ERR) << "Failed to map Direct3D 11 texture, error: " << hr;
+                            return false;
+                        }
 
-                            uint8_t* destination = static_cast<uint8_t*>(mappedSubresource.pData);
-                        
-                            if (mappedSubresource.RowPitch == levels[level].pitch)
+                        uint8_t* destination = static_cast<uint8_t*>(mappedSubresource.pData);
+                    
+                        if (mappedSubresource.RowPitch == levels[level].pitch)
+                        {
+                            std::copy(levels[level].data.begin(),
+                                      levels[level].data.end(),
+                                      destination);
+                        }
+                        else
+                        {
+                            auto source = levels[level].data.begin();
+                            UINT rowSize = static_cast<UINT>(levels[level].size.width) * getPixelSize(pixelFormat);
+                            UINT rows = static_cast<UINT>(levels[level].size.height);
+
+                            for (UINT row = 0; row < rows; ++row)
                             {
-                                std::copy(levels[level].data.begin(),
-                                          levels[level].data.end(),
+                                std::copy(source,
+                                          source + rowSize,
                                           destination);
-                            }
-                            else
-                            {
-                                auto source = levels[level].data.begin();
-                                UINT rowSize = static_cast<UINT>(levels[level].size.width) * getPixelSize(pixelFormat);
-                                UINT rows = static_cast<UINT>(levels[level].size.height);
-
-                                for (UINT row = 0; row < rows; ++row)
-                                {
-                                    std::copy(source,
-                                              source + rowSize,
-                                              destination);
-
-                                    source += levels[level].pitch;
-                                    destination += mappedSubresource.RowPitch;
-                                }
-                            }
 
-                            renderDeviceD3D11->getContext()->Unmap(texture, static_cast<UINT>(level));
+                                source += levels[level].pitch;
+                                destination += mappedSubresource.RowPitch;
+                            }
                         }
+
+                        renderDeviceD3D11->getContext()->Unmap(texture, static_cast<UINT>(level));
                     }
                 }
-                else
+            }
+            else
+            {
+                for (size_t level = 0; level < levels.size(); ++level)
                 {
-                    for (size_t level = 0; level < levels.size(); ++level)
+                    if (!levels[level].data.empty())
                     {
-                        if (!levels[level].data.empty())
-                        {
-                            renderDeviceD3D11->getContext()->UpdateSubresource(texture, static_cast<UINT>(level),
-                                                                               nullptr, levels[level].data.data(),
-                                                                               static_cast<UINT>(levels[level].pitch), 0);
-                        }
+                        renderDeviceD3D11->getContext()->UpdateSubresource(texture, static_cast<UINT>(level),
+                                                                           nullptr, levels[level].data.data(),
+                                                                           static_cast<UINT>(levels[level].pitch), 0);
                     }
                 }
             }
@@ -50,6 +50,16 @@ namespace ouzel
 
             sharedEngine->getCache()->setShader(SHADER_TEXTURE, textureShader);
 
+            std::shared_ptr<Shader> distanceFieldShader = std::make_shared<Shader>();
+
+            distanceFieldShader->init(std::vector<uint8_t>(),
+                                      std::vector<uint8_t>(),
+                                      VertexPCT::ATTRIBUTES,
+                                      {{"color", DataType::FLOAT_VECTOR4}},
+                                      {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+
+            sharedEngine->getCache()->setShader(SHADER_DISTANCE_FIELD, distanceFieldShader);
+
             std::shared_ptr<Shader> colorShader = std::make_shared<Shader>();
 
             colorShader->init(std::vector<uint8_t>(),
@@ -70,46 +80,36 @@ namespace ouzel
 
         BlendStateResource* RenderDeviceEmpty::createBlendState()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             BlendStateResource* blendState = new BlendStateResourceEmpty();
-            resources.push_back(std::unique_ptr<RenderResource>(blendState));
+            addResource(blendState);
             return blendState;
         }
 
         TextureResource* RenderDeviceEmpty::createTexture()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             TextureResource* texture(new TextureResourceEmpty());
-            resources.push_back(std::unique_ptr<RenderResource>(texture));
+            addResource(texture);
             return texture;
         }
 
         ShaderResource* RenderDeviceEmpty::createShader()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             ShaderResource* shader = new ShaderResourceEmpty();
-            resources.push_back(std::unique_ptr<RenderResource>(shader));
+            addResource(shader);
             return shader;
         }
 
         MeshBufferResource* RenderDeviceEmpty::createMeshBuffer()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             MeshBufferResource* meshBuffer = new MeshBufferResourceEmpty();
-            resources.push_back(std::unique_ptr<RenderResource>(meshBuffer));
+            addResource(meshBuffer);
             return meshBuffer;
         }
 
         BufferResource* RenderDeviceEmpty::createBuffer()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             BufferResource* buffer = new BufferResourceEmpty();
-            resources.push_back(std::unique_ptr<RenderResource>(buffer));
+            addResource(buffer);
             return buffer;
         }
     } // namespace graphics
@@ -34,9 +34,11 @@ namespace ouzel
             virtual bool init(Buffer::Usage newUsage, uint32_t newFlags = 0, uint32_t newSize = 0) override;
             virtual bool init(Buffer::Usage newUsage, const std::vector<uint8_t>& newData, uint32_t newFlags = 0) override;
 
-            virtual bool setData(const std::vector<uint8_t>& newData) override;
+            virtual bool setData(const void* newData, uint32_t newSize) override;
 
             MTLBufferPtr getBuffer() const { return buffer; }
+            // offset of the region that holds the data of the current frame
+            uint32_t getOffset() const { return regionIndex * bufferSize; }
 
         protected:
             bool createBuffer();
@@ -44,7 +46,12 @@ namespace ouzel
             RenderDeviceMetal* renderDeviceMetal;
 
             MTLBufferPtr buffer = nil;
-            uint32_t bufferSize = 0;
+            uint32_t bufferSize = 0; // size of one region
+
+            // dynamic buffers are a ring of regions, a region is written again only after the command buffers that read it have completed
+            uint32_t regionCount = 1;
+            uint32_t regionIndex = 0;
+            uint32_t regionFrame = 0; // frame in which the current region was written
         };
     } // namespace graphics
 } // namespace ouzel
@@ -14,6 +14,10 @@ namespace ouzel
 {
     namespace graphics
     {
+        // the device encodes up to 3 command buffers simultaneously and the data of a frame is written
+        // before its command buffer waits for a free slot, so the region of 4 frames ago is no longer read
+        static const uint32_t DYNAMIC_REGION_COUNT = 4;
+
         BufferResourceMetal::BufferResourceMetal(RenderDeviceMetal* aRenderDeviceMetal):
             renderDeviceMetal(aRenderDeviceMetal)
         {
@@ -62,13 +66,15 @@ namespace ouzel
             return true;
         }
 
-        bool BufferResourceMetal::setData(const std::vector<uint8_t>& newData)
+        bool BufferResourceMetal::setData(const void* newData, uint32_t newSize)
         {
-            if (!BufferResource::setData(newData))
+            if (!BufferResource::setData(newData, newSize))
             {
                 return false;
             }
 
+            uint32_t frame = renderDeviceMetal->getCurrentFrame();
+
             if (!buffer || data.size() > bufferSize)
             {
                 if (!createBuffer())
@@ -76,10 +82,17 @@ namespace ouzel
                     return false;
                 }
             }
+            else if (frame != regionFrame)
+            {
+                // the regions written in the same frame are overwritten, none of the frame's command buffers was encoded yet
+                regionIndex = (regionIndex + 1) % regionCount;
+            }
+
+            regionFrame = frame;
 
             if (!data.empty())
             {
-                std::copy(data.begin(), data.end(), static_cast<uint8_t*>([buffer contents]));
+                std::copy(data.begin(), data.end(), static_cast<uint8_t*>([buffer contents]) + getOffset());
             }
 
             return true;
@@ -94,10 +107,13 @@ namespace ouzel
             }
 
             bufferSize = static_cast<uint32_t>(data.size());
+            regionCount = (flags & Buffer::DYNAMIC) ? DYNAMIC_REGION_COUNT : 1;
+            regionIndex = 0;
 
             if (!data.empty())
             {
-                buffer = [renderDeviceMetal->getDevice() newBufferWithLength:bufferSize
+                // the released buffer is retained by the command buffers that still use it
+                buffer = [renderDeviceMetal->getDevice() newBufferWithLength:bufferSize * regionCount
                                                                      options:MTLResourceCPUCacheModeWriteCombined];
 
                 if (!buffer)
@@ -77,8 +77,7 @@ namespace ouzel
 
         RenderDeviceMetal::~RenderDeviceMetal()
         {
-            resourceDeleteSet.clear();
-            resources.clear();
+            releaseResources();
 
             for (const ShaderConstantBuffer& shaderConstantBuffer : shaderConstantBuffers)
             {
@@ -575,7 +574,7 @@ namespace ouzel
                 // pixel shader constants
                 const std::vector<ShaderResourceMetal::Location>& pixelShaderConstantLocations = shaderMetal->getPixelShaderConstantLocations();
 
-                if (drawCommand.pixelShaderConstants.size() > pixelShaderConstantLocations.size())
+                if (drawCommand.pixelShaderConstantCount > pixelShaderConstantLocations.size())
                 {
                     Log(Log::Level::ERR) << "Invalid pixel shader constant size";
                     return false;
@@ -583,18 +582,19 @@ namespace ouzel
 
                 shaderData.clear();
 
-                for (size_t i = 0; i < drawCommand.pixelShaderConstants.size(); ++i)
+                for (uint32_t i = 0; i < drawCommand.pixelShaderConstantCount; ++i)
                 {
                     const ShaderResourceMetal::Location& pixelShaderConstantLocation = pixelShaderConstantLocations[i];
-                    const std::vector<float>& pixelShaderConstant = drawCommand.pixelShaderConstants[i];
+                    uint32_t pixelShaderConstantSize;
+                    const float* pixelShaderConstant = getShaderConstant(drawCommand.pixelShaderConstantStart + i, pixelShaderConstantSize);
 
-                    if (sizeof(float) * pixelShaderConstant.size() != pixelShaderConstantLocation.size)
+                    if (sizeof(float) * pixelShaderConstantSize != pixelShaderConstantLocation.size)
                     {
                         Log(Log::Level::ERR) << "Invalid pixel shader constant size";
                         return false;
                     }
 
-                    shaderData.insert(shaderData.end(), pixelShaderConstant.begin(), pixelShaderConstant.end());
+                    shaderData.insert(shaderData.end(), pixelShaderConstant, pixelShaderConstant + pixelShaderConstantSize);
                 }
 
                 shaderConstantBuffer.offset = ((shaderConstantBuffer.offset + shaderMetal->getPixelShaderAlignment() - 1) /
@@ -618,7 +618,7 @@ namespace ouzel
                 // vertex shader constants
                 const std::vector<ShaderResourceMetal::Location>& vertexShaderConstantLocations = shaderMetal->getVertexShaderConstantLocations();
 
-                if (drawCommand.vertexShaderConstants.size() > vertexShaderConstantLocations.size())
+                if (drawCommand.vertexShaderConstantCount > vertexShaderConstantLocations.size())
                 {
                     Log(Log::Level::ERR) << "Invalid vertex shader constant size";
                     return false;
@@ -626,18 +626,19 @@ namespace ouzel
 
                 shaderData.clear();
 
-                for (size_t i = 0; i < drawCommand.vertexShaderConstants.size(); ++i)
+                for (uint32_t i = 0; i < drawCommand.vertexShaderConstantCount; ++i)
                 {
                     const ShaderResourceMetal::Location& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
-                    const std::vector<float>& vertexShaderConstant = drawCommand.vertexShaderConstants[i];
+                    uint32_t vertexShaderConstantSize;
+                    const float* vertexShaderConstant = getShaderConstant(drawCommand.vertexShaderConstantStart + i, vertexShaderConstantSize);
 
-                    if (sizeof(float) * vertexShaderConstant.size() != vertexShaderConstantLocation.size)
+                    if (sizeof(float) * vertexShaderConstantSize != vertexShaderConstantLocation.size)
                     {
                         Log(Log::Level::ERR) << "Invalid vertex shader constant size";
                         return false;
                     }
 
-                    shaderData.insert(shaderData.end(), vertexShaderConstant.begin(), vertexShaderConstant.end());
+                    shaderData.insert(shaderData.end(), vertexShaderConstant, vertexShaderConstant + vertexShaderConstantSize);
                 }
 
                 shaderConstantBuffer.offset = ((shaderConstantBuffer.offset + shaderMetal->getVertexShaderAlignment() - 1) /
@@ -684,12 +685,7 @@ namespace ouzel
 
                 for (uint32_t layer = 0; layer < Texture::LAYERS; ++layer)
                 {
-                    TextureResourceMetal* textureMetal = nullptr;
-
-                    if (drawCommand.textures.size() > layer)
-                    {
-                        textureMetal = static_cast<TextureResourceMetal*>(drawCommand.textures[layer]);
-                    }
+                    TextureResourceMetal* textureMetal = static_cast<TextureResourceMetal*>(drawCommand.textures[layer]);
 
                     if (textureMetal)
                     {
@@ -728,7 +724,20 @@ namespace ouzel
                     continue;
                 }
 
-                [currentRenderCommandEncoder setVertexBuffer:vertexBufferMetal->getBuffer() offset:0 atIndex:0];
+                [currentRenderCommandEncoder setVertexBuffer:vertexBufferMetal->getBuffer() offset:vertexBufferMetal->getOffset() atIndex:0];
+
+                BufferResourceMetal* instanceBufferMetal = static_cast<BufferResourceMetal*>(drawCommand.instanceBuffer);
+
+                if (instanceBufferMetal)
+                {
+                    if (!instanceBufferMetal->getBuffer())
+                    {
+                        // don't render if invalid instance buffer
+                        continue;
+                    }
+
+                    [currentRenderCommandEncoder setVertexBuffer:instanceBufferMetal->getBuffer() offset:instanceBufferMetal->getOffset() atIndex:ShaderResourceMetal::INSTANCE_BUFFER_INDEX];
+                }
 
                 // draw
                 MTLPrimitiveType primitiveType;
@@ -750,11 +759,23 @@ namespace ouzel
                     indexCount = (indexBufferMetal->getSize() / meshBufferMetal->getIndexSize()) - drawCommand.startIndex;
                 }
 
-                [currentRenderCommandEncoder drawIndexedPrimitives:primitiveType
-                                                        indexCount:indexCount
-                                                         indexType:meshBufferMetal->getIndexType()
-                                                       indexBuffer:indexBufferMetal->getBuffer()
-                                                 indexBufferOffset:drawCommand.startIndex * meshBufferMetal->getBytesPerIndex()];
+                if (instanceBufferMetal)
+                {
+                    [currentRenderCommandEncoder drawIndexedPrimitives:primitiveType
+                                                            indexCount:indexCount
+                                                             indexType:meshBufferMetal->getIndexType()
+                                                           indexBuffer:indexBufferMetal->getBuffer()
+                                                     indexBufferOffset:indexBufferMetal->getOffset() + drawCommand.startIndex * meshBufferMetal->getBytesPerIndex()
+                                                         instanceCount:drawCommand.instanceCount];
+                }
+                else
+                {
+                    [currentRenderCommandEncoder drawIndexedPrimitives:primitiveType
+                                                            indexCount:indexCount
+                                                             indexType:meshBufferMetal->getIndexType()
+                                                           indexBuffer:indexBufferMetal->getBuffer()
+                                                     indexBufferOffset:indexBufferMetal->getOffset() + drawCommand.startIndex * meshBufferMetal->getBytesPerIndex()];
+                }
             }
 
             if (currentRenderCommandEncoder)
@@ -807,46 +828,36 @@ namespace ouzel
 
         BlendStateResource* RenderDeviceMetal::createBlendState()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             BlendStateResource* blendState = new BlendStateResourceMetal();
-            resources.push_back(std::unique_ptr<RenderResource>(blendState));
+            addResource(blendState);
             return blendState;
         }
 
         TextureResource* RenderDeviceMetal::createTexture()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             TextureResource* texture = new TextureResourceMetal(this);
-            resources.push_back(std::unique_ptr<RenderResource>(texture));
+            addResource(texture);
             return texture;
         }
 
         ShaderResource* RenderDeviceMetal::createShader()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             ShaderResource* shader = new ShaderResourceMetal(this);
-            resources.push_back(std::unique_ptr<RenderResource>(shader));
+            addResource(shader);
             return shader;
         }
 
         MeshBufferResource* RenderDeviceMetal::createMeshBuffer()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             MeshBufferResource* meshBuffer = new MeshBufferResourceMetal();
-            resources.push_back(std::unique_ptr<RenderResource>(meshBuffer));
+            addResource(meshBuffer);
             return meshBuffer;
         }
 
         BufferResource* RenderDeviceMetal::createBuffer()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             BufferResource* buffer = new BufferResourceMetal(this);
-            resources.push_back(std::unique_ptr<RenderResource>(buffer));
+            addResource(buffer);
             return buffer;
         }
 
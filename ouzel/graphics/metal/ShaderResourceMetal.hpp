@@ -28,6 +28,9 @@ namespace ouzel
         class ShaderResourceMetal: public ShaderResource
         {
         public:
+            // buffer 0 holds the vertices and buffer 1 the vertex shader constants
+            static const uint32_t INSTANCE_BUFFER_INDEX = 2;
+
             ShaderResourceMetal(RenderDeviceMetal* aRenderDeviceMetal);
             virtual ~ShaderResourceMetal();
 
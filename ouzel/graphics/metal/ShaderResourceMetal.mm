@@ -125,6 +125,7 @@ namespace ouzel
 
             uint32_t index = 0;
             NSUInteger offset = 0;
+            NSUInteger instanceOffset = 0;
 
             vertexDescriptor = [MTLVertexDescriptor new];
 
@@ -139,16 +140,34 @@ namespace ouzel
                 }
 
                 vertexDescriptor.attributes[index].format = vertexFormat;
-                vertexDescriptor.attributes[index].offset = offset;
-                vertexDescriptor.attributes[index].bufferIndex = 0;
+
+                if (vertexAttribute.isPerInstance())
+                {
+                    vertexDescriptor.attributes[index].offset = instanceOffset;
+                    vertexDescriptor.attributes[index].bufferIndex = INSTANCE_BUFFER_INDEX;
+                    instanceOffset += getDataTypeSize(vertexAttribute.dataType);
+                }
+                else
+                {
+                    vertexDescriptor.attributes[index].offset = offset;
+                    vertexDescriptor.attributes[index].bufferIndex = 0;
+                    offset += getDataTypeSize(vertexAttribute.dataType);
+                }
+
                 ++index;
-                offset += getDataTypeSize(vertexAttribute.dataType);
             }
 
             vertexDescriptor.layouts[0].stride = offset;
             vertexDescriptor.layouts[0].stepRate = 1;
             vertexDescriptor.layouts[0].stepFunction = MTLVertexStepFunctionPerVertex;
 
+            if (instanceOffset > 0)
+            {
+                vertexDescriptor.layouts[INSTANCE_BUFFER_INDEX].stride = instanceOffset;
+                vertexDescriptor.layouts[INSTANCE_BUFFER_INDEX].stepRate = 1;
+                vertexDescriptor.layouts[INSTANCE_BUFFER_INDEX].stepFunction = MTLVertexStepFunctionPerInstance;
+            }
+
             NSError* err;
 
             dispatch_data_t pixelShaderDispatchData = dispatch_data_create(pixelShaderData.data(), pixelShaderData.size(), nullptr, DISPATCH_DATA_DESTRUCTOR_DEFAULT);
@@ -244,6 +244,36 @@ namespace ouzel
             return true;
         }
 
+        bool TextureResourceMetal::setRegionData(const std::vector<uint8_t>& newData, const Rectangle& region)
+        {
+            if (!TextureResource::setRegionData(newData, region))
+            {
+                return false;
+            }
+
+            if (!texture)
+            {
+                Log(Log::Level::ERR) << "Texture not initialized";
+                return false;
+            }
+
+            uint32_t pixelSize = getPixelSize(pixelFormat);
+
+            for (size_t level = 0; level < levels.size(); ++level)
+            {
+                uint32_t x, y, regionWidth, regionHeight;
+                getLevelRegion(static_cast<uint32_t>(level), region, x, y, regionWidth, regionHeight);
+
+                if (regionWidth == 0 || regionHeight == 0) continue;
+
+                [texture replaceRegion:MTLRegionMake2D(x, y, regionWidth, regionHeight)
+                           mipmapLevel:level withBytes:levels[level].data.data() + y * levels[level].pitch + x * pixelSize
+                           bytesPerRow:static_cast<NSUInteger>(levels[level].pitch)];
+            }
+
+            return true;
+        }
+
         bool TextureResourceMetal::setFilter(Texture::Filter newFilter)
         {
             if (!TextureResource::setFilter(newFilter))
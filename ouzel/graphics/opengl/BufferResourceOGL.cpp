@@ -129,9 +129,9 @@ namespace ouzel
             return true;
         }
 
-        bool BufferResourceOGL::setData(const std::vector<uint8_t>& newData)
+        bool BufferResourceOGL::setData(const void* newData, uint32_t newSize)
         {
-            if (!BufferResource::setData(newData))
+            if (!BufferResource::setData(newData, newSize))
             {
                 return false;
             }
@@ -166,6 +166,12 @@ namespace ouzel
                 }
                 else
                 {
+                    if (flags & Buffer::DYNAMIC)
+                    {
+                        // orphan the storage, so that the driver gives a new one instead of waiting for the frames that still read the old one
+                        glBufferDataProc(bufferType, bufferSize, nullptr, GL_DYNAMIC_DRAW);
+                    }
+
                     glBufferSubDataProc(bufferType, 0, static_cast<GLsizeiptr>(data.size()), data.data());
 
                     if (RenderDeviceOGL::checkOpenGLError())
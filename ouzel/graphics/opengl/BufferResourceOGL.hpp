@@ -40,7 +40,7 @@ namespace ouzel
 
             virtual bool reload() override;
 
-            virtual bool setData(const std::vector<uint8_t>& newData) override;
+            virtual bool setData(const void* newData, uint32_t newSize) override;
 
             GLuint getBufferId() const { return bufferId; }
             GLuint getBufferType() const { return bufferType; }
@@ -14,7 +14,7 @@ namespace ouzel
 {
     namespace graphics
     {
-        static GLenum getVertexFormat(DataType dataType)
+        GLenum MeshBufferResourceOGL::getVertexFormat(DataType dataType)
         {
             switch (dataType)
             {
@@ -65,7 +65,7 @@ namespace ouzel
             }
         }
 
-        static GLint getArraySize(DataType dataType)
+        GLint MeshBufferResourceOGL::getArraySize(DataType dataType)
         {
             switch (dataType)
             {
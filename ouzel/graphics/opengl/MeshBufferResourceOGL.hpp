@@ -36,6 +36,9 @@ namespace ouzel
             MeshBufferResourceOGL(RenderDeviceOGL* aRenderDeviceOGL);
             virtual ~MeshBufferResourceOGL();
 
+            static GLenum getVertexFormat(DataType dataType);
+            static GLint getArraySize(DataType dataType);
+
             virtual bool init(uint32_t newIndexSize, BufferResource* newIndexBuffer,
                               const std::vector<VertexAttribute>& newVertexAttributes, BufferResource* newVertexBuffer) override;
 
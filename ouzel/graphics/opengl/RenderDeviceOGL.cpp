@@ -51,23 +51,28 @@
 #include "ColorVSGLES2.h"
 #include "TexturePSGLES2.h"
 #include "TextureVSGLES2.h"
+#include "DistanceFieldPSGLES2.h"
 #include "ColorPSGLES3.h"
 #include "ColorVSGLES3.h"
 #include "TexturePSGLES3.h"
 #include "TextureVSGLES3.h"
+#include "DistanceFieldPSGLES3.h"
 #else
 #include "ColorPSGL2.h"
 #include "ColorVSGL2.h"
 #include "TexturePSGL2.h"
 #include "TextureVSGL2.h"
+#include "DistanceFieldPSGL2.h"
 #include "ColorPSGL3.h"
 #include "ColorVSGL3.h"
 #include "TexturePSGL3.h"
 #include "TextureVSGL3.h"
+#include "DistanceFieldPSGL3.h"
 #include "ColorPSGL4.h"
 #include "ColorVSGL4.h"
 #include "TexturePSGL4.h"
 #include "TextureVSGL4.h"
+#include "DistanceFieldPSGL4.h"
 #endif
 
 PFNGLBLENDFUNCSEPARATEPROC glBlendFuncSeparateProc;
@@ -137,6 +142,14 @@ PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArrayProc;
 PFNGLDISABLEVERTEXATTRIBARRAYPROC glDisableVertexAttribArrayProc;
 PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointerProc;
 
+#if OUZEL_SUPPORTS_OPENGLES
+PFNGLVERTEXATTRIBDIVISOREXTPROC glVertexAttribDivisorProc;
+PFNGLDRAWELEMENTSINSTANCEDEXTPROC glDrawElementsInstancedProc;
+#else
+PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisorProc;
+PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstancedProc;
+#endif
+
 PFNGLGETSTRINGIPROC glGetStringiProc;
 
 #if OUZEL_SUPPORTS_OPENGLES
@@ -170,8 +183,7 @@ namespace ouzel
 
         RenderDeviceOGL::~RenderDeviceOGL()
         {
-            resourceDeleteSet.clear();
-            resources.clear();
+            releaseResources();
         }
 
         bool RenderDeviceOGL::init(Window* newWindow,
@@ -402,6 +414,8 @@ namespace ouzel
                 glMapBufferProc = glMapBufferOES;
                 glUnmapBufferProc = glUnmapBufferOES;
                 glMapBufferRangeProc = glMapBufferRangeEXT;
+                glVertexAttribDivisorProc = glVertexAttribDivisorEXT;
+                glDrawElementsInstancedProc = glDrawElementsInstancedEXT;
 
                 glRenderbufferStorageMultisampleProc = glRenderbufferStorageMultisampleAPPLE;
 #else
@@ -429,6 +443,13 @@ namespace ouzel
                 glUnmapBufferProc = reinterpret_cast<PFNGLUNMAPBUFFERPROC>(getProcAddress("glUnmapBuffer"));
                 glMapBufferRangeProc = reinterpret_cast<PFNGLMAPBUFFERRANGEPROC>(getProcAddress("glMapBufferRange"));
                 glRenderbufferStorageMultisampleProc = reinterpret_cast<PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC>(getProcAddress("glRenderbufferStorageMultisample"));
+    #if OUZEL_SUPPORTS_OPENGLES
+                glVertexAttribDivisorProc = reinterpret_cast<PFNGLVERTEXATTRIBDIVISOREXTPROC>(getProcAddress("glVertexAttribDivisor"));
+                glDrawElementsInstancedProc = reinterpret_cast<PFNGLDRAWELEMENTSINSTANCEDEXTPROC>(getProcAddress("glDrawElementsInstanced"));
+    #else
+                glVertexAttribDivisorProc = reinterpret_cast<PFNGLVERTEXATTRIBDIVISORPROC>(getProcAddress("glVertexAttribDivisor"));
+                glDrawElementsInstancedProc = reinterpret_cast<PFNGLDRAWELEMENTSINSTANCEDPROC>(getProcAddress("glDrawElementsInstanced"));
+    #endif
 
     #if OUZEL_SUPPORTS_OPENGLES
                 glFramebufferTexture2DMultisampleProc = reinterpret_cast<PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC>(getProcAddress("glFramebufferTexture2DMultisample"));
@@ -443,6 +464,7 @@ namespace ouzel
 #if OUZEL_SUPPORTS_OPENGLES
                 textureBaseLevelSupported = false;
                 textureMaxLevelSupported = false;
+                standardDerivativesSupported = false;
 #else
                 renderTargetsSupported = false;
 #endif
@@ -458,6 +480,10 @@ namespace ouzel
                     {
                         npotTexturesSupported = true;
                     }
+                    else if (extension == "GL_OES_standard_derivatives")
+                    {
+                        standardDerivativesSupported = true;
+                    }
 #if !OUZEL_SUPPORTS_OPENGLES
                     else if (extension == "GL_EXT_framebuffer_object")
                     {
@@ -488,12 +514,25 @@ namespace ouzel
                     {
                         glMapBufferRangeProc = reinterpret_cast<PFNGLMAPBUFFERRANGEPROC>(getProcAddress("glMapBufferRangeEXT"));
                     }
+                    else if (extension == "GL_ARB_instanced_arrays")
+                    {
+                        glVertexAttribDivisorProc = reinterpret_cast<PFNGLVERTEXATTRIBDIVISORPROC>(getProcAddress("glVertexAttribDivisorARB"));
+                    }
+                    else if (extension == "GL_ARB_draw_instanced")
+                    {
+                        glDrawElementsInstancedProc = reinterpret_cast<PFNGLDRAWELEMENTSINSTANCEDPROC>(getProcAddress("glDrawElementsInstancedARB"));
+                    }
 #elif OUZEL_OPENGL_INTERFACE_EAGL
                     else if (extension == "GL_APPLE_framebuffer_multisample")
                     {
                         multisamplingSupported = true;
                         glRenderbufferStorageMultisampleProc = glRenderbufferStorageMultisampleAPPLE;
                     }
+                    else if (extension == "GL_EXT_instanced_arrays")
+                    {
+                        glVertexAttribDivisorProc = glVertexAttribDivisorEXT;
+                        glDrawElementsInstancedProc = glDrawElementsInstancedEXT;
+                    }
 #elif OUZEL_OPENGL_INTERFACE_EGL
                     else if (extension == "GL_OES_vertex_array_object")
                     {
@@ -520,6 +559,16 @@ namespace ouzel
                     {
                         textureMaxLevelSupported = true;
                     }
+                    else if (extension == "GL_EXT_instanced_arrays")
+                    {
+                        glVertexAttribDivisorProc = reinterpret_cast<PFNGLVERTEXATTRIBDIVISOREXTPROC>(getProcAddress("glVertexAttribDivisorEXT"));
+                        glDrawElementsInstancedProc = reinterpret_cast<PFNGLDRAWELEMENTSINSTANCEDEXTPROC>(getProcAddress("glDrawElementsInstancedEXT"));
+                    }
+                    else if (extension == "GL_ANGLE_instanced_arrays")
+                    {
+                        glVertexAttribDivisorProc = reinterpret_cast<PFNGLVERTEXATTRIBDIVISOREXTPROC>(getProcAddress("glVertexAttribDivisorANGLE"));
+                        glDrawElementsInstancedProc = reinterpret_cast<PFNGLDRAWELEMENTSINSTANCEDEXTPROC>(getProcAddress("glDrawElementsInstancedANGLE"));
+                    }
 #endif // OUZEL_OPENGL_INTERFACE_EGL
                 }
 
@@ -529,6 +578,8 @@ namespace ouzel
                 }
             }
 
+            instancingSupported = glVertexAttribDivisorProc && glDrawElementsInstancedProc;
+
             std::shared_ptr<Shader> textureShader = std::make_shared<Shader>();
 
             switch (apiMajorVersion)
@@ -578,6 +629,64 @@ namespace ouzel
 
             sharedEngine->getCache()->setShader(SHADER_TEXTURE, textureShader);
 
+            std::shared_ptr<Shader> distanceFieldShader = std::make_shared<Shader>();
+
+            switch (apiMajorVersion)
+            {
+#if OUZEL_SUPPORTS_OPENGLES
+                case 2:
+                    // the edge smoothing of the shader needs dFdx and dFdy
+                    if (standardDerivativesSupported)
+                    {
+                        distanceFieldShader->init(std::vector<uint8_t>(std::begin(DistanceFieldPSGLES2_glsl), std::end(DistanceFieldPSGLES2_glsl)),
+                                                  std::vector<uint8_t>(std::begin(TextureVSGLES2_glsl), std::end(TextureVSGLES2_glsl)),
+                                                  VertexPCT::ATTRIBUTES,
+                                                  {{"color", DataType::FLOAT_VECTOR4}},
+                                                  {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+                    }
+                    else
+                    {
+                        Log(Log::Level::WARN) << "GL_OES_standard_derivatives not supported, distance field shader disabled";
+                        distanceFieldShader.reset();
+                    }
+                    break;
+                case 3:
+                    distanceFieldShader->init(std::vector<uint8_t>(std::begin(DistanceFieldPSGLES3_glsl), std::end(DistanceFieldPSGLES3_glsl)),
+                                              std::vector<uint8_t>(std::begin(TextureVSGLES3_glsl), std::end(TextureVSGLES3_glsl)),
+                                              VertexPCT::ATTRIBUTES,
+                                              {{"color", DataType::FLOAT_VECTOR4}},
+                                              {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+                    break;
+#else
+                case 2:
+                    distanceFieldShader->init(std::vector<uint8_t>(std::begin(DistanceFieldPSGL2_glsl), std::end(DistanceFieldPSGL2_glsl)),
+                                              std::vector<uint8_t>(std::begin(TextureVSGL2_glsl), std::end(TextureVSGL2_glsl)),
+                                              VertexPCT::ATTRIBUTES,
+                                              {{"color", DataType::FLOAT_VECTOR4}},
+                                              {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+                    break;
+                case 3:
+                    distanceFieldShader->init(std::vector<uint8_t>(std::begin(DistanceFieldPSGL3_glsl), std::end(DistanceFieldPSGL3_glsl)),
+                                              std::vector<uint8_t>(std::begin(TextureVSGL3_glsl), std::end(TextureVSGL3_glsl)),
+                                              VertexPCT::ATTRIBUTES,
+                                              {{"color", DataType::FLOAT_VECTOR4}},
+                                              {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+                    break;
+                case 4:
+                    distanceFieldShader->init(std::vector<uint8_t>(std::begin(DistanceFieldPSGL4_glsl), std::end(DistanceFieldPSGL4_glsl)),
+                                              std::vector<uint8_t>(std::begin(TextureVSGL4_glsl), std::end(TextureVSGL4_glsl)),
+                                              VertexPCT::ATTRIBUTES,
+                                              {{"color", DataType::FLOAT_VECTOR4}},
+                                              {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+                    break;
+#endif
+                default:
+                    Log(Log::Level::ERR) << "Unsupported OpenGL version";
+                    return false;
+            }
+
+            if (distanceFieldShader) sharedEngine->getCache()->setShader(SHADER_DISTANCE_FIELD, distanceFieldShader);
+
             std::shared_ptr<Shader> colorShader = std::make_shared<Shader>();
 
             switch (apiMajorVersion)
@@ -809,12 +918,7 @@ namespace ouzel
 
                 for (uint32_t layer = 0; layer < Texture::LAYERS; ++layer)
                 {
-                    TextureResourceOGL* textureOGL = nullptr;
-
-                    if (drawCommand.textures.size() > layer)
-                    {
-                        textureOGL = static_cast<TextureResourceOGL*>(drawCommand.textures[layer]);
-                    }
+                    TextureResourceOGL* textureOGL = static_cast<TextureResourceOGL*>(drawCommand.textures[layer]);
 
                     if (textureOGL)
                     {
@@ -857,48 +961,48 @@ namespace ouzel
                 // pixel shader constants
                 const std::vector<ShaderResourceOGL::Location>& pixelShaderConstantLocations = shaderOGL->getPixelShaderConstantLocations();
 
-                if (drawCommand.pixelShaderConstants.size() > pixelShaderConstantLocations.size())
+                if (drawCommand.pixelShaderConstantCount > pixelShaderConstantLocations.size())
                 {
                     Log(Log::Level::ERR) << "Invalid pixel shader constant size";
                     return false;
                 }
 
-                for (size_t i = 0; i < drawCommand.pixelShaderConstants.size(); ++i)
+                for (uint32_t i = 0; i < drawCommand.pixelShaderConstantCount; ++i)
                 {
                     const ShaderResourceOGL::Location& pixelShaderConstantLocation = pixelShaderConstantLocations[i];
-                    const std::vector<float>& pixelShaderConstant = drawCommand.pixelShaderConstants[i];
+                    const float* pixelShaderConstant = getShaderConstant(drawCommand.pixelShaderConstantStart + i);
 
                     switch (pixelShaderConstantLocation.dataType)
                     {
                         case DataType::INTEGER:
-                            glUniform1ivProc(pixelShaderConstantLocation.location, 1, reinterpret_cast<const GLint*>(pixelShaderConstant.data()));
+                            glUniform1ivProc(pixelShaderConstantLocation.location, 1, reinterpret_cast<const GLint*>(pixelShaderConstant));
                             break;
                         case DataType::INTEGER_VECTOR2:
-                            glUniform2ivProc(pixelShaderConstantLocation.location, 1, reinterpret_cast<const GLint*>(pixelShaderConstant.data()));
+                            glUniform2ivProc(pixelShaderConstantLocation.location, 1, reinterpret_cast<const GLint*>(pixelShaderConstant));
                             break;
                         case DataType::INTEGER_VECTOR3:
-                            glUniform3ivProc(pixelShaderConstantLocation.location, 1, reinterpret_cast<const GLint*>(pixelShaderConstant.data()));
+                            glUniform3ivProc(pixelShaderConstantLocation.location, 1, reinterpret_cast<const GLint*>(pixelShaderConstant));
                             break;
                         case DataType::INTEGER_VECTOR4:
-                            glUniform4ivProc(pixelShaderConstantLocation.location, 1, reinterpret_cast<const GLint*>(pixelShaderConstant.data()));
+                            glUniform4ivProc(pixelShaderConstantLocation.location, 1, reinterpret_cast<const GLint*>(pixelShaderConstant));
                             break;
                         case DataType::FLOAT:
-                            glUniform1fvProc(pixelShaderConstantLocation.location, 1, pixelShaderConstant.data());
+                            glUniform1fvProc(pixelShaderConstantLocation.location, 1, pixelShaderConstant);
                             break;
                         case DataType::FLOAT_VECTOR2:
-                            glUniform2fvProc(pixelShaderConstantLocation.location, 1, pixelShaderConstant.data());
+                            glUniform2fvProc(pixelShaderConstantLocation.location, 1, pixelShaderConstant);
                             break;
                         case DataType::FLOAT_VECTOR3:
-                            glUniform3fvProc(pixelShaderConstantLocation.location, 1, pixelShaderConstant.data());
+                            glUniform3fvProc(pixelShaderConstantLocation.location, 1, pixelShaderConstant);
                             break;
                         case DataType::FLOAT_VECTOR4:
-                            glUniform4fvProc(pixelShaderConstantLocation.location, 1, pixelShaderConstant.data());
+                            glUniform4fvProc(pixelShaderConstantLocation.location, 1, pixelShaderConstant);
                             break;
                         case DataType::FLOAT_MATRIX3:
-                            glUniformMatrix3fvProc(pixelShaderConstantLocation.location, 1, GL_FALSE, pixelShaderConstant.data());
+                            glUniformMatrix3fvProc(pixelShaderConstantLocation.location, 1, GL_FALSE, pixelShaderConstant);
                             break;
                         case DataType::FLOAT_MATRIX4:
-                            glUniformMatrix4fvProc(pixelShaderConstantLocation.location, 1, GL_FALSE, pixelShaderConstant.data());
+                            glUniformMatrix4fvProc(pixelShaderConstantLocation.location, 1, GL_FALSE, pixelShaderConstant);
                             break;
                         default:
                             Log(Log::Level::ERR) << "Unsupported uniform size";
@@ -909,48 +1013,48 @@ namespace ouzel
                 // vertex shader constants
                 const std::vector<ShaderResourceOGL::Location>& vertexShaderConstantLocations = shaderOGL->getVertexShaderConstantLocations();
 
-                if (drawCommand.vertexShaderConstants.size() > vertexShaderConstantLocations.size())
+                if (drawCommand.vertexShaderConstantCount > vertexShaderConstantLocations.size())
                 {
                     Log(Log::Level::ERR) << "Invalid vertex shader constant size";
                     return false;
                 }
 
-                for (size_t i = 0; i < drawCommand.vertexShaderConstants.size(); ++i)
+                for (uint32_t i = 0; i < drawCommand.vertexShaderConstantCount; ++i)
                 {
                     const ShaderResourceOGL::Location& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
-                    const std::vector<float>& vertexShaderConstant = drawCommand.vertexShaderConstants[i];
+                    const float* vertexShaderConstant = getShaderConstant(drawCommand.vertexShaderConstantStart + i);
 
                     switch (vertexShaderConstantLocation.dataType)
                     {
                         case DataType::INTEGER:
-                            glUniform1ivProc(vertexShaderConstantLocation.location, 1, reinterpret_cast<const GLint*>(vertexShaderConstant.data()));
+                            glUniform1ivProc(vertexShaderConstantLocation.location, 1, reinterpret_cast<const GLint*>(vertexShaderConstant));
                             break;
                         case DataType::INTEGER_VECTOR2:
-                            glUniform2ivProc(vertexShaderConstantLocation.location, 1, reinterpret_cast<const GLint*>(vertexShaderConstant.data()));
+                            glUniform2ivProc(vertexShaderConstantLocation.location, 1, reinterpret_cast<const GLint*>(vertexShaderConstant));
                             break;
                         case DataType::INTEGER_VECTOR3:
-                            glUniform3ivProc(vertexShaderConstantLocation.location, 1, reinterpret_cast<const GLint*>(vertexShaderConstant.data()));
+                            glUniform3ivProc(vertexShaderConstantLocation.location, 1, reinterpret_cast<const GLint*>(vertexShaderConstant));
                             break;
                         case DataType::INTEGER_VECTOR4:
-                            glUniform4ivProc(vertexShaderConstantLocation.location, 1, reinterpret_cast<const GLint*>(vertexShaderConstant.data()));
+                            glUniform4ivProc(vertexShaderConstantLocation.location, 1, reinterpret_cast<const GLint*>(vertexShaderConstant));
                             break;
                         case DataType::FLOAT:
-                            glUniform1fvProc(vertexShaderConstantLocation.location, 1, vertexShaderConstant.data());
+                            glUniform1fvProc(vertexShaderConstantLocation.location, 1, vertexShaderConstant);
                             break;
                         case DataType::FLOAT_VECTOR2:
-                            glUniform2fvProc(vertexShaderConstantLocation.location, 1, vertexShaderConstant.data());
+                            glUniform2fvProc(vertexShaderConstantLocation.location, 1, vertexShaderConstant);
                             break;
                         case DataType::FLOAT_VECTOR3:
-                            glUniform3fvProc(vertexShaderConstantLocation.location, 1, vertexShaderConstant.data());
+                            glUniform3fvProc(vertexShaderConstantLocation.location, 1, vertexShaderConstant);
                             break;
                         case DataType::FLOAT_VECTOR4:
-                            glUniform4fvProc(vertexShaderConstantLocation.location, 1, vertexShaderConstant.data());
+                            glUniform4fvProc(vertexShaderConstantLocation.location, 1, vertexShaderConstant);
                             break;
                         case DataType::FLOAT_MATRIX3:
-                            glUniformMatrix3fvProc(vertexShaderConstantLocation.location, 1, GL_FALSE, vertexShaderConstant.data());
+                            glUniformMatrix3fvProc(vertexShaderConstantLocation.location, 1, GL_FALSE, vertexShaderConstant);
                             break;
                         case DataType::FLOAT_MATRIX4:
-                            glUniformMatrix4fvProc(vertexShaderConstantLocation.location, 1, GL_FALSE, vertexShaderConstant.data());
+                            glUniformMatrix4fvProc(vertexShaderConstantLocation.location, 1, GL_FALSE, vertexShaderConstant);
                             break;
                         default:
                             Log(Log::Level::ERR) << "Unsupported uniform size";
@@ -1084,10 +1188,55 @@ namespace ouzel
                     indexCount = (indexBufferOGL->getSize() / meshBufferOGL->getIndexSize()) - drawCommand.startIndex;
                 }
 
-                glDrawElements(mode,
-                               static_cast<GLsizei>(indexCount),
-                               meshBufferOGL->getIndexType(),
-                               static_cast<const char*>(nullptr) + (drawCommand.startIndex * meshBufferOGL->getBytesPerIndex()));
+                if (drawCommand.instanceBuffer)
+                {
+                    BufferResourceOGL* instanceBufferOGL = static_cast<BufferResourceOGL*>(drawCommand.instanceBuffer);
+
+                    if (!instanceBufferOGL->getBufferId())
+                    {
+                        // don't render if invalid instance buffer
+                        continue;
+                    }
+
+                    if (!bindBuffer(GL_ARRAY_BUFFER, instanceBufferOGL->getBufferId()))
+                    {
+                        return false;
+                    }
+
+                    const std::vector<ShaderResourceOGL::InstanceAttrib>& instanceAttribs = shaderOGL->getInstanceAttribs();
+
+                    for (const ShaderResourceOGL::InstanceAttrib& instanceAttrib : instanceAttribs)
+                    {
+                        glEnableVertexAttribArrayProc(instanceAttrib.location);
+                        glVertexAttribPointerProc(instanceAttrib.location,
+                                                  instanceAttrib.size,
+                                                  instanceAttrib.type,
+                                                  instanceAttrib.normalized,
+                                                  static_cast<GLsizei>(shaderOGL->getInstanceSize()),
+                                                  instanceAttrib.pointer);
+                        glVertexAttribDivisorProc(instanceAttrib.location, 1);
+                    }
+
+                    glDrawElementsInstancedProc(mode,
+                                                static_cast<GLsizei>(indexCount),
+                                                meshBufferOGL->getIndexType(),
+                                                static_cast<const char*>(nullptr) + (drawCommand.startIndex * meshBufferOGL->getBytesPerIndex()),
+                                                static_cast<GLsizei>(drawCommand.instanceCount));
+
+                    // restore the vertex array state, so that the mesh buffer can be drawn without instancing
+                    for (const ShaderResourceOGL::InstanceAttrib& instanceAttrib : instanceAttribs)
+                    {
+                        glVertexAttribDivisorProc(instanceAttrib.location, 0);
+                        glDisableVertexAttribArrayProc(instanceAttrib.location);
+                    }
+                }
+                else
+                {
+                    glDrawElements(mode,
+                                   static_cast<GLsizei>(indexCount),
+                                   meshBufferOGL->getIndexType(),
+                                   static_cast<const char*>(nullptr) + (drawCommand.startIndex * meshBufferOGL->getBytesPerIndex()));
+                }
 
                 if (checkOpenGLError())
                 {
@@ -1153,46 +1302,36 @@ namespace ouzel
 
         BlendStateResource* RenderDeviceOGL::createBlendState()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             BlendStateResource* blendState = new BlendStateResourceOGL();
-            resources.push_back(std::unique_ptr<RenderResource>(blendState));
+            addResource(blendState);
             return blendState;
         }
 
         TextureResource* RenderDeviceOGL::createTexture()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             TextureResource* texture = new TextureResourceOGL(this);
-            resources.push_back(std::unique_ptr<RenderResource>(texture));
+            addResource(texture);
             return texture;
         }
 
         ShaderResource* RenderDeviceOGL::createShader()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             ShaderResource* shader = new ShaderResourceOGL(this);
-            resources.push_back(std::unique_ptr<RenderResource>(shader));
+            addResource(shader);
             return shader;
         }
 
         MeshBufferResource* RenderDeviceOGL::createMeshBuffer()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             MeshBufferResource* meshBuffer = new MeshBufferResourceOGL(this);
-            resources.push_back(std::unique_ptr<RenderResource>(meshBuffer));
+            addResource(meshBuffer);
             return meshBuffer;
         }
 
         BufferResource* RenderDeviceOGL::createBuffer()
         {
-            std::lock_guard<std::mutex> lock(resourceMutex);
-
             BufferResource* buffer = new BufferResourceOGL(this);
-            resources.push_back(std::unique_ptr<RenderResource>(buffer));
+            addResource(buffer);
             return buffer;
         }
 
@@ -93,6 +93,14 @@ extern PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArrayProc;
 extern PFNGLDISABLEVERTEXATTRIBARRAYPROC glDisableVertexAttribArrayProc;
 extern PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointerProc;
 
+#if OUZEL_SUPPORTS_OPENGLES
+extern PFNGLVERTEXATTRIBDIVISOREXTPROC glVertexAttribDivisorProc;
+extern PFNGLDRAWELEMENTSINSTANCEDEXTPROC glDrawElementsInstancedProc;
+#else
+extern PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisorProc;
+extern PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstancedProc;
+#endif
+
 extern PFNGLGETSTRINGIPROC glGetStringiProc;
 
 #if OUZEL_SUPPORTS_OPENGLES
@@ -649,6 +657,7 @@ namespace ouzel
             GLfloat frameBufferClearColor[4];
             bool textureBaseLevelSupported = true;
             bool textureMaxLevelSupported = true;
+            bool standardDerivativesSupported = true;
 
             struct StateCache
             {
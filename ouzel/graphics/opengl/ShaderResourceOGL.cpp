@@ -7,6 +7,7 @@
 
 #include "ShaderResourceOGL.hpp"
 #include "RenderDeviceOGL.hpp"
+#include "MeshBufferResourceOGL.hpp"
 #include "utils/Log.hpp"
 
 namespace ouzel
@@ -189,6 +190,18 @@ namespace ouzel
                     case VertexAttribute::Usage::TEXTURE_COORDINATES:
                         name = "texCoord" + std::to_string(vertexAttribute.index);
                         break;
+                    case VertexAttribute::Usage::INSTANCE_POSITION:
+                        name = "instancePosition" + std::to_string(vertexAttribute.index);
+                        break;
+                    case VertexAttribute::Usage::INSTANCE_COLOR:
+                        name = "instanceColor" + std::to_string(vertexAttribute.index);
+                        break;
+                    case VertexAttribute::Usage::INSTANCE_TRANSFORM:
+                        name = "instanceTransform" + std::to_string(vertexAttribute.index);
+                        break;
+                    case VertexAttribute::Usage::INSTANCE_DATA:
+                        name = "instanceData" + std::to_string(vertexAttribute.index);
+                        break;
                     default:
                         Log(Log::Level::ERR) << "Invalid vertex attribute usage";
                         return false;
@@ -198,6 +211,28 @@ namespace ouzel
                 ++index;
             }
 
+            instanceAttribs.clear();
+
+            GLuint instanceOffset = 0;
+            GLuint location = 0;
+
+            for (const VertexAttribute& vertexAttribute : vertexAttributes)
+            {
+                if (vertexAttribute.isPerInstance())
+                {
+                    instanceAttribs.push_back({
+                        location,
+                        MeshBufferResourceOGL::getArraySize(vertexAttribute.dataType),
+                        MeshBufferResourceOGL::getVertexFormat(vertexAttribute.dataType),
+                        vertexAttribute.normalized ? static_cast<GLboolean>(GL_TRUE) : static_cast<GLboolean>(GL_FALSE),
+                        static_cast<const GLchar*>(nullptr) + instanceOffset
+                    });
+                    instanceOffset += getDataTypeSize(vertexAttribute.dataType);
+                }
+
+                ++location;
+            }
+
             glLinkProgramProc(programId);
 
             glGetProgramivProc(programId, GL_LINK_STATUS, &status);
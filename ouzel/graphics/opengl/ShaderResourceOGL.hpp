@@ -56,6 +56,17 @@ namespace ouzel
 
             GLuint getProgramId() const { return programId; }
 
+            struct InstanceAttrib
+            {
+                GLuint location;
+                GLint size;
+                GLenum type;
+                GLboolean normalized;
+                const GLvoid* pointer;
+            };
+
+            const std::vector<InstanceAttrib>& getInstanceAttribs() const { return instanceAttribs; }
+
         protected:
             bool compileShader();
             void printShaderMessage(GLuint shaderId);
@@ -69,6 +80,8 @@ namespace ouzel
 
             std::vector<Location> pixelShaderConstantLocations;
             std::vector<Location> vertexShaderConstantLocations;
+
+            std::vector<InstanceAttrib> instanceAttribs;
         };
     } // namespace graphics
 } // namespace ouzel
@@ -629,6 +629,58 @@ namespace ouzel
             return true;
         }
 
+        bool TextureResourceOGL::setRegionData(const std::vector<uint8_t>& newData, const Rectangle& region)
+        {
+            if (!TextureResource::setRegionData(newData, region))
+            {
+                return false;
+            }
+
+            if (!textureId)
+            {
+                Log(Log::Level::ERR) << "Texture not initialized";
+                return false;
+            }
+
+            renderDeviceOGL->bindTexture(textureId, 0);
+
+            uint32_t pixelSize = getPixelSize(pixelFormat);
+            std::vector<uint8_t> regionData;
+
+            for (uint32_t level = 0; level < static_cast<uint32_t>(levels.size()); ++level)
+            {
+                uint32_t x, y, regionWidth, regionHeight;
+                getLevelRegion(level, region, x, y, regionWidth, regionHeight);
+
+                if (regionWidth == 0 || regionHeight == 0) continue;
+
+                // rows are aligned to the default unpack alignment of 4 bytes
+                uint32_t rowSize = regionWidth * pixelSize;
+                uint32_t regionPitch = (rowSize + 3) & ~3U;
+                regionData.resize(regionPitch * regionHeight);
+
+                for (uint32_t row = 0; row < regionHeight; ++row)
+                {
+                    const uint8_t* source = levels[level].data.data() + (y + row) * levels[level].pitch + x * pixelSize;
+                    std::copy(source, source + rowSize, regionData.begin() + row * regionPitch);
+                }
+
+                glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(level),
+                                static_cast<GLint>(x), static_cast<GLint>(y),
+                                static_cast<GLsizei>(regionWidth), static_cast<GLsizei>(regionHeight),
+                                oglPixelFormat, oglPixelType,
+                                regionData.data());
+            }
+
+            if (RenderDeviceOGL::checkOpenGLError())
+            {
+                Log(Log::Level::ERR) << "Failed to upload texture data";
+                return false;
+            }
+
+            return true;
+        }
+
         bool TextureResourceOGL::setFilter(Texture::Filter newFilter)
         {
             if (!TextureResource::setFilter(newFilter))
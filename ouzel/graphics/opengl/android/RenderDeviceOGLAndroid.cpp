@@ -323,9 +323,9 @@ namespace ouzel
             {
                 std::lock_guard<std::mutex> lock(resourceMutex);
 
-                for (const std::unique_ptr<RenderResource>& resource : resources)
+                for (const ResourceSlot& resourceSlot : resourceSlots)
                 {
-                    if (!resource->reload())
+                    if (resourceSlot.resource && !resourceSlot.resource->reload())
                     {
                         return false;
                     }
@@ -233,6 +233,7 @@ namespace ouzel
                     else if (key == "scaleH") converter >> height;
                     else if (key == "pages") converter >> pages;
                     else if (key == "outline") converter >> outline;
+                    else if (key == "distanceField") converter >> distanceField;
                 }
             }
             else if (read == "char")
@@ -28,5 +28,18 @@ namespace ouzel
                                  std::vector<uint16_t>& indices,
                                  std::vector<graphics::VertexPCT>& vertices,
                                  std::shared_ptr<graphics::Texture>& texture) = 0;
+
+        // called every frame the text is drawn, so that its glyphs are kept in the font atlas
+        virtual void useGlyphs(const std::vector<uint32_t>&, float) {}
+
+        // changes when the previously returned vertices are not valid anymore
+        uint32_t getVersion() const { return version; }
+
+        // glyphs are stored as signed distance fields and must be drawn with the distance field shader
+        bool isDistanceField() const { return distanceField; }
+
+    protected:
+        uint32_t version = 0;
+        bool distanceField = false;
     };
 }
@@ -1,14 +1,23 @@
 // Copyright (C) 2017 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
+#include <set>
+#include <sstream>
 
 #define STB_TRUETYPE_IMPLEMENTATION
 #include "TTFont.hpp"
 #include "core/Engine.hpp"
+#include "core/Cache.hpp"
 #include "files/FileSystem.hpp"
+#include "graphics/Renderer.hpp"
+#include "graphics/RenderDevice.hpp"
+#include "math/MathUtils.hpp"
 #include "utils/Log.hpp"
 #include "utils/Utils.hpp"
+#include "stb_image_write.h"
 
 namespace ouzel
 {
@@ -17,15 +26,36 @@ namespace ouzel
     {
     }
 
-    TTFont::TTFont(const std::string& filename, bool aMipmaps):
+    TTFont::TTFont(const std::string& filename, bool aMipmaps, bool aDistanceField):
         mipmaps(aMipmaps)
     {
+        // glyphs are rendered as bitmaps on render devices that do not have the distance field shader
+        if (aDistanceField && !sharedEngine->getCache()->getShader(graphics::SHADER_DISTANCE_FIELD))
+        {
+            Log(Log::Level::WARN) << "Distance field shader not available, using bitmap glyphs for " << filename;
+        }
+        else
+        {
+            distanceField = aDistanceField;
+        }
+
         if (!parseFont(filename))
         {
             Log(Log::Level::ERR) << "Failed to parse font " << filename;
         }
     }
 
+    static const uint16_t ATLAS_SIZE = 512;
+    static const uint16_t MAX_ATLAS_SIZE = 4096;
+    static const uint16_t SPACING = 2;
+    // the least recently used atlases are released when the atlases of all the font sizes take more
+    static const uint32_t MAX_ATLAS_MEMORY = 64 * 1024 * 1024;
+
+    // distance field glyphs are rendered once at this size and scaled to any font size
+    static const float DISTANCE_FIELD_SIZE = 32.0f;
+    static const float DISTANCE_FIELD_SPREAD = 4.0f;
+    static const uint32_t DISTANCE_FIELD_SUPERSAMPLING = 4;
+
     void TTFont::getVertices(const std::string& text,
                              const Color& color,
                              float fontSize,
@@ -34,180 +64,712 @@ namespace ouzel
                              std::vector<graphics::VertexPCT>& vertices,
                              std::shared_ptr<graphics::Texture>& texture)
     {
-        static const uint32_t SPACING = 2;
+        // glyphs used in the frame that is being filled are not evicted, the earlier draw commands of the frame still point to them
+        currentFrame = sharedEngine->getRenderer()->getDevice()->getFillFrame();
+
+        // text is laid out at the size of the distance field and scaled afterwards
+        float layoutSize = distanceField ? DISTANCE_FIELD_SIZE : fontSize;
+        float s = stbtt_ScaleForPixelHeight(&font, layoutSize);
+
+        Atlas& atlas = getAtlas(layoutSize);
+        texture = atlas.texture;
+
+        std::vector<uint32_t> utf32Text = utf8to32(text);
+
+        int ascent, descent, lineGap;
+        stbtt_GetFontVMetrics(&font,  &ascent, &descent, &lineGap);
+
+        Vector2 position;
+
+        indices.clear();
+        vertices.clear();
+
+        indices.reserve(utf32Text.size() * 6);
+        vertices.reserve(utf32Text.size() * 4);
+
+        Vector2 textCoords[4];
+
+        size_t firstChar = 0;
+
+        for (auto i = utf32Text.begin(); i != utf32Text.end(); ++i)
+        {
+            if (const Glyph* f = getGlyph(atlas, *i, s))
+            {
+                if (f->width > 0 && f->height > 0)
+                {
+                    uint16_t startIndex = static_cast<uint16_t>(vertices.size());
+                    indices.push_back(startIndex + 0);
+                    indices.push_back(startIndex + 1);
+                    indices.push_back(startIndex + 2);
+
+                    indices.push_back(startIndex + 1);
+                    indices.push_back(startIndex + 3);
+                    indices.push_back(startIndex + 2);
+
+                    Vector2 leftTop(f->x / static_cast<float>(atlas.width),
+                                    f->y / static_cast<float>(atlas.height));
+
+                    Vector2 rightBottom((f->x + f->width) / static_cast<float>(atlas.width),
+                                        (f->y + f->height) / static_cast<float>(atlas.height));
+
+                    textCoords[0] = Vector2(leftTop.x, rightBottom.y);
+                    textCoords[1] = Vector2(rightBottom.x, rightBottom.y);
+                    textCoords[2] = Vector2(leftTop.x, leftTop.y);
+                    textCoords[3] = Vector2(rightBottom.x, leftTop.y);
+
+                    vertices.push_back(graphics::VertexPCT(Vector3(position.x + f->offset.x, -position.y - f->offset.y - f->height, 0.0f),
+                                                           color, textCoords[0]));
+                    vertices.push_back(graphics::VertexPCT(Vector3(position.x + f->offset.x + f->width, -position.y - f->offset.y - f->height, 0.0f),
+                                                           color, textCoords[1]));
+                    vertices.push_back(graphics::VertexPCT(Vector3(position.x + f->offset.x, -position.y - f->offset.y, 0.0f),
+                                                           color, textCoords[2]));
+                    vertices.push_back(graphics::VertexPCT(Vector3(position.x + f->offset.x + f->width, -position.y - f->offset.y, 0.0f),
+                                                           color, textCoords[3]));
+                }
+
+                if ((i + 1) != utf32Text.end())
+                {
+                    int kernAdvance = stbtt_GetCodepointKernAdvance(&font,
+                                                                    static_cast<int>(*i),
+                                                                    static_cast<int>(*(i + 1)));
+                    position.x += static_cast<float>(kernAdvance) * s;
+                }
+
+                position.x += f->advance;
+            }
+
+            if (*i == static_cast<uint32_t>('\n') || // line feed
+                (i + 1) == utf32Text.end()) // end of string
+            {
+                float lineWidth = position.x;
+                position.x = 0.0f;
+                position.y += layoutSize + lineGap;
+
+                for (size_t c = firstChar; c < vertices.size(); ++c)
+                {
+                    vertices[c].position.x -= lineWidth * anchor.x;
+                }
+
+                firstChar = vertices.size();
+            }
+        }
+
+        float textHeight = position.y;
+        float layoutScale = fontSize / layoutSize;
+
+        for (size_t c = 0; c < vertices.size(); ++c)
+        {
+            vertices[c].position.y += textHeight * (1.0f - anchor.y);
+
+            vertices[c].position.x *= layoutScale;
+            vertices[c].position.y *= layoutScale;
+        }
+    }
+
+    void TTFont::useGlyphs(const std::vector<uint32_t>& characters, float fontSize)
+    {
+        currentFrame = sharedEngine->getRenderer()->getDevice()->getFillFrame();
+
+        auto atlasIterator = atlases.find(distanceField ? DISTANCE_FIELD_SIZE : fontSize);
+        if (atlasIterator == atlases.end()) return;
+
+        Atlas& atlas = atlasIterator->second;
+        atlas.lastUse = currentFrame;
+
+        for (uint32_t c : characters)
+        {
+            auto i = atlas.glyphs.find(c);
+            if (i != atlas.glyphs.end()) i->second.lastUse = currentFrame;
+        }
+    }
+
+    bool TTFont::bakeDistanceField(const std::string& filename, const std::string& characters)
+    {
+        float scale = stbtt_ScaleForPixelHeight(&font, DISTANCE_FIELD_SIZE);
+
+        std::vector<uint32_t> utf32Text = utf8to32(characters);
+        std::set<uint32_t> codepoints(utf32Text.begin(), utf32Text.end());
 
-        struct CharDescriptor
+        std::vector<std::pair<uint32_t, Glyph>> glyphs;
+        std::vector<std::vector<uint8_t>> bitmaps;
+
+        for (uint32_t c : codepoints)
         {
-            uint16_t x = 0, y = 0;
-            uint16_t width = 0;
-            uint16_t height = 0;
-            Vector2 offset;
-            float advance = 0;
+            Glyph glyph;
             std::vector<uint8_t> bitmap;
-        };
+            renderGlyph(c, scale, true, glyph, bitmap);
 
-        std::unordered_map<uint32_t, CharDescriptor> chars;
+            glyphs.push_back(std::make_pair(c, glyph));
+            bitmaps.push_back(bitmap);
+        }
 
-        float s = stbtt_ScaleForPixelHeight(&font, fontSize);
+        // the atlas grows until all the glyphs fit in it
+        Atlas atlas;
+        atlas.width = ATLAS_SIZE;
+        atlas.height = ATLAS_SIZE;
 
-        std::vector<uint32_t> utf32Text = utf8to32(text);
+        for (size_t i = 0; i < glyphs.size();)
+        {
+            Glyph& glyph = glyphs[i].second;
+
+            if (glyph.width == 0 || glyph.height == 0 ||
+                allocateGlyph(atlas, glyph.width, glyph.height, glyph))
+            {
+                ++i;
+            }
+            else if (atlas.width < MAX_ATLAS_SIZE)
+            {
+                atlas.width *= 2;
+                atlas.height *= 2;
+                atlas.shelves.clear();
+                i = 0;
+            }
+            else
+            {
+                Log(Log::Level::ERR) << "Glyphs do not fit in the distance field atlas";
+                return false;
+            }
+        }
+
+        std::vector<uint8_t> textureData(atlas.width * atlas.height * 4);
+
+        for (size_t pixel = 0; pixel < textureData.size(); pixel += 4)
+        {
+            textureData[pixel + 0] = 255;
+            textureData[pixel + 1] = 255;
+            textureData[pixel + 2] = 255;
+            textureData[pixel + 3] = 0;
+        }
+
+        for (size_t i = 0; i < glyphs.size(); ++i)
+        {
+            const Glyph& glyph = glyphs[i].second;
+
+            for (uint16_t posY = 0; posY < glyph.height; ++posY)
+            {
+                for (uint16_t posX = 0; posX < glyph.width; ++posX)
+                {
+                    textureData[((glyph.y + posY) * atlas.width + glyph.x + posX) * 4 + 3] = bitmaps[i][posY * glyph.width + posX];
+                }
+            }
+        }
+
+        std::string textureFilename = filename.substr(0, filename.rfind('.')) + ".png";
+
+        if (!stbi_write_png(textureFilename.c_str(), atlas.width, atlas.height, 4, textureData.data(), atlas.width * 4))
+        {
+            Log(Log::Level::ERR) << "Failed to save distance field atlas to " << textureFilename;
+            return false;
+        }
+
+        int ascent, descent, lineGap;
+        stbtt_GetFontVMetrics(&font,  &ascent, &descent, &lineGap);
+
+        std::stringstream stream;
+        stream << "info size=" << static_cast<int>(DISTANCE_FIELD_SIZE) << std::endl;
+        stream << "common lineHeight=" << static_cast<int>(roundf((ascent - descent + lineGap) * scale)) <<
+            " base=" << static_cast<int>(roundf(ascent * scale)) <<
+            " scaleW=" << atlas.width << " scaleH=" << atlas.height <<
+            " pages=1 distanceField=1" << std::endl;
+        stream << "page id=0 file=\"" << FileSystem::getFilenamePart(textureFilename) << "\"" << std::endl;
+        stream << "chars count=" << glyphs.size() << std::endl;
+
+        for (const auto& i : glyphs)
+        {
+            const Glyph& glyph = i.second;
+
+            stream << "char id=" << i.first <<
+                " x=" << glyph.x << " y=" << glyph.y <<
+                " width=" << glyph.width << " height=" << glyph.height <<
+                " xoffset=" << static_cast<int>(roundf(glyph.offset.x)) <<
+                " yoffset=" << static_cast<int>(roundf(glyph.offset.y)) <<
+                " xadvance=" << static_cast<int>(roundf(glyph.advance)) <<
+                " page=0" << std::endl;
+        }
+
+        std::vector<std::pair<std::pair<uint32_t, uint32_t>, int>> kernings;
+
+        for (uint32_t first : codepoints)
+        {
+            for (uint32_t second : codepoints)
+            {
+                int amount = static_cast<int>(roundf(stbtt_GetCodepointKernAdvance(&font,
+                                                                                   static_cast<int>(first),
+                                                                                   static_cast<int>(second)) * scale));
+                if (amount != 0)
+                {
+                    kernings.push_back(std::make_pair(std::make_pair(first, second), amount));
+                }
+            }
+        }
+
+        stream << "kernings count=" << kernings.size() << std::endl;
+
+        for (const auto& kerning : kernings)
+        {
+            stream << "kerning first=" << kerning.first.first <<
+                " second=" << kerning.first.second <<
+                " amount=" << kerning.second << std::endl;
+        }
+
+        std::string fontData = stream.str();
+
+        return sharedEngine->getFileSystem()->writeFile(filename, std::vector<uint8_t>(fontData.begin(), fontData.end()));
+    }
+
+    TTFont::Atlas& TTFont::getAtlas(float fontSize)
+    {
+        auto i = atlases.find(fontSize);
+
+        if (i != atlases.end())
+        {
+            i->second.lastUse = currentFrame;
+            return i->second;
+        }
+
+        // big fonts get a bigger atlas, so that several rows of glyphs fit in it
+        uint16_t atlasSize = ATLAS_SIZE;
+        while (atlasSize < fontSize * 8.0f && atlasSize < MAX_ATLAS_SIZE) atlasSize *= 2;
+
+        uint32_t textureMemory = atlasSize * atlasSize * 4;
+
+        while (atlasMemory + textureMemory > MAX_ATLAS_MEMORY && evictAtlas());
+
+        Atlas& atlas = atlases[fontSize];
+        atlas.width = atlasSize;
+        atlas.height = atlasSize;
+        atlas.lastUse = currentFrame;
+        atlasMemory += textureMemory;
+
+        std::vector<uint8_t> textureData(atlas.width * atlas.height * 4);
+
+        for (size_t pixel = 0; pixel < textureData.size(); pixel += 4)
+        {
+            textureData[pixel + 0] = 255;
+            textureData[pixel + 1] = 255;
+            textureData[pixel + 2] = 255;
+            textureData[pixel + 3] = 0;
+        }
+
+        atlas.texture = std::make_shared<graphics::Texture>();
+        atlas.texture->init(textureData, Size2(atlas.width, atlas.height), graphics::Texture::DYNAMIC, mipmaps ? 0 : 1);
+
+        return atlas;
+    }
+
+    const TTFont::Glyph* TTFont::getGlyph(Atlas& atlas, uint32_t c, float scale)
+    {
+        auto i = atlas.glyphs.find(c);
+
+        if (i != atlas.glyphs.end())
+        {
+            i->second.lastUse = currentFrame;
+            return &i->second;
+        }
+
+        Glyph glyph;
+        std::vector<uint8_t> bitmap;
+        renderGlyph(c, scale, distanceField, glyph, bitmap);
+        glyph.lastUse = currentFrame;
 
-        std::set<uint32_t> glyphs;
-        for (uint32_t i : utf32Text)
+        if (glyph.width > 0 && glyph.height > 0)
         {
-            glyphs.insert(i);
+            if (!allocateGlyph(atlas, glyph.width, glyph.height, glyph))
+            {
+                Log(Log::Level::ERR) << "Failed to add glyph " << c << " to the font atlas";
+                return nullptr;
+            }
+
+            // the whole slot is uploaded, so that the pixels of the evicted glyphs do not bleed into the new one
+            const Shelf& shelf = atlas.shelves[glyph.shelf];
+            uint16_t regionWidth = std::min(static_cast<uint16_t>(glyph.width + SPACING), static_cast<uint16_t>(atlas.width - glyph.x));
+            uint16_t regionHeight = shelf.height;
+
+            std::vector<uint8_t> regionData(regionWidth * regionHeight * 4);
+
+            for (uint16_t posY = 0; posY < regionHeight; ++posY)
+            {
+                for (uint16_t posX = 0; posX < regionWidth; ++posX)
+                {
+                    uint8_t* pixel = &regionData[(posY * regionWidth + posX) * 4];
+                    pixel[0] = 255;
+                    pixel[1] = 255;
+                    pixel[2] = 255;
+                    pixel[3] = (posX < glyph.width && posY < glyph.height) ? bitmap[posY * glyph.width + posX] : 0;
+                }
+            }
+
+            atlas.texture->setRegionData(regionData, Rectangle(glyph.x, glyph.y, regionWidth, regionHeight));
         }
 
-        uint16_t width = 0;
-        uint16_t height = 0;
+        return &(atlas.glyphs[c] = glyph);
+    }
 
+    void TTFont::renderGlyph(uint32_t c, float scale, bool toDistanceField, Glyph& glyph, std::vector<uint8_t>& bitmap)
+    {
         int ascent, descent, lineGap;
         stbtt_GetFontVMetrics(&font,  &ascent, &descent, &lineGap);
 
-        for (uint32_t c : glyphs)
+        int advance, leftBearing;
+        stbtt_GetCodepointHMetrics(&font, static_cast<int>(c), &advance, &leftBearing);
+
+        glyph.advance = static_cast<float>(advance * scale);
+        glyph.offset.x = static_cast<float>(leftBearing * scale);
+
+        if (toDistanceField)
         {
+            // the glyph is rendered bigger, so that the distances are more precise
+            uint32_t supersampling = DISTANCE_FIELD_SUPERSAMPLING;
+            float bitmapScale = scale * static_cast<float>(supersampling);
+
             int w, h, xoff, yoff;
-            if (unsigned char* bitmap = stbtt_GetCodepointBitmap(&font, s, s, static_cast<int>(c), &w, &h, &xoff, &yoff))
+            if (unsigned char* glyphBitmap = stbtt_GetCodepointBitmap(&font, bitmapScale, bitmapScale, static_cast<int>(c), &w, &h, &xoff, &yoff))
+            {
+                // the distance field needs space around the glyph
+                uint32_t padding = static_cast<uint32_t>(DISTANCE_FIELD_SPREAD) * supersampling;
+                uint32_t width = (static_cast<uint32_t>(w) + padding * 2 + supersampling - 1) / supersampling * supersampling;
+                uint32_t height = (static_cast<uint32_t>(h) + padding * 2 + supersampling - 1) / supersampling * supersampling;
+
+                std::vector<uint8_t> coverage(width * height);
+
+                for (uint32_t posY = 0; posY < static_cast<uint32_t>(h); ++posY)
+                {
+                    std::copy(glyphBitmap + posY * static_cast<uint32_t>(w),
+                              glyphBitmap + (posY + 1) * static_cast<uint32_t>(w),
+                              coverage.begin() + (posY + padding) * width + padding);
+                }
+
+                stbtt_FreeBitmap(glyphBitmap, nullptr);
+
+                generateDistanceField(coverage, width, height, supersampling, DISTANCE_FIELD_SPREAD, bitmap);
+
+                glyph.width = static_cast<uint16_t>(width / supersampling);
+                glyph.height = static_cast<uint16_t>(height / supersampling);
+                glyph.offset.x = static_cast<float>(xoff) / supersampling - DISTANCE_FIELD_SPREAD;
+                glyph.offset.y = static_cast<float>(yoff) / supersampling + (ascent - descent) * scale - DISTANCE_FIELD_SPREAD;
+            }
+        }
+        else
+        {
+            int w, h, xoff, yoff;
+            if (unsigned char* glyphBitmap = stbtt_GetCodepointBitmap(&font, scale, scale, static_cast<int>(c), &w, &h, &xoff, &yoff))
+            {
+                glyph.width = static_cast<uint16_t>(w);
+                glyph.height = static_cast<uint16_t>(h);
+                glyph.offset.y = static_cast<float>(yoff + (ascent - descent) * scale);
+                bitmap.assign(glyphBitmap, glyphBitmap + w * h);
+
+                stbtt_FreeBitmap(glyphBitmap, nullptr);
+            }
+        }
+    }
+
+    bool TTFont::allocateGlyph(Atlas& atlas, uint16_t width, uint16_t height, Glyph& glyph)
+    {
+        if (width > atlas.width || height > atlas.height)
+        {
+            return false;
+        }
+
+        uint16_t slotWidth = std::min(static_cast<uint16_t>(width + SPACING), atlas.width);
+        uint16_t slotHeight = std::min(static_cast<uint16_t>(height + SPACING), atlas.height);
+
+        for (;;)
+        {
+            // the shortest shelf that has space for the glyph
+            uint32_t bestShelf = std::numeric_limits<uint32_t>::max();
+            uint32_t bestSlot = std::numeric_limits<uint32_t>::max();
+            uint16_t bestHeight = std::numeric_limits<uint16_t>::max();
+
+            for (uint32_t shelfIndex = 0; shelfIndex < atlas.shelves.size(); ++shelfIndex)
             {
-                int advance, leftBearing;
-                stbtt_GetCodepointHMetrics(&font, static_cast<int>(c), &advance, &leftBearing);
+                const Shelf& shelf = atlas.shelves[shelfIndex];
 
-                CharDescriptor charDesc;
-                charDesc.width = static_cast<uint16_t>(w);
-                charDesc.height = static_cast<uint16_t>(h);
-                charDesc.offset.x = static_cast<float>(leftBearing * s);
-                charDesc.offset.y = static_cast<float>(yoff + (ascent - descent) * s);
-                charDesc.advance = static_cast<float>(advance * s);
-                charDesc.bitmap = std::vector<uint8_t>(bitmap, bitmap + h * w);
-                charDesc.x = width;
+                if (shelf.height < slotHeight || shelf.height >= bestHeight) continue;
 
-                width += static_cast<uint16_t>(w);
+                for (uint32_t slotIndex = 0; slotIndex < shelf.freeSlots.size(); ++slotIndex)
+                {
+                    if (shelf.freeSlots[slotIndex].second >= slotWidth)
+                    {
+                        bestShelf = shelfIndex;
+                        bestSlot = slotIndex;
+                        bestHeight = shelf.height;
+                        break;
+                    }
+                }
 
-                if (!chars.empty())
+                if (bestShelf != shelfIndex && atlas.width - shelf.x >= slotWidth)
                 {
-                    width += SPACING;
+                    bestShelf = shelfIndex;
+                    bestSlot = std::numeric_limits<uint32_t>::max();
+                    bestHeight = shelf.height;
                 }
-                height = height > static_cast<uint16_t>(h) ? height : static_cast<uint16_t>(h);
+            }
 
-                chars[c] = charDesc;
+            if (bestShelf != std::numeric_limits<uint32_t>::max())
+            {
+                Shelf& shelf = atlas.shelves[bestShelf];
 
-                stbtt_FreeBitmap(bitmap, nullptr);
+                if (bestSlot != std::numeric_limits<uint32_t>::max())
+                {
+                    std::pair<uint16_t, uint16_t>& slot = shelf.freeSlots[bestSlot];
+                    glyph.x = slot.first;
+                    slot.first += slotWidth;
+                    slot.second -= slotWidth;
+
+                    if (slot.second == 0)
+                    {
+                        shelf.freeSlots.erase(shelf.freeSlots.begin() + bestSlot);
+                    }
+                }
+                else
+                {
+                    glyph.x = shelf.x;
+                    shelf.x += slotWidth;
+                }
+
+                glyph.y = shelf.y;
+                glyph.width = width;
+                glyph.height = height;
+                glyph.shelf = bestShelf;
+                ++shelf.glyphCount;
+
+                return true;
+            }
+
+            uint16_t top = atlas.shelves.empty() ? 0 : atlas.shelves.back().y + atlas.shelves.back().height;
+
+            if (atlas.height - top >= slotHeight)
+            {
+                Shelf shelf;
+                shelf.y = top;
+                shelf.height = slotHeight;
+                atlas.shelves.push_back(shelf);
+            }
+            else if (!evictGlyph(atlas))
+            {
+                return false;
             }
         }
+    }
 
-        std::vector<uint8_t> textureData(width * height * 4);
+    bool TTFont::evictGlyph(Atlas& atlas)
+    {
+        auto leastRecentlyUsed = atlas.glyphs.end();
 
-        for (uint16_t posX = 0; posX < width; ++posX)
+        for (auto i = atlas.glyphs.begin(); i != atlas.glyphs.end(); ++i)
         {
-            for (uint16_t posY = 0; posY < height; ++posY)
+            // glyphs without a bitmap do not take space in the atlas
+            if (i->second.lastUse != currentFrame && i->second.width > 0 && i->second.height > 0 &&
+                (leastRecentlyUsed == atlas.glyphs.end() || i->second.lastUse < leastRecentlyUsed->second.lastUse))
             {
-                textureData[(posY * width + posX) * 4 + 0] = 255;
-                textureData[(posY * width + posX) * 4 + 1] = 255;
-                textureData[(posY * width + posX) * 4 + 2] = 255;
-                textureData[(posY * width + posX) * 4 + 3] = 0;
+                leastRecentlyUsed = i;
             }
         }
 
-        for (auto& c : chars)
+        if (leastRecentlyUsed == atlas.glyphs.end())
         {
-            CharDescriptor& charDesc = c.second;
+            return false;
+        }
+
+        freeGlyph(atlas, leastRecentlyUsed->second);
+        atlas.glyphs.erase(leastRecentlyUsed);
 
-            for (uint16_t posX = 0; posX < charDesc.width; ++posX)
+        // vertices that were returned before can point to the evicted glyph
+        ++version;
+
+        return true;
+    }
+
+    bool TTFont::evictAtlas()
+    {
+        auto leastRecentlyUsed = atlases.end();
+
+        for (auto i = atlases.begin(); i != atlases.end(); ++i)
+        {
+            if (i->second.lastUse != currentFrame &&
+                (leastRecentlyUsed == atlases.end() || i->second.lastUse < leastRecentlyUsed->second.lastUse))
             {
-                for (uint16_t posY = 0; posY < charDesc.height; ++posY)
-                {
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 0] = 255;
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 1] = 255;
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 2] = 255;
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 3] = charDesc.bitmap[posY * charDesc.width + posX];
-                }
+                leastRecentlyUsed = i;
             }
         }
 
-        texture = std::make_shared<graphics::Texture>();
-        texture->init(textureData, Size2(width, height), 0, mipmaps ? 0 : 1);
+        if (leastRecentlyUsed == atlases.end())
+        {
+            return false;
+        }
 
-        Vector2 position;
+        // the texture is kept alive by the text that still uses it until the text gets its vertices again
+        atlasMemory -= leastRecentlyUsed->second.width * leastRecentlyUsed->second.height * 4;
+        atlases.erase(leastRecentlyUsed);
 
-        indices.clear();
-        vertices.clear();
+        ++version;
 
-        indices.reserve(utf32Text.size() * 6);
-        vertices.reserve(utf32Text.size() * 4);
+        return true;
+    }
 
-        Vector2 textCoords[4];
+    void TTFont::freeGlyph(Atlas& atlas, const Glyph& glyph)
+    {
+        Shelf& shelf = atlas.shelves[glyph.shelf];
 
-        size_t firstChar = 0;
+        if (--shelf.glyphCount == 0)
+        {
+            shelf.x = 0;
+            shelf.freeSlots.clear();
+        }
+        else
+        {
+            uint16_t slotX = glyph.x;
+            uint16_t slotWidth = std::min(static_cast<uint16_t>(glyph.width + SPACING), static_cast<uint16_t>(atlas.width - glyph.x));
 
-        for (auto i = utf32Text.begin(); i != utf32Text.end(); ++i)
+            // the neighbouring free slots are merged
+            for (auto i = shelf.freeSlots.begin(); i != shelf.freeSlots.end();)
+            {
+                if (i->first + i->second == slotX)
+                {
+                    slotX = i->first;
+                    slotWidth += i->second;
+                    i = shelf.freeSlots.erase(i);
+                }
+                else if (slotX + slotWidth == i->first)
+                {
+                    slotWidth += i->second;
+                    i = shelf.freeSlots.erase(i);
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+
+            if (slotX + slotWidth == shelf.x)
+            {
+                shelf.x = slotX;
+            }
+            else
+            {
+                shelf.freeSlots.push_back(std::make_pair(slotX, slotWidth));
+            }
+        }
+
+        // empty shelves at the bottom are removed, so that the space can be used by glyphs of any height
+        while (!atlas.shelves.empty() && atlas.shelves.back().glyphCount == 0)
+        {
+            atlas.shelves.pop_back();
+        }
+    }
+
+    void TTFont::generateDistanceField(const std::vector<uint8_t>& coverage, uint32_t width, uint32_t height,
+                                       uint32_t downscale, float spread, std::vector<uint8_t>& result)
+    {
+        static const int32_t FAR_AWAY = 0x3FFF;
+
+        struct Point
         {
-            std::unordered_map<uint32_t, CharDescriptor>::iterator iter = chars.find(*i);
+            int16_t x;
+            int16_t y;
+
+            int32_t distanceSquared() const { return x * x + y * y; }
+        };
 
-            if (iter != chars.end())
+        // for every pixel the offset to the nearest pixel on the other side of the edge, propagated in two passes (8SSEDT)
+        auto computeDistances = [&coverage, width, height](bool inside, std::vector<Point>& grid) {
+            grid.resize(width * height);
+
+            for (uint32_t i = 0; i < width * height; ++i)
             {
-                const CharDescriptor& f = iter->second;
+                bool pixelInside = coverage[i] >= 128;
 
-                uint16_t startIndex = static_cast<uint16_t>(vertices.size());
-                indices.push_back(startIndex + 0);
-                indices.push_back(startIndex + 1);
-                indices.push_back(startIndex + 2);
+                if (pixelInside == inside) grid[i] = {FAR_AWAY, FAR_AWAY};
+                else grid[i] = {0, 0};
+            }
 
-                indices.push_back(startIndex + 1);
-                indices.push_back(startIndex + 3);
-                indices.push_back(startIndex + 2);
+            auto compare = [&grid, width, height](Point& point, int32_t x, int32_t y, int32_t offsetX, int32_t offsetY) {
+                if (x + offsetX < 0 || y + offsetY < 0 ||
+                    x + offsetX >= static_cast<int32_t>(width) || y + offsetY >= static_cast<int32_t>(height)) return;
 
-                Vector2 leftTop(f.x / static_cast<float>(width),
-                                f.y / static_cast<float>(height));
+                Point other = grid[static_cast<uint32_t>(y + offsetY) * width + static_cast<uint32_t>(x + offsetX)];
 
-                Vector2 rightBottom((f.x + f.width) / static_cast<float>(width),
-                                    (f.y + f.height) / static_cast<float>(height));
+                if (other.x == FAR_AWAY) return;
 
-                textCoords[0] = Vector2(leftTop.x, rightBottom.y);
-                textCoords[1] = Vector2(rightBottom.x, rightBottom.y);
-                textCoords[2] = Vector2(leftTop.x, leftTop.y);
-                textCoords[3] = Vector2(rightBottom.x, leftTop.y);
+                other.x = static_cast<int16_t>(other.x + offsetX);
+                other.y = static_cast<int16_t>(other.y + offsetY);
 
-                vertices.push_back(graphics::VertexPCT(Vector3(position.x + f.offset.x, -position.y - f.offset.y - f.height, 0.0f),
-                                                       color, textCoords[0]));
-                vertices.push_back(graphics::VertexPCT(Vector3(position.x + f.offset.x + f.width, -position.y - f.offset.y - f.height, 0.0f),
-                                                       color, textCoords[1]));
-                vertices.push_back(graphics::VertexPCT(Vector3(position.x + f.offset.x, -position.y - f.offset.y, 0.0f),
-                                                       color, textCoords[2]));
-                vertices.push_back(graphics::VertexPCT(Vector3(position.x + f.offset.x + f.width, -position.y - f.offset.y, 0.0f),
-                                                       color, textCoords[3]));
+                if (other.distanceSquared() < point.distanceSquared()) point = other;
+            };
 
-                if ((i + 1) != utf32Text.end())
+            for (int32_t y = 0; y < static_cast<int32_t>(height); ++y)
+            {
+                for (int32_t x = 0; x < static_cast<int32_t>(width); ++x)
                 {
-                    int kernAdvance = stbtt_GetCodepointKernAdvance(&font,
-                                                                    static_cast<int>(*i),
-                                                                    static_cast<int>(*(i + 1)));
-                    position.x += static_cast<float>(kernAdvance) * s;
+                    Point& point = grid[static_cast<uint32_t>(y) * width + static_cast<uint32_t>(x)];
+                    compare(point, x, y, -1, 0);
+                    compare(point, x, y, 0, -1);
+                    compare(point, x, y, -1, -1);
+                    compare(point, x, y, 1, -1);
                 }
 
-                position.x += f.advance;
+                for (int32_t x = static_cast<int32_t>(width) - 1; x >= 0; --x)
+                {
+                    Point& point = grid[static_cast<uint32_t>(y) * width + static_cast<uint32_t>(x)];
+                    compare(point, x, y, 1, 0);
+                }
             }
 
-            if (*i == static_cast<uint32_t>('\n') || // line feed
-                (i + 1) == utf32Text.end()) // end of string
+            for (int32_t y = static_cast<int32_t>(height) - 1; y >= 0; --y)
             {
-                float lineWidth = position.x;
-                position.x = 0.0f;
-                position.y += fontSize + lineGap;
-
-                for (size_t c = firstChar; c < vertices.size(); ++c)
+                for (int32_t x = static_cast<int32_t>(width) - 1; x >= 0; --x)
                 {
-                    vertices[c].position.x -= lineWidth * anchor.x;
+                    Point& point = grid[static_cast<uint32_t>(y) * width + static_cast<uint32_t>(x)];
+                    compare(point, x, y, 1, 0);
+                    compare(point, x, y, 0, 1);
+                    compare(point, x, y, -1, 1);
+                    compare(point, x, y, 1, 1);
                 }
 
-                firstChar = vertices.size();
+                for (int32_t x = 0; x < static_cast<int32_t>(width); ++x)
+                {
+                    Point& point = grid[static_cast<uint32_t>(y) * width + static_cast<uint32_t>(x)];
+                    compare(point, x, y, -1, 0);
+                }
             }
-        }
+        };
 
-        float textHeight = position.y;
+        std::vector<Point> outsideGrid; // distances from the outside pixels to the glyph
+        std::vector<Point> insideGrid; // distances from the inside pixels to the background
+        computeDistances(false, outsideGrid);
+        computeDistances(true, insideGrid);
 
-        for (size_t c = 0; c < vertices.size(); ++c)
+        uint32_t resultWidth = width / downscale;
+        uint32_t resultHeight = height / downscale;
+        result.resize(resultWidth * resultHeight);
+
+        float distanceScale = 127.0f / (spread * static_cast<float>(downscale));
+
+        for (uint32_t resultY = 0; resultY < resultHeight; ++resultY)
         {
-            vertices[c].position.y += textHeight * (1.0f - anchor.y);
+            for (uint32_t resultX = 0; resultX < resultWidth; ++resultX)
+            {
+                float sum = 0.0f;
+
+                // the distances of the pixels in the block are averaged
+                for (uint32_t y = resultY * downscale; y < (resultY + 1) * downscale; ++y)
+                {
+                    for (uint32_t x = resultX * downscale; x < (resultX + 1) * downscale; ++x)
+                    {
+                        uint32_t i = y * width + x;
+
+                        // the edge lies half way between the pixels
+                        if (coverage[i] >= 128) sum += sqrtf(static_cast<float>(insideGrid[i].distanceSquared())) - 0.5f;
+                        else sum -= sqrtf(static_cast<float>(outsideGrid[i].distanceSquared())) - 0.5f;
+                    }
+                }
+
+                float distance = sum / static_cast<float>(downscale * downscale);
+                float value = 128.0f + distance * distanceScale;
+
+                result[resultY * resultWidth + resultX] = static_cast<uint8_t>(clamp(value, 0.0f, 255.0f));
+            }
         }
     }
 
@@ -12,7 +12,8 @@ namespace ouzel
     {
     public:
         TTFont();
-        TTFont(const std::string& filename, bool aMipmaps = true);
+        // the glyphs are rendered as bitmaps if the render device has no distance field shader
+        TTFont(const std::string& filename, bool aMipmaps = true, bool aDistanceField = false);
 
         virtual void getVertices(const std::string& text,
                                  const Color& color,
@@ -22,14 +23,67 @@ namespace ouzel
                                  std::vector<graphics::VertexPCT>& vertices,
                                  std::shared_ptr<graphics::Texture>& texture) override;
 
+        virtual void useGlyphs(const std::vector<uint32_t>& characters, float fontSize) override;
+
+        // writes the distance fields of the characters to a BMFont text file and a PNG atlas next to it
+        bool bakeDistanceField(const std::string& filename, const std::string& characters);
+
     protected:
+        struct Glyph
+        {
+            uint16_t x = 0, y = 0;
+            uint16_t width = 0;
+            uint16_t height = 0;
+            Vector2 offset;
+            float advance = 0.0f;
+            uint32_t shelf = 0;
+            uint32_t lastUse = 0;
+        };
+
+        // a row of glyphs in the atlas, the freed parts of the row are reused
+        struct Shelf
+        {
+            uint16_t y = 0;
+            uint16_t height = 0;
+            uint16_t x = 0; // start of the unused part of the row
+            uint32_t glyphCount = 0;
+            std::vector<std::pair<uint16_t, uint16_t>> freeSlots; // x and width
+        };
+
+        // glyphs of one font size, the texture is kept between the calls
+        struct Atlas
+        {
+            std::shared_ptr<graphics::Texture> texture;
+            uint16_t width = 0;
+            uint16_t height = 0;
+            std::unordered_map<uint32_t, Glyph> glyphs;
+            std::vector<Shelf> shelves;
+            uint32_t lastUse = 0;
+        };
+
         bool parseFont(const std::string& filename);
 
         int16_t getKerningPair(uint32_t, uint32_t);
         float getStringWidth(const std::string& text);
 
+        Atlas& getAtlas(float fontSize);
+        const Glyph* getGlyph(Atlas& atlas, uint32_t c, float scale);
+        void renderGlyph(uint32_t c, float scale, bool toDistanceField, Glyph& glyph, std::vector<uint8_t>& bitmap);
+        bool allocateGlyph(Atlas& atlas, uint16_t width, uint16_t height, Glyph& glyph);
+        bool evictGlyph(Atlas& atlas);
+        bool evictAtlas();
+        void freeGlyph(Atlas& atlas, const Glyph& glyph);
+
+        // converts the coverage to a signed distance field downscale times smaller, the edge is at 128 and spread pixels cover the whole range
+        static void generateDistanceField(const std::vector<uint8_t>& coverage, uint32_t width, uint32_t height,
+                                          uint32_t downscale, float spread, std::vector<uint8_t>& result);
+
         bool mipmaps = true;
         stbtt_fontinfo font;
         std::vector<unsigned char> data;
+
+        std::map<float, Atlas> atlases;
+        uint32_t atlasMemory = 0; // bytes taken by the textures of the atlases
+        uint32_t currentFrame = 0;
     };
 }
@@ -1,8 +1,114 @@
 // Copyright (C) 2017 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <algorithm>
 #include "ConvexVolume.hpp"
+#include "core/Setup.h"
+#if OUZEL_SUPPORTS_SSE
+#include <xmmintrin.h>
+#elif (OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define OUZEL_CONVEX_VOLUME_NEON 1
+#endif
 
 namespace ouzel
 {
+    void ConvexVolume::areBoxesInside(const Box3* boxes, uint32_t count, uint32_t* visibilityMask) const
+    {
+        std::fill(visibilityMask, visibilityMask + (count + 31) / 32, 0);
+
+        uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_SSE
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            const Box3* box = boxes + i;
+
+            // transpose four boxes to the centers and extents of each axis
+            __m128 minX = _mm_set_ps(box[3].min.x, box[2].min.x, box[1].min.x, box[0].min.x);
+            __m128 minY = _mm_set_ps(box[3].min.y, box[2].min.y, box[1].min.y, box[0].min.y);
+            __m128 minZ = _mm_set_ps(box[3].min.z, box[2].min.z, box[1].min.z, box[0].min.z);
+            __m128 maxX = _mm_set_ps(box[3].max.x, box[2].max.x, box[1].max.x, box[0].max.x);
+            __m128 maxY = _mm_set_ps(box[3].max.y, box[2].max.y, box[1].max.y, box[0].max.y);
+            __m128 maxZ = _mm_set_ps(box[3].max.z, box[2].max.z, box[1].max.z, box[0].max.z);
+
+            __m128 centerX = _mm_mul_ps(_mm_add_ps(minX, maxX), half);
+            __m128 centerY = _mm_mul_ps(_mm_add_ps(minY, maxY), half);
+            __m128 centerZ = _mm_mul_ps(_mm_add_ps(minZ, maxZ), half);
+            __m128 extentX = _mm_mul_ps(_mm_sub_ps(maxX, minX), half);
+            __m128 extentY = _mm_mul_ps(_mm_sub_ps(maxY, minY), half);
+            __m128 extentZ = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+
+            __m128 outside = _mm_setzero_ps();
+
+            for (const Plane& plane : planes)
+            {
+                __m128 a = _mm_set1_ps(plane.a);
+                __m128 b = _mm_set1_ps(plane.b);
+                __m128 c = _mm_set1_ps(plane.c);
+
+                // distance of the center plus the projected extent
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, centerX), _mm_mul_ps(b, centerY)),
+                                             _mm_add_ps(_mm_mul_ps(c, centerZ), _mm_set1_ps(plane.d)));
+                __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signBit, a), extentX),
+                                                      _mm_mul_ps(_mm_andnot_ps(signBit, b), extentY)),
+                                           _mm_mul_ps(_mm_andnot_ps(signBit, c), extentZ));
+
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+            }
+
+            uint32_t inside = static_cast<uint32_t>(~_mm_movemask_ps(outside)) & 0x0F;
+            visibilityMask[i / 32] |= inside << (i % 32);
+        }
+#elif OUZEL_CONVEX_VOLUME_NEON
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            const Box3* box = boxes + i;
+
+            float minX[4] = {box[0].min.x, box[1].min.x, box[2].min.x, box[3].min.x};
+            float minY[4] = {box[0].min.y, box[1].min.y, box[2].min.y, box[3].min.y};
+            float minZ[4] = {box[0].min.z, box[1].min.z, box[2].min.z, box[3].min.z};
+            float maxX[4] = {box[0].max.x, box[1].max.x, box[2].max.x, box[3].max.x};
+            float maxY[4] = {box[0].max.y, box[1].max.y, box[2].max.y, box[3].max.y};
+            float maxZ[4] = {box[0].max.z, box[1].max.z, box[2].max.z, box[3].max.z};
+
+            float32x4_t centerX = vmulq_n_f32(vaddq_f32(vld1q_f32(minX), vld1q_f32(maxX)), 0.5f);
+            float32x4_t centerY = vmulq_n_f32(vaddq_f32(vld1q_f32(minY), vld1q_f32(maxY)), 0.5f);
+            float32x4_t centerZ = vmulq_n_f32(vaddq_f32(vld1q_f32(minZ), vld1q_f32(maxZ)), 0.5f);
+            float32x4_t extentX = vmulq_n_f32(vsubq_f32(vld1q_f32(maxX), vld1q_f32(minX)), 0.5f);
+            float32x4_t extentY = vmulq_n_f32(vsubq_f32(vld1q_f32(maxY), vld1q_f32(minY)), 0.5f);
+            float32x4_t extentZ = vmulq_n_f32(vsubq_f32(vld1q_f32(maxZ), vld1q_f32(minZ)), 0.5f);
+
+            uint32x4_t outside = vdupq_n_u32(0);
+
+            for (const Plane& plane : planes)
+            {
+                float32x4_t distance = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(plane.d), centerX, plane.a), centerY, plane.b), centerZ, plane.c);
+                float32x4_t radius = vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(extentX, fabsf(plane.a)), extentY, fabsf(plane.b)), extentZ, fabsf(plane.c));
+
+                outside = vorrq_u32(outside, vcltq_f32(vaddq_f32(distance, radius), zero));
+            }
+
+            uint32_t inside = ((vgetq_lane_u32(outside, 0) & 0x01) |
+                               (vgetq_lane_u32(outside, 1) & 0x02) |
+                               (vgetq_lane_u32(outside, 2) & 0x04) |
+                               (vgetq_lane_u32(outside, 3) & 0x08)) ^ 0x0F;
+            visibilityMask[i / 32] |= inside << (i % 32);
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            if (isBoxInside(boxes[i]))
+            {
+                visibilityMask[i / 32] |= 1U << (i % 32);
+            }
+        }
+    }
 }
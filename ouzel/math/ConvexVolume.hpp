@@ -3,9 +3,12 @@
 
 #pragma once
 
+#include <cmath>
+#include <cstdint>
 #include <vector>
 #include "math/Box3.hpp"
 #include "math/Plane.hpp"
+#include "math/Vector3.hpp"
 #include "math/Vector4.hpp"
 
 namespace ouzel
@@ -22,7 +25,7 @@ namespace ouzel
         {
         }
 
-        bool isPointInside(const Vector4& position)
+        bool isPointInside(const Vector4& position) const
         {
             for (const Plane& plane : planes)
             {
@@ -35,7 +38,7 @@ namespace ouzel
             return true;
         }
 
-        bool isSphereInside(const Vector4& position, float radius)
+        bool isSphereInside(const Vector4& position, float radius) const
         {
             for (const Plane& plane : planes)
             {
@@ -48,56 +51,34 @@ namespace ouzel
             return true;
         }
 
-        bool isBoxInside(const Box3& box)
+        bool isBoxInside(const Box3& box) const
         {
+            Vector4 center((box.min.x + box.max.x) * 0.5f,
+                           (box.min.y + box.max.y) * 0.5f,
+                           (box.min.z + box.max.z) * 0.5f,
+                           1.0f);
+            Vector3 extent((box.max.x - box.min.x) * 0.5f,
+                           (box.max.y - box.min.y) * 0.5f,
+                           (box.max.z - box.min.z) * 0.5f);
+
             for (const Plane& plane : planes)
             {
-                if (plane.dot(Vector4(box.min.x, box.min.y, box.min.z, 1.0f)) >= 0.0f)
-                {
-                    continue;
-                }
-
-                if (plane.dot(Vector4(box.max.x, box.min.y, box.min.z, 1.0f)) >= 0.0f)
-                {
-                    continue;
-                }
-
-                if (plane.dot(Vector4(box.min.x, box.max.y, box.min.z, 1.0f)) >= 0.0f)
-                {
-                    continue;
-                }
-
-                if (plane.dot(Vector4(box.min.x, box.min.y, box.max.z, 1.0f)) >= 0.0f)
-                {
-                    continue;
-                }
+                // the box is outside if the corner closest to the inside of the plane is outside
+                float radius = fabsf(plane.a) * extent.x + fabsf(plane.b) * extent.y + fabsf(plane.c) * extent.z;
 
-                if (plane.dot(Vector4(box.max.x, box.max.y, box.min.z, 1.0f)) >= 0.0f)
+                if (plane.dot(center) < -radius)
                 {
-                    continue;
-                }
-
-                if (plane.dot(Vector4(box.max.x, box.min.y, box.max.z, 1.0f)) >= 0.0f)
-                {
-                    continue;
-                }
-
-                if (plane.dot(Vector4(box.min.x, box.max.y, box.max.z, 1.0f)) >= 0.0f)
-                {
-                    continue;
-                }
-
-                if (plane.dot(Vector4(box.max.x, box.max.y, box.max.z, 1.0f)) >= 0.0f)
-                {
-                    continue;
+                    return false;
                 }
-
-                return false;
             }
 
             return true;
         }
 
+        // tests the boxes four at a time, sets bit (i % 32) of visibilityMask[i / 32] if box i is at least partially inside,
+        // visibilityMask must have room for (count + 31) / 32 words
+        void areBoxesInside(const Box3* boxes, uint32_t count, uint32_t* visibilityMask) const;
+
         std::vector<Plane> planes;
     };
 }
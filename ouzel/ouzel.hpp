@@ -25,6 +25,7 @@
 #include "core/Cache.hpp"
 #include "core/Setup.h"
 #include "core/Engine.hpp"
+#include "core/JobSystem.hpp"
 #include "core/Timer.hpp"
 #include "core/UpdateCallback.hpp"
 #include "core/Window.hpp"
@@ -43,6 +44,7 @@
 #include "graphics/MeshBufferResource.hpp"
 #include "graphics/PixelFormat.hpp"
 #include "graphics/Renderer.hpp"
+#include "graphics/RenderReplay.hpp"
 #include "graphics/RenderResource.hpp"
 #include "graphics/Shader.hpp"
 #include "graphics/ShaderResource.hpp"
@@ -88,7 +90,9 @@
 #include "scene/Component.hpp"
 #include "scene/Layer.hpp"
 #include "scene/MeshRenderer.hpp"
+#include "scene/ParticleData.hpp"
 #include "scene/ParticleDefinition.hpp"
+#include "scene/ParticleManager.hpp"
 #include "scene/ParticleSystem.hpp"
 #include "scene/Scene.hpp"
 #include "scene/SceneManager.hpp"
@@ -99,4 +103,5 @@
 #include "utils/INI.hpp"
 #include "utils/Log.hpp"
 #include "utils/OBF.hpp"
+#include "utils/Profiler.hpp"
 #include "utils/Utils.hpp"
@@ -9,6 +9,8 @@
 #include "Camera.hpp"
 #include "math/MathUtils.hpp"
 #include "Component.hpp"
+#include "SpatialIndex.hpp"
+#include "TransformHierarchy.hpp"
 
 namespace ouzel
 {
@@ -21,6 +23,8 @@ namespace ouzel
         Actor::~Actor()
         {
             if (parent) parent->removeChild(this);
+            if (transformHierarchy) transformHierarchy->removeActor(transformIndex);
+            if (spatialIndex) spatialIndex->removeActor(this);
 
             for (const auto& component : components)
             {
@@ -35,8 +39,15 @@ namespace ouzel
                           int32_t parentOrder,
                           bool parentHidden)
         {
-            worldOrder = parentOrder + order;
-            worldHidden = parentHidden || hidden;
+            int32_t newWorldOrder = parentOrder + order;
+            bool newWorldHidden = parentHidden || hidden;
+
+            if (newWorldOrder != worldOrder || newWorldHidden != worldHidden)
+            {
+                worldOrder = newWorldOrder;
+                worldHidden = newWorldHidden;
+                clearStaticCache();
+            }
 
             if (parentTransformDirty)
             {
@@ -48,18 +59,39 @@ namespace ouzel
                 calculateTransform();
             }
 
+            StaticCacheEntry* cacheEntry = nullptr;
+            uint32_t viewProjectionVersion = 0;
+
+            if (staticActor && layer)
+            {
+                // every camera has its own entry, so the cameras of the layer can be culled in parallel
+                const std::vector<Camera*>& cameras = layer->getCameras();
+                auto cameraIterator = std::find(cameras.begin(), cameras.end(), camera);
+                size_t cameraIndex = static_cast<size_t>(cameraIterator - cameras.begin());
+
+                if (cameraIterator != cameras.end() && cameraIndex < STATIC_CACHE_SIZE)
+                {
+                    cacheEntry = &staticCache[cameraIndex];
+                    viewProjectionVersion = camera->getViewProjectionVersion();
+
+                    if (cacheEntry->viewProjectionVersion == viewProjectionVersion)
+                    {
+                        drawQueue.insert(drawQueue.end(), cacheEntry->actors.begin(), cacheEntry->actors.end());
+                        return;
+                    }
+                }
+            }
+
+            size_t drawQueueStart = drawQueue.size();
+
             if (!worldHidden)
             {
                 Box3 boundingBox = getBoundingBox();
 
+                // the layer sorts the draw queue by the world order after all the actors are visited
                 if (cullDisabled || (!boundingBox.isEmpty() && camera->checkVisibility(getTransform(), boundingBox)))
                 {
-                    auto upperBound = std::upper_bound(drawQueue.begin(), drawQueue.end(), this,
-                                                       [](Actor* a, Actor* b) {
-                                                           return a->worldOrder > b->worldOrder;
-                                                       });
-
-                    drawQueue.insert(upperBound, this);
+                    drawQueue.push_back(this);
                 }
             }
 
@@ -68,7 +100,14 @@ namespace ouzel
                 actor->visit(drawQueue, transform, updateChildrenTransform, camera, worldOrder, worldHidden);
             }
 
-            updateChildrenTransform = false;
+            // the other cameras of the layer only read the actors
+            if (updateChildrenTransform) updateChildrenTransform = false;
+
+            if (cacheEntry)
+            {
+                cacheEntry->viewProjectionVersion = viewProjectionVersion;
+                cacheEntry->actors.assign(drawQueue.begin() + static_cast<std::ptrdiff_t>(drawQueueStart), drawQueue.end());
+            }
         }
 
         void Actor::draw(Camera* camera, bool wireframe)
@@ -106,6 +145,20 @@ namespace ouzel
             }
         }
 
+        bool Actor::removeChildActor(Actor* actor)
+        {
+            invalidateStaticCache();
+
+            return ActorContainer::removeChildActor(actor);
+        }
+
+        void Actor::removeAllChildren()
+        {
+            invalidateStaticCache();
+
+            ActorContainer::removeAllChildren();
+        }
+
         void Actor::setPosition(const Vector2& newPosition)
         {
             position.x = newPosition.x;
@@ -182,9 +235,31 @@ namespace ouzel
             updateLocalTransform();
         }
 
+        void Actor::setOrder(int32_t newOrder)
+        {
+            order = newOrder;
+
+            invalidateStaticCache();
+
+            if (spatialIndex) spatialIndex->setSubtreeDirty(this);
+        }
+
         void Actor::setHidden(bool newHidden)
         {
             hidden = newHidden;
+
+            invalidateStaticCache();
+
+            if (spatialIndex) spatialIndex->setSubtreeDirty(this);
+        }
+
+        void Actor::setCullDisabled(bool newCullDisabled)
+        {
+            cullDisabled = newCullDisabled;
+
+            invalidateStaticCache();
+
+            if (spatialIndex) spatialIndex->setBoundsDirty(this);
         }
 
         bool Actor::pointOn(const Vector2& worldPosition) const
@@ -231,6 +306,10 @@ namespace ouzel
         void Actor::updateLocalTransform()
         {
             localTransformDirty = transformDirty = inverseTransformDirty = true;
+            if (transformHierarchy) transformHierarchy->setLocalDirty(transformIndex);
+            if (spatialIndex) spatialIndex->setSubtreeDirty(this);
+            invalidateStaticCache();
+
             for (Component* component : components)
             {
                 component->updateTransform();
@@ -241,12 +320,48 @@ namespace ouzel
         {
             parentTransform = newParentTransform;
             transformDirty = inverseTransformDirty = true;
+            invalidateStaticCache();
+
             for (Component* component : components)
             {
                 component->updateTransform();
             }
         }
 
+        void Actor::updateBoundingBox()
+        {
+            if (spatialIndex) spatialIndex->setBoundsDirty(this);
+            invalidateStaticCache();
+        }
+
+        void Actor::invalidateStaticCache()
+        {
+            for (Actor* actor = this;;)
+            {
+                actor->clearStaticCache();
+
+                // the children of a layer have the layer as their parent
+                if (!actor->parent || actor->parent == actor->layer) break;
+
+                actor = static_cast<Actor*>(actor->parent);
+            }
+        }
+
+        void Actor::clearStaticCache()
+        {
+            for (StaticCacheEntry& entry : staticCache)
+            {
+                entry.viewProjectionVersion = 0;
+            }
+        }
+
+        void Actor::setStatic(bool newStatic)
+        {
+            staticActor = newStatic;
+
+            invalidateStaticCache();
+        }
+
         Vector3 Actor::getWorldPosition() const
         {
             Vector3 result = position;
@@ -319,6 +434,8 @@ namespace ouzel
 
             component->actor = this;
             components.push_back(component);
+
+            updateBoundingBox();
         }
 
         bool Actor::removeChildComponent(Component* component)
@@ -331,6 +448,7 @@ namespace ouzel
             {
                 component->actor = nullptr;
                 components.erase(componentIterator);
+                updateBoundingBox();
                 result = true;
             }
 
@@ -350,10 +468,30 @@ namespace ouzel
         {
             components.clear();
             ownedComponents.clear();
+
+            updateBoundingBox();
         }
 
         void Actor::setLayer(Layer* newLayer)
         {
+            if (transformHierarchy)
+            {
+                transformHierarchy->removeActor(transformIndex);
+                transformHierarchy = nullptr;
+            }
+
+            if (newLayer && newLayer->getTransformHierarchy())
+            {
+                newLayer->getTransformHierarchy()->setStructureDirty();
+            }
+
+            if (spatialIndex) spatialIndex->removeActor(this);
+
+            if (newLayer && newLayer->getSpatialIndex())
+            {
+                newLayer->getSpatialIndex()->addActor(this);
+            }
+
             ActorContainer::setLayer(newLayer);
 
             for (Component* component : components)
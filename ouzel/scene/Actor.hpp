@@ -21,11 +21,16 @@ namespace ouzel
         class Camera;
         class Component;
         class Layer;
+        class SpatialIndex;
+        class TransformHierarchy;
 
         class Actor: public ActorContainer
         {
             friend ActorContainer;
+            friend Component;
             friend Layer;
+            friend SpatialIndex;
+            friend TransformHierarchy;
         public:
             Actor();
             virtual ~Actor();
@@ -42,7 +47,7 @@ namespace ouzel
             virtual void setPosition(const Vector3& newPosition);
             virtual const Vector3& getPosition() const { return position; }
 
-            void setOrder(int32_t newOrder) { order = newOrder; }
+            void setOrder(int32_t newOrder);
             int32_t getOrder() const { return order; }
 
             virtual void setRotation(const Quaternion& newRotation);
@@ -67,12 +72,16 @@ namespace ouzel
             virtual bool isPickable() const { return pickable; }
 
             virtual bool isCullDisabled() const { return cullDisabled; }
-            virtual void setCullDisabled(bool newCullDisabled) { cullDisabled = newCullDisabled; }
+            virtual void setCullDisabled(bool newCullDisabled);
 
             virtual void setHidden(bool newHidden);
             virtual bool isHidden() const { return hidden; }
             bool isWorldHidden() const { return worldHidden; }
 
+            // the visible actors of a static actor's subtree are cached per camera and reused until something in the subtree changes
+            void setStatic(bool newStatic);
+            bool isStatic() const { return staticActor; }
+
             virtual bool pointOn(const Vector2& worldPosition) const;
             virtual bool shapeOverlaps(const std::vector<Vector2>& edges) const;
 
@@ -115,6 +124,8 @@ namespace ouzel
             ActorContainer* getParent() const { return parent; }
             void removeFromParent();
 
+            virtual void removeAllChildren() override;
+
             void addComponent(Component* component)
             {
                 addChildComponent(component);
@@ -149,6 +160,7 @@ namespace ouzel
 
         protected:
             virtual void addChildActor(Actor* actor) override;
+            virtual bool removeChildActor(Actor* actor) override;
             void addChildComponent(Component* component);
             bool removeChildComponent(Component* component);
 
@@ -156,6 +168,11 @@ namespace ouzel
 
             void updateLocalTransform();
             void updateTransform(const Matrix4& newParentTransform);
+            void updateBoundingBox();
+
+            // clears the caches of this actor and all its static parents
+            void invalidateStaticCache();
+            void clearStaticCache();
 
             virtual void calculateLocalTransform() const;
             virtual void calculateTransform() const;
@@ -193,6 +210,27 @@ namespace ouzel
             std::vector<std::unique_ptr<Component>> ownedComponents;
 
             UpdateCallback animationUpdateCallback;
+
+            struct StaticCacheEntry
+            {
+                uint32_t viewProjectionVersion = 0; // 0 if the entry is not valid
+                std::vector<Actor*> actors;
+            };
+
+            static const size_t STATIC_CACHE_SIZE = 4; // entries for the first cameras of the layer
+
+            bool staticActor = false;
+            StaticCacheEntry staticCache[STATIC_CACHE_SIZE];
+
+            TransformHierarchy* transformHierarchy = nullptr;
+            uint32_t transformIndex = 0;
+
+            SpatialIndex* spatialIndex = nullptr;
+            int32_t spatialProxy = -1;
+            uint32_t spatialState = 0;
+            uint32_t spatialDirtyIndex = 0;
+            uint32_t spatialDrawIndex = 0; // pre-order index in the layer, orders the actors with the same world order
+            Box3 spatialBoundingBox; // world space
         };
     } // namespace scene
 } // namespace ouzel
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include "ActorContainer.hpp"
 #include "Actor.hpp"
+#include "Layer.hpp"
 
 namespace ouzel
 {
@@ -75,6 +76,8 @@ namespace ouzel
             {
                 std::rotate(children.begin(), i, i + 1);
 
+                if (layer && layer->getSpatialIndex()) layer->getSpatialIndex()->setDrawOrderDirty();
+
                 return true;
             }
 
@@ -89,6 +92,8 @@ namespace ouzel
             {
                 std::rotate(i, i + 1, children.end());
 
+                if (layer && layer->getSpatialIndex()) layer->getSpatialIndex()->setDrawOrderDirty();
+
                 return true;
             }
 
@@ -101,6 +106,7 @@ namespace ouzel
             {
                 if (entered) actor->leave();
                 actor->parent = nullptr;
+                actor->setLayer(nullptr);
             }
 
             children.clear();
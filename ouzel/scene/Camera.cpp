@@ -2,7 +2,9 @@
 // This file is part of the Ouzel engine.
 
 #include <cassert>
+#include <atomic>
 #include <algorithm>
+#include <limits>
 #include "Camera.hpp"
 #include "core/Engine.hpp"
 #include "graphics/Renderer.hpp"
@@ -15,6 +17,8 @@ namespace ouzel
 {
     namespace scene
     {
+        static std::atomic<uint32_t> lastViewProjectionVersion(0); // the layers are prepared in parallel
+
         Camera::Camera(Matrix4 aProjection):
             Component(TYPE),
             type(Type::CUSTOM), projection(aProjection)
@@ -157,6 +161,16 @@ namespace ouzel
             return renderViewProjection;
         }
 
+        uint32_t Camera::getViewProjectionVersion() const
+        {
+            if (viewProjectionDirty)
+            {
+                calculateViewProjection();
+            }
+
+            return viewProjectionVersion;
+        }
+
         const Matrix4& Camera::getInverseViewProjection() const
         {
             if (inverseViewProjectionDirty)
@@ -180,6 +194,7 @@ namespace ouzel
 
                 renderViewProjection = sharedEngine->getRenderer()->getDevice()->getProjectionTransform(renderTarget != nullptr) * renderViewProjection;
 
+                viewProjectionVersion = ++lastViewProjectionVersion;
                 viewProjectionDirty = false;
             }
         }
@@ -206,6 +221,69 @@ namespace ouzel
                            (result.y / 2.0f + 0.5f) * viewport.size.height + viewport.position.y);
         }
 
+        void Camera::checkVisibility(const Box3* boundingBoxes, uint32_t count, uint32_t* visibilityMask) const
+        {
+            const Matrix4& currentViewProjection = getViewProjection();
+            ConvexVolume frustum;
+            bool valid;
+
+            if (type == Type::ORTHOGRAPHIC)
+            {
+                // orthographic visibility check ignores the depth, so only the side planes are used
+                Plane planes[4];
+                valid = currentViewProjection.getFrustumLeftPlane(planes[0]) &&
+                    currentViewProjection.getFrustumRightPlane(planes[1]) &&
+                    currentViewProjection.getFrustumBottomPlane(planes[2]) &&
+                    currentViewProjection.getFrustumTopPlane(planes[3]);
+
+                frustum.planes.assign(planes, planes + 4);
+            }
+            else
+            {
+                valid = currentViewProjection.getFrustum(frustum);
+            }
+
+            if (valid)
+            {
+                frustum.areBoxesInside(boundingBoxes, count, visibilityMask);
+            }
+            else
+            {
+                std::fill(visibilityMask, visibilityMask + (count + 31) / 32, 0);
+            }
+        }
+
+        Box3 Camera::getViewBoundingBox() const
+        {
+            Box3 result;
+
+            const Matrix4& currentInverseViewProjection = getInverseViewProjection();
+
+            // corners of the clip space cube in the world space
+            for (uint32_t i = 0; i < 8; ++i)
+            {
+                Vector4 corner((i & 0x01) ? 1.0f : -1.0f,
+                               (i & 0x02) ? 1.0f : -1.0f,
+                               (i & 0x04) ? 1.0f : -1.0f,
+                               1.0f);
+                currentInverseViewProjection.transformVector(corner);
+
+                if (corner.w != 0.0f)
+                {
+                    result.insertPoint(Vector3(corner.x / corner.w, corner.y / corner.w, corner.z / corner.w));
+                }
+            }
+
+            // orthographic visibility check ignores the depth
+            if (type == Type::ORTHOGRAPHIC)
+            {
+                result.min.z = std::numeric_limits<float>::lowest();
+                result.max.z = std::numeric_limits<float>::max();
+            }
+
+            return result;
+        }
+
         bool Camera::checkVisibility(const Matrix4& boxTransform, const Box3& boundingBox) const
         {
             if (type == Type::ORTHOGRAPHIC)
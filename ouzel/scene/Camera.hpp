@@ -59,11 +59,17 @@ namespace ouzel
             const Matrix4& getViewProjection() const;
             const Matrix4& getRenderViewProjection() const;
             const Matrix4& getInverseViewProjection() const;
+            // changes every time the view projection changes, unique across all cameras
+            uint32_t getViewProjectionVersion() const;
 
             Vector3 convertNormalizedToWorld(const Vector2& normalizedPosition) const;
             Vector2 convertWorldToNormalized(const Vector3& worldPosition) const;
 
             bool checkVisibility(const Matrix4& boxTransform, const Box3& boundingBox) const;
+            // culls world space bounding boxes, bit (i % 32) of visibilityMask[i / 32] is set if box i is visible
+            void checkVisibility(const Box3* boundingBoxes, uint32_t count, uint32_t* visibilityMask) const;
+            // world space box that contains everything the camera can see
+            Box3 getViewBoundingBox() const;
 
             void setViewport(const Rectangle& newViewport);
             const Rectangle& getViewport() const { return viewport; }
@@ -118,6 +124,7 @@ namespace ouzel
 
             mutable bool viewProjectionDirty = false;
             mutable Matrix4 viewProjection;
+            mutable uint32_t viewProjectionVersion = 0;
             mutable Matrix4 renderViewProjection;
 
             mutable bool inverseViewProjectionDirty = false;
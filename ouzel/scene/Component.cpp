@@ -110,5 +110,10 @@ namespace ouzel
         void Component::updateTransform()
         {
         }
+
+        void Component::boundingBoxChanged()
+        {
+            if (actor) actor->updateBoundingBox();
+        }
     } // namespace scene
 } // namespace ouzel
@@ -19,10 +19,14 @@ namespace ouzel
         class Camera;
         class Actor;
         class Layer;
+        class SpatialIndex;
+        class TransformHierarchy;
 
         class Component: public Noncopyable
         {
             friend Actor;
+            friend SpatialIndex;
+            friend TransformHierarchy;
         public:
             enum Type
             {
@@ -55,14 +59,14 @@ namespace ouzel
                               bool scissorTest,
                               const Rectangle& scissorRectangle);
 
-            virtual void setBoundingBox(const Box3& newBoundingBox) { boundingBox = newBoundingBox; }
+            virtual void setBoundingBox(const Box3& newBoundingBox) { boundingBox = newBoundingBox; boundingBoxChanged(); }
             virtual const Box3& getBoundingBox() const { return boundingBox; }
 
             virtual bool pointOn(const Vector2& position) const;
             virtual bool shapeOverlaps(const std::vector<Vector2>& edges) const;
 
             bool isHidden() const { return hidden; }
-            void setHidden(bool newHidden) { hidden = newHidden; }
+            void setHidden(bool newHidden) { hidden = newHidden; boundingBoxChanged(); }
 
             Actor* getActor() const { return actor; }
             void removeFromActor();
@@ -70,6 +74,8 @@ namespace ouzel
         protected:
             virtual void setLayer(Layer* newLayer);
             virtual void updateTransform();
+            // must be called after the bounding box has changed
+            void boundingBoxChanged();
 
             uint32_t type;
 
@@ -2,6 +2,7 @@
 // This file is part of the Ouzel engine.
 
 #include <algorithm>
+#include <limits>
 #include "Layer.hpp"
 #include "core/Engine.hpp"
 #include "Actor.hpp"
@@ -32,17 +33,122 @@ namespace ouzel
 
         void Layer::draw()
         {
+            if (!culled)
+            {
+                prepareDraw();
+
+                for (uint32_t i = 1; i < cameras.size(); ++i)
+                {
+                    cull(i);
+                }
+            }
+
+            submitDraw();
+        }
+
+        void Layer::prepareDraw()
+        {
+            if (transformHierarchy)
+            {
+                transformHierarchy->update();
+            }
+
+            if (spatialIndex)
+            {
+                spatialIndex->update();
+            }
+
+            // the matrices of the cameras are calculated lazily, calculate them before the cameras are culled in parallel
             for (Camera* camera : cameras)
             {
-                std::vector<Actor*> drawQueue;
+                camera->getViewProjectionVersion();
+                camera->getInverseViewProjection();
+            }
+
+            drawLists.resize(cameras.size());
+
+            // the first camera updates the transforms of the actors that are not in the transform hierarchy,
+            // so that the other cameras only read them
+            if (!cameras.empty())
+            {
+                cull(0);
+            }
+        }
+
+        void Layer::cull(uint32_t cameraIndex)
+        {
+            Camera* camera = cameras[cameraIndex];
+            DrawList& drawList = drawLists[cameraIndex];
+            std::vector<Actor*>& drawQueue = drawList.actors;
+
+            drawQueue.clear();
+
+            if (spatialIndex)
+            {
+                spatialIndex->query(camera->getViewBoundingBox(), drawQueue);
+
+                // the actors with culling disabled are added separately
+                drawQueue.erase(std::remove_if(drawQueue.begin(), drawQueue.end(), [](Actor* actor) {
+                    return actor->isCullDisabled();
+                }), drawQueue.end());
 
+                // the tree returns the candidates, cull their world bounding boxes with the frustum in one batch
+                drawList.boundingBoxes.clear();
+                for (Actor* actor : drawQueue)
+                {
+                    drawList.boundingBoxes.push_back(actor->spatialBoundingBox);
+                }
+
+                uint32_t candidateCount = static_cast<uint32_t>(drawQueue.size());
+                drawList.visibilityMask.resize((candidateCount + 31) / 32);
+                camera->checkVisibility(drawList.boundingBoxes.data(), candidateCount, drawList.visibilityMask.data());
+
+                uint32_t visibleCount = 0;
+                for (uint32_t i = 0; i < candidateCount; ++i)
+                {
+                    if (drawList.visibilityMask[i / 32] & (1U << (i % 32)))
+                    {
+                        drawQueue[visibleCount++] = drawQueue[i];
+                    }
+                }
+
+                drawQueue.resize(visibleCount);
+
+                const std::vector<Actor*>& unculledActors = spatialIndex->getUnculledActors();
+                drawQueue.insert(drawQueue.end(), unculledActors.begin(), unculledActors.end());
+            }
+            else
+            {
                 for (Actor* actor : children)
                 {
                     actor->visit(drawQueue, Matrix4::IDENTITY, false, camera, 0, false);
                 }
+            }
 
-                for (Actor* actor : drawQueue)
+            sortDrawQueue(drawList, spatialIndex != nullptr);
+        }
+
+        void Layer::submitDraw()
+        {
+            graphics::Renderer* renderer = sharedEngine->getRenderer();
+
+            for (uint32_t cameraIndex = 0; cameraIndex < cameras.size(); ++cameraIndex)
+            {
+                Camera* camera = cameras[cameraIndex];
+                const std::vector<Actor*>& drawQueue = drawLists[cameraIndex].actors;
+
+                renderer->beginOrderGroup();
+
+                for (auto i = drawQueue.begin(); i != drawQueue.end(); ++i)
                 {
+                    Actor* actor = *i;
+
+                    // actors with the same world order can be reordered by the renderer
+                    if (i != drawQueue.begin() && (*(i - 1))->getWorldOrder() != actor->getWorldOrder())
+                    {
+                        renderer->beginOrderGroup();
+                    }
+
                     actor->draw(camera, false);
 
                     if (camera->getWireframe())
@@ -53,6 +159,197 @@ namespace ouzel
             }
         }
 
+        void Layer::sortDrawQueue(DrawList& drawList, bool drawIndices)
+        {
+            std::vector<Actor*>& drawQueue = drawList.actors;
+            const uint32_t count = static_cast<uint32_t>(drawQueue.size());
+
+            if (count < 2) return;
+
+            std::vector<DrawQueueEntry>& drawQueueEntries = drawList.entries;
+            std::vector<DrawQueueEntry>& sortBuffer = drawList.sortBuffer;
+            drawQueueEntries.resize(count);
+            sortBuffer.resize(count);
+
+            uint32_t histograms[8][256] = {};
+
+            // the draw index is in the low 32 bits, its passes are skipped if it is not used
+            uint32_t firstPass = drawIndices ? 0 : 4;
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                Actor* actor = drawQueue[i];
+
+                // flip the sign bit so that the signed order sorts as unsigned and invert it to get the descending order
+                uint64_t key = static_cast<uint64_t>(~(static_cast<uint32_t>(actor->worldOrder) ^ 0x80000000)) << 32;
+                if (drawIndices) key |= actor->spatialDrawIndex;
+
+                drawQueueEntries[i].key = key;
+                drawQueueEntries[i].actor = actor;
+
+                for (uint32_t pass = firstPass; pass < 8; ++pass)
+                {
+                    ++histograms[pass][(key >> (pass * 8)) & 0xFF];
+                }
+            }
+
+            DrawQueueEntry* source = drawQueueEntries.data();
+            DrawQueueEntry* destination = sortBuffer.data();
+
+            // least significant digit first, every pass is stable
+            for (uint32_t pass = firstPass; pass < 8; ++pass)
+            {
+                uint32_t* histogram = histograms[pass];
+                uint32_t shift = pass * 8;
+
+                // all the keys have the same digit, this pass would not change the order
+                if (histogram[(source[0].key >> shift) & 0xFF] == count) continue;
+
+                uint32_t offset = 0;
+                for (uint32_t digit = 0; digit < 256; ++digit)
+                {
+                    uint32_t digitCount = histogram[digit];
+                    histogram[digit] = offset;
+                    offset += digitCount;
+                }
+
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    destination[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+                }
+
+                std::swap(source, destination);
+            }
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                drawQueue[i] = source[i].actor;
+            }
+        }
+
+        void Layer::setTransformHierarchyEnabled(bool enabled)
+        {
+            if (enabled)
+            {
+                if (!transformHierarchy) transformHierarchy.reset(new TransformHierarchy(this));
+            }
+            else
+            {
+                transformHierarchy.reset();
+            }
+        }
+
+        void Layer::setSpatialIndexEnabled(bool enabled)
+        {
+            if (enabled)
+            {
+                if (!spatialIndex) spatialIndex.reset(new SpatialIndex(this));
+            }
+            else
+            {
+                spatialIndex.reset();
+            }
+        }
+
+        // the spatial index returns the actors in tree order, so the actors with the same world order are sorted
+        // by their pre-order index like the draw queue, the topmost (drawn last) first
+        static Actor* getPickedActor(Actor* actor) { return actor; }
+        static Actor* getPickedActor(const std::pair<Actor*, Vector3>& result) { return result.first; }
+
+        template<class T>
+        static void sortPickedActors(std::vector<T>& picked)
+        {
+            std::stable_sort(picked.begin(), picked.end(), [](const T& a, const T& b) {
+                const Actor* actorA = getPickedActor(a);
+                const Actor* actorB = getPickedActor(b);
+                if (actorA->getWorldOrder() != actorB->getWorldOrder()) return actorA->getWorldOrder() < actorB->getWorldOrder();
+                return SpatialIndex::getDrawIndex(actorA) > SpatialIndex::getDrawIndex(actorB);
+            });
+        }
+
+        void Layer::findActors(const Vector2& position, std::vector<std::pair<Actor*, Vector3>>& actors) const
+        {
+            if (!spatialIndex)
+            {
+                ActorContainer::findActors(position, actors);
+                return;
+            }
+
+            spatialIndex->update();
+
+            std::vector<Actor*> candidates;
+            spatialIndex->query(Box3(Vector3(position.x, position.y, std::numeric_limits<float>::lowest()),
+                                     Vector3(position.x, position.y, std::numeric_limits<float>::max())), candidates);
+
+            std::vector<std::pair<Actor*, Vector3>> picked;
+
+            for (Actor* actor : candidates)
+            {
+                if (actor->isPickable() && actor->pointOn(position))
+                {
+                    picked.push_back(std::make_pair(actor, actor->convertWorldToLocal(position)));
+                }
+            }
+
+            sortPickedActors(picked);
+
+            for (const std::pair<Actor*, Vector3>& result : picked)
+            {
+                auto upperBound = std::upper_bound(actors.begin(), actors.end(), result,
+                                                   [](const std::pair<Actor*, Vector3>& a,
+                                                      const std::pair<Actor*, Vector3>& b) {
+                                                       return a.first->getWorldOrder() < b.first->getWorldOrder();
+                                                   });
+
+                actors.insert(upperBound, result);
+            }
+        }
+
+        void Layer::findActors(const std::vector<Vector2>& edges, std::vector<Actor*>& actors) const
+        {
+            if (!spatialIndex)
+            {
+                ActorContainer::findActors(edges, actors);
+                return;
+            }
+
+            spatialIndex->update();
+
+            Box3 box;
+            for (const Vector2& edge : edges)
+            {
+                box.insertPoint(edge);
+            }
+
+            box.min.z = std::numeric_limits<float>::lowest();
+            box.max.z = std::numeric_limits<float>::max();
+
+            std::vector<Actor*> candidates;
+            spatialIndex->query(box, candidates);
+
+            std::vector<Actor*> picked;
+
+            for (Actor* actor : candidates)
+            {
+                if (actor->isPickable() && actor->shapeOverlaps(edges))
+                {
+                    picked.push_back(actor);
+                }
+            }
+
+            sortPickedActors(picked);
+
+            for (Actor* actor : picked)
+            {
+                auto upperBound = std::upper_bound(actors.begin(), actors.end(), actor,
+                                                   [](Actor* a, Actor* b) {
+                                                       return a->getWorldOrder() < b->getWorldOrder();
+                                                   });
+
+                actors.insert(upperBound, actor);
+            }
+        }
+
         void Layer::addChildActor(Actor* actor)
         {
             ActorContainer::addChildActor(actor);
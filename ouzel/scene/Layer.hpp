@@ -4,8 +4,11 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include "scene/ActorContainer.hpp"
+#include "scene/SpatialIndex.hpp"
+#include "scene/TransformHierarchy.hpp"
 #include "math/Vector2.hpp"
 
 namespace ouzel
@@ -24,6 +27,7 @@ namespace ouzel
             Layer();
             virtual ~Layer();
 
+            // the entry point of drawing, runs the stages that the scene has not already run in parallel and submits the draw calls
             virtual void draw();
 
             const std::vector<Camera*>& getCameras() const { return cameras; }
@@ -38,6 +42,19 @@ namespace ouzel
             Scene* getScene() const { return scene; }
             void removeFromScene();
 
+            // keeps the transforms of the actors in contiguous arrays and updates them in one pass before drawing
+            void setTransformHierarchyEnabled(bool enabled);
+            bool isTransformHierarchyEnabled() const { return transformHierarchy != nullptr; }
+            TransformHierarchy* getTransformHierarchy() const { return transformHierarchy.get(); }
+
+            // culls and picks the actors with a bounding volume tree instead of visiting all of them
+            void setSpatialIndexEnabled(bool enabled);
+            bool isSpatialIndexEnabled() const { return spatialIndex != nullptr; }
+            SpatialIndex* getSpatialIndex() const { return spatialIndex.get(); }
+
+            virtual void findActors(const Vector2& position, std::vector<std::pair<Actor*, Vector3>>& actors) const override;
+            virtual void findActors(const std::vector<Vector2>& edges, std::vector<Actor*>& actors) const override;
+
         protected:
             virtual void addChildActor(Actor* actor) override;
 
@@ -47,11 +64,43 @@ namespace ouzel
             virtual void recalculateProjection();
             virtual void enter() override;
 
+            // the scene prepares the layers in parallel and then culls all their cameras in parallel before calling draw,
+            // the first camera is culled by prepareDraw
+            virtual void prepareDraw();
+            virtual void cull(uint32_t cameraIndex);
+            virtual void submitDraw();
+
+            struct DrawQueueEntry
+            {
+                uint64_t key;
+                Actor* actor;
+            };
+
+            // reused between frames to avoid allocations
+            struct DrawList
+            {
+                std::vector<Actor*> actors;
+                std::vector<DrawQueueEntry> entries;
+                std::vector<DrawQueueEntry> sortBuffer;
+                std::vector<Box3> boundingBoxes;
+                std::vector<uint32_t> visibilityMask;
+            };
+
+            // stable sort of the draw queue by the descending world order, the spatial index returns the actors in tree order,
+            // so with drawIndices the actors with the same world order are sorted by their pre-order index in the layer
+            static void sortDrawQueue(DrawList& drawList, bool drawIndices);
+
             Scene* scene = nullptr;
 
             std::vector<Camera*> cameras;
 
             int32_t order = 0;
+
+            std::unique_ptr<TransformHierarchy> transformHierarchy;
+            std::unique_ptr<SpatialIndex> spatialIndex;
+
+            std::vector<DrawList> drawLists; // one for every camera
+            bool culled = false; // set by the scene after it culled the cameras of the layer
         };
     } // namespace scene
 } // namespace ouzel
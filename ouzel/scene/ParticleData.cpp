@@ -0,0 +1,595 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <cmath>
+#include "ParticleData.hpp"
+#include "core/Setup.h"
+#include "math/MathUtils.hpp"
+#if OUZEL_SUPPORTS_SSE
+#include <xmmintrin.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define OUZEL_PARTICLE_DATA_SSE2 1
+#endif
+#elif (OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define OUZEL_PARTICLE_DATA_NEON 1
+#endif
+
+namespace ouzel
+{
+    namespace scene
+    {
+        static inline float wrapAngle(float angle)
+        {
+            if (angle > PI) angle -= PIX2;
+            else if (angle < -PI) angle += PIX2;
+            return angle;
+        }
+
+#if OUZEL_SUPPORTS_SSE
+        // the angle must not be more than 2 pi out of the range [-pi, pi]
+        static inline __m128 wrapAngle(__m128 angle)
+        {
+            const __m128 pix2 = _mm_set1_ps(PIX2);
+            angle = _mm_sub_ps(angle, _mm_and_ps(_mm_cmpgt_ps(angle, _mm_set1_ps(PI)), pix2));
+            return _mm_add_ps(angle, _mm_and_ps(_mm_cmplt_ps(angle, _mm_set1_ps(-PI)), pix2));
+        }
+
+        // polynomial approximation of the sine in the range [-pi, pi]
+        static inline __m128 sine(__m128 x)
+        {
+            // reflect into the range [-pi/2, pi/2]
+            x = _mm_min_ps(x, _mm_sub_ps(_mm_set1_ps(PI), x));
+            x = _mm_max_ps(x, _mm_sub_ps(_mm_set1_ps(-PI), x));
+
+            __m128 x2 = _mm_mul_ps(x, x);
+            __m128 result = _mm_add_ps(_mm_set1_ps(-1.0f / 5040.0f), _mm_mul_ps(x2, _mm_set1_ps(1.0f / 362880.0f)));
+            result = _mm_add_ps(_mm_set1_ps(1.0f / 120.0f), _mm_mul_ps(x2, result));
+            result = _mm_add_ps(_mm_set1_ps(-1.0f / 6.0f), _mm_mul_ps(x2, result));
+            result = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(x2, result));
+            return _mm_mul_ps(x, result);
+        }
+
+        // reduces any angle to the range [-pi, pi]
+        static inline __m128 reduceAngle(__m128 angle)
+        {
+            // adding and subtracting 1.5 * 2^23 rounds to the nearest integer
+            const __m128 magic = _mm_set1_ps(12582912.0f);
+            __m128 turns = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(angle, _mm_set1_ps(1.0f / PIX2)), magic), magic);
+            return _mm_sub_ps(angle, _mm_mul_ps(turns, _mm_set1_ps(PIX2)));
+        }
+#elif OUZEL_PARTICLE_DATA_NEON
+        static inline float32x4_t wrapAngle(float32x4_t angle)
+        {
+            const uint32x4_t pix2 = vreinterpretq_u32_f32(vdupq_n_f32(PIX2));
+            angle = vsubq_f32(angle, vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(angle, vdupq_n_f32(PI)), pix2)));
+            return vaddq_f32(angle, vreinterpretq_f32_u32(vandq_u32(vcltq_f32(angle, vdupq_n_f32(-PI)), pix2)));
+        }
+
+        static inline float32x4_t sine(float32x4_t x)
+        {
+            x = vminq_f32(x, vsubq_f32(vdupq_n_f32(PI), x));
+            x = vmaxq_f32(x, vsubq_f32(vdupq_n_f32(-PI), x));
+
+            float32x4_t x2 = vmulq_f32(x, x);
+            float32x4_t result = vmlaq_n_f32(vdupq_n_f32(-1.0f / 5040.0f), x2, 1.0f / 362880.0f);
+            result = vmlaq_f32(vdupq_n_f32(1.0f / 120.0f), x2, result);
+            result = vmlaq_f32(vdupq_n_f32(-1.0f / 6.0f), x2, result);
+            result = vmlaq_f32(vdupq_n_f32(1.0f), x2, result);
+            return vmulq_f32(x, result);
+        }
+
+        static inline float32x4_t reduceAngle(float32x4_t angle)
+        {
+            const float32x4_t magic = vdupq_n_f32(12582912.0f);
+            float32x4_t turns = vsubq_f32(vmlaq_n_f32(magic, angle, 1.0f / PIX2), magic);
+            return vmlsq_n_f32(angle, turns, PIX2);
+        }
+#endif
+
+        // texture coordinates of the quad corners in the order they are written
+        static const Vector2 TEX_COORDS[4] = {
+            Vector2(0.0f, 1.0f), Vector2(1.0f, 1.0f), Vector2(0.0f, 0.0f), Vector2(1.0f, 0.0f)
+        };
+
+        static inline void setVertex(graphics::VertexPCT& vertex, float x, float y, uint32_t color, const Vector2& texCoord)
+        {
+            vertex.position.x = x;
+            vertex.position.y = y;
+            vertex.position.z = 0.0f;
+            vertex.color.r = static_cast<uint8_t>(color);
+            vertex.color.g = static_cast<uint8_t>(color >> 8);
+            vertex.color.b = static_cast<uint8_t>(color >> 16);
+            vertex.color.a = static_cast<uint8_t>(color >> 24);
+            vertex.texCoord = texCoord;
+        }
+
+        // red in the lowest byte
+        static inline uint32_t packColor(float red, float green, float blue, float alpha)
+        {
+            return static_cast<uint32_t>(clamp(red, 0.0f, 1.0f) * 255.0f) |
+                (static_cast<uint32_t>(clamp(green, 0.0f, 1.0f) * 255.0f) << 8) |
+                (static_cast<uint32_t>(clamp(blue, 0.0f, 1.0f) * 255.0f) << 16) |
+                (static_cast<uint32_t>(clamp(alpha, 0.0f, 1.0f) * 255.0f) << 24);
+        }
+
+        template<class F> void ParticleData::forEachField(F function)
+        {
+            function(life);
+            function(positionX);
+            function(positionY);
+            function(colorRed);
+            function(colorGreen);
+            function(colorBlue);
+            function(colorAlpha);
+            function(deltaColorRed);
+            function(deltaColorGreen);
+            function(deltaColorBlue);
+            function(deltaColorAlpha);
+            function(size);
+            function(deltaSize);
+            function(rotation);
+            function(deltaRotation);
+            function(radialAcceleration);
+            function(tangentialAcceleration);
+            function(directionX);
+            function(directionY);
+            function(angle);
+            function(degreesPerSecond);
+            function(radius);
+            function(deltaRadius);
+        }
+
+        void ParticleData::resize(uint32_t newSize)
+        {
+            forEachField([newSize](std::vector<float>& field) {
+                field.resize(newSize);
+            });
+        }
+
+        void ParticleData::move(uint32_t from, uint32_t to)
+        {
+            forEachField([from, to](std::vector<float>& field) {
+                field[to] = field[from];
+            });
+        }
+
+        uint32_t ParticleData::update(uint32_t count, const ParticleDefinition& definition, float step)
+        {
+            if (definition.emitterType == ParticleDefinition::EmitterType::GRAVITY)
+            {
+                updateGravity(count, definition, step);
+            }
+            else
+            {
+                updateRadius(count, definition, step);
+            }
+
+            updateDeltas(count, step);
+
+            return removeDead(count);
+        }
+
+        void ParticleData::writeVertices(uint32_t count, const Vector2& offset, graphics::VertexPCT* vertices) const
+        {
+            // the corners of a quad are (-p + q, -q - p), (p + q, q - p), (-p - q, -q + p) and (p - q, q + p),
+            // where p = cos(rotation) * size / 2 and q = sin(rotation) * size / 2
+            uint32_t i = 0;
+
+#if OUZEL_PARTICLE_DATA_SSE2 || OUZEL_PARTICLE_DATA_NEON
+            float cornersX[4][4];
+            float cornersY[4][4];
+            uint32_t colors[4];
+#endif
+
+#if OUZEL_PARTICLE_DATA_SSE2
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128 halfPi = _mm_set1_ps(PI_2);
+            const __m128 maxChannel = _mm_set1_ps(255.0f);
+            const __m128 degreesToRadians = _mm_set1_ps(-PI / 180.0f);
+            const __m128 offsetX = _mm_set1_ps(offset.x);
+            const __m128 offsetY = _mm_set1_ps(offset.y);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 rotations = _mm_loadu_ps(rotation.data() + i);
+                __m128 halfSize = _mm_mul_ps(_mm_loadu_ps(size.data() + i), half);
+                __m128 p = halfSize;
+                __m128 q = zero;
+
+                // the sine and cosine are needed only if any of the four particles is rotated
+                if (_mm_movemask_ps(_mm_cmpneq_ps(rotations, zero)))
+                {
+                    __m128 angles = reduceAngle(_mm_mul_ps(rotations, degreesToRadians));
+                    p = _mm_mul_ps(halfSize, sine(wrapAngle(_mm_add_ps(angles, halfPi))));
+                    q = _mm_mul_ps(halfSize, sine(angles));
+                }
+
+                __m128 x = _mm_add_ps(_mm_loadu_ps(positionX.data() + i), offsetX);
+                __m128 y = _mm_add_ps(_mm_loadu_ps(positionY.data() + i), offsetY);
+                __m128 sum = _mm_add_ps(p, q);
+                __m128 difference = _mm_sub_ps(p, q);
+
+                _mm_storeu_ps(cornersX[0], _mm_sub_ps(x, difference));
+                _mm_storeu_ps(cornersY[0], _mm_sub_ps(y, sum));
+                _mm_storeu_ps(cornersX[1], _mm_add_ps(x, sum));
+                _mm_storeu_ps(cornersY[1], _mm_sub_ps(y, difference));
+                _mm_storeu_ps(cornersX[2], _mm_sub_ps(x, sum));
+                _mm_storeu_ps(cornersY[2], _mm_add_ps(y, difference));
+                _mm_storeu_ps(cornersX[3], _mm_add_ps(x, difference));
+                _mm_storeu_ps(cornersY[3], _mm_add_ps(y, sum));
+
+                // four colors are converted to RGBA8 at once
+                __m128i red = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(colorRed.data() + i), maxChannel), zero), maxChannel));
+                __m128i green = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(colorGreen.data() + i), maxChannel), zero), maxChannel));
+                __m128i blue = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(colorBlue.data() + i), maxChannel), zero), maxChannel));
+                __m128i alpha = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(colorAlpha.data() + i), maxChannel), zero), maxChannel));
+
+                __m128i packed = _mm_or_si128(_mm_or_si128(red, _mm_slli_epi32(green, 8)),
+                                              _mm_or_si128(_mm_slli_epi32(blue, 16), _mm_slli_epi32(alpha, 24)));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(colors), packed);
+
+                for (uint32_t j = 0; j < 4; ++j)
+                {
+                    graphics::VertexPCT* quad = vertices + (i + j) * 4;
+
+                    for (uint32_t corner = 0; corner < 4; ++corner)
+                    {
+                        setVertex(quad[corner], cornersX[corner][j], cornersY[corner][j], colors[j], TEX_COORDS[corner]);
+                    }
+                }
+            }
+#elif OUZEL_PARTICLE_DATA_NEON
+            const float32x4_t zero = vdupq_n_f32(0.0f);
+            const float32x4_t halfPi = vdupq_n_f32(PI_2);
+            const float32x4_t maxChannel = vdupq_n_f32(255.0f);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                float32x4_t rotations = vld1q_f32(rotation.data() + i);
+                float32x4_t halfSize = vmulq_n_f32(vld1q_f32(size.data() + i), 0.5f);
+                float32x4_t p = halfSize;
+                float32x4_t q = zero;
+
+                uint32x4_t rotated = vmvnq_u32(vceqq_f32(rotations, zero));
+                uint32x2_t anyRotated = vorr_u32(vget_low_u32(rotated), vget_high_u32(rotated));
+
+                if (vget_lane_u32(anyRotated, 0) | vget_lane_u32(anyRotated, 1))
+                {
+                    float32x4_t angles = reduceAngle(vmulq_n_f32(rotations, -PI / 180.0f));
+                    p = vmulq_f32(halfSize, sine(wrapAngle(vaddq_f32(angles, halfPi))));
+                    q = vmulq_f32(halfSize, sine(angles));
+                }
+
+                float32x4_t x = vaddq_f32(vld1q_f32(positionX.data() + i), vdupq_n_f32(offset.x));
+                float32x4_t y = vaddq_f32(vld1q_f32(positionY.data() + i), vdupq_n_f32(offset.y));
+                float32x4_t sum = vaddq_f32(p, q);
+                float32x4_t difference = vsubq_f32(p, q);
+
+                vst1q_f32(cornersX[0], vsubq_f32(x, difference));
+                vst1q_f32(cornersY[0], vsubq_f32(y, sum));
+                vst1q_f32(cornersX[1], vaddq_f32(x, sum));
+                vst1q_f32(cornersY[1], vsubq_f32(y, difference));
+                vst1q_f32(cornersX[2], vsubq_f32(x, sum));
+                vst1q_f32(cornersY[2], vaddq_f32(y, difference));
+                vst1q_f32(cornersX[3], vaddq_f32(x, difference));
+                vst1q_f32(cornersY[3], vaddq_f32(y, sum));
+
+                uint32x4_t red = vcvtq_u32_f32(vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(colorRed.data() + i), maxChannel), zero), maxChannel));
+                uint32x4_t green = vcvtq_u32_f32(vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(colorGreen.data() + i), maxChannel), zero), maxChannel));
+                uint32x4_t blue = vcvtq_u32_f32(vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(colorBlue.data() + i), maxChannel), zero), maxChannel));
+                uint32x4_t alpha = vcvtq_u32_f32(vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(colorAlpha.data() + i), maxChannel), zero), maxChannel));
+
+                vst1q_u32(colors, vorrq_u32(vorrq_u32(red, vshlq_n_u32(green, 8)),
+                                            vorrq_u32(vshlq_n_u32(blue, 16), vshlq_n_u32(alpha, 24))));
+
+                for (uint32_t j = 0; j < 4; ++j)
+                {
+                    graphics::VertexPCT* quad = vertices + (i + j) * 4;
+
+                    for (uint32_t corner = 0; corner < 4; ++corner)
+                    {
+                        setVertex(quad[corner], cornersX[corner][j], cornersY[corner][j], colors[j], TEX_COORDS[corner]);
+                    }
+                }
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                float halfSize = size[i] / 2.0f;
+                float p = halfSize;
+                float q = 0.0f;
+
+                if (rotation[i] != 0.0f)
+                {
+                    float angle = -degToRad(rotation[i]);
+                    p = halfSize * cosf(angle);
+                    q = halfSize * sinf(angle);
+                }
+
+                float x = positionX[i] + offset.x;
+                float y = positionY[i] + offset.y;
+                uint32_t color = packColor(colorRed[i], colorGreen[i], colorBlue[i], colorAlpha[i]);
+
+                graphics::VertexPCT* quad = vertices + i * 4;
+                setVertex(quad[0], x - p + q, y - q - p, color, TEX_COORDS[0]);
+                setVertex(quad[1], x + p + q, y + q - p, color, TEX_COORDS[1]);
+                setVertex(quad[2], x - p - q, y - q + p, color, TEX_COORDS[2]);
+                setVertex(quad[3], x + p - q, y + q + p, color, TEX_COORDS[3]);
+            }
+        }
+
+        void ParticleData::updateGravity(uint32_t count, const ParticleDefinition& definition, float step)
+        {
+            float* px = positionX.data();
+            float* py = positionY.data();
+            float* dx = directionX.data();
+            float* dy = directionY.data();
+            const float* radialAccelerations = radialAcceleration.data();
+            const float* tangentialAccelerations = tangentialAcceleration.data();
+
+            float positionStep = definition.yCoordFlipped ? step : 0.0f;
+
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_SSE
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 tolerance = _mm_set1_ps(TOLERANCE);
+            const __m128 gravityX = _mm_set1_ps(definition.gravity.x);
+            const __m128 gravityY = _mm_set1_ps(definition.gravity.y);
+            const __m128 stepVector = _mm_set1_ps(step);
+            const __m128 positionStepVector = _mm_set1_ps(positionStep);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 x = _mm_loadu_ps(px + i);
+                __m128 y = _mm_loadu_ps(py + i);
+
+                // radial acceleration only for the positions on an axis
+                __m128 onAxis = _mm_or_ps(_mm_cmpeq_ps(x, zero), _mm_cmpeq_ps(y, zero));
+                __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+                __m128 longEnough = _mm_cmpgt_ps(length, tolerance);
+                __m128 scale = _mm_or_ps(_mm_and_ps(longEnough, _mm_div_ps(one, length)), _mm_andnot_ps(longEnough, one));
+                scale = _mm_and_ps(onAxis, scale);
+
+                __m128 normalX = _mm_mul_ps(x, scale);
+                __m128 normalY = _mm_mul_ps(y, scale);
+
+                __m128 radial = _mm_loadu_ps(radialAccelerations + i);
+                __m128 tangential = _mm_loadu_ps(tangentialAccelerations + i);
+
+                // (gravity + radial + tangential) * step
+                __m128 accelerationX = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(normalX, radial), gravityX), _mm_mul_ps(normalY, tangential));
+                __m128 accelerationY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(normalY, radial), gravityY), _mm_mul_ps(normalX, tangential));
+
+                __m128 directionXVector = _mm_add_ps(_mm_loadu_ps(dx + i), _mm_mul_ps(accelerationX, stepVector));
+                __m128 directionYVector = _mm_add_ps(_mm_loadu_ps(dy + i), _mm_mul_ps(accelerationY, stepVector));
+                _mm_storeu_ps(dx + i, directionXVector);
+                _mm_storeu_ps(dy + i, directionYVector);
+
+                _mm_storeu_ps(px + i, _mm_add_ps(x, _mm_mul_ps(directionXVector, positionStepVector)));
+                _mm_storeu_ps(py + i, _mm_add_ps(y, _mm_mul_ps(directionYVector, positionStepVector)));
+            }
+#elif OUZEL_PARTICLE_DATA_NEON
+            const float32x4_t zero = vdupq_n_f32(0.0f);
+            const float32x4_t one = vdupq_n_f32(1.0f);
+            const float32x4_t tolerance = vdupq_n_f32(TOLERANCE);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                float32x4_t x = vld1q_f32(px + i);
+                float32x4_t y = vld1q_f32(py + i);
+
+                uint32x4_t onAxis = vorrq_u32(vceqq_f32(x, zero), vceqq_f32(y, zero));
+                float32x4_t lengthSquared = vmlaq_f32(vmulq_f32(x, x), y, y);
+
+                // reciprocal square root refined with two Newton-Raphson steps
+                float32x4_t inverseLength = vrsqrteq_f32(lengthSquared);
+                inverseLength = vmulq_f32(inverseLength, vrsqrtsq_f32(vmulq_f32(lengthSquared, inverseLength), inverseLength));
+                inverseLength = vmulq_f32(inverseLength, vrsqrtsq_f32(vmulq_f32(lengthSquared, inverseLength), inverseLength));
+
+                uint32x4_t longEnough = vcgtq_f32(lengthSquared, vmulq_f32(tolerance, tolerance));
+                float32x4_t scale = vbslq_f32(longEnough, inverseLength, one);
+                scale = vreinterpretq_f32_u32(vandq_u32(onAxis, vreinterpretq_u32_f32(scale)));
+
+                float32x4_t normalX = vmulq_f32(x, scale);
+                float32x4_t normalY = vmulq_f32(y, scale);
+
+                float32x4_t radial = vld1q_f32(radialAccelerations + i);
+                float32x4_t tangential = vld1q_f32(tangentialAccelerations + i);
+
+                float32x4_t accelerationX = vmlsq_f32(vmlaq_f32(vdupq_n_f32(definition.gravity.x), normalX, radial), normalY, tangential);
+                float32x4_t accelerationY = vmlaq_f32(vmlaq_f32(vdupq_n_f32(definition.gravity.y), normalY, radial), normalX, tangential);
+
+                float32x4_t directionXVector = vmlaq_n_f32(vld1q_f32(dx + i), accelerationX, step);
+                float32x4_t directionYVector = vmlaq_n_f32(vld1q_f32(dy + i), accelerationY, step);
+                vst1q_f32(dx + i, directionXVector);
+                vst1q_f32(dy + i, directionYVector);
+
+                vst1q_f32(px + i, vmlaq_n_f32(x, directionXVector, positionStep));
+                vst1q_f32(py + i, vmlaq_n_f32(y, directionYVector, positionStep));
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                float normalX = 0.0f;
+                float normalY = 0.0f;
+
+                if (px[i] == 0.0f || py[i] == 0.0f)
+                {
+                    Vector2 normal(px[i], py[i]);
+                    normal.normalize();
+                    normalX = normal.x;
+                    normalY = normal.y;
+                }
+
+                float accelerationX = normalX * radialAccelerations[i] - normalY * tangentialAccelerations[i] + definition.gravity.x;
+                float accelerationY = normalY * radialAccelerations[i] + normalX * tangentialAccelerations[i] + definition.gravity.y;
+
+                dx[i] += accelerationX * step;
+                dy[i] += accelerationY * step;
+                px[i] += dx[i] * positionStep;
+                py[i] += dy[i] * positionStep;
+            }
+        }
+
+        void ParticleData::updateRadius(uint32_t count, const ParticleDefinition& definition, float step)
+        {
+            float* px = positionX.data();
+            float* py = positionY.data();
+            float* angles = angle.data();
+            float* radiuses = radius.data();
+            const float* angleDeltas = degreesPerSecond.data();
+            const float* radiusDeltas = deltaRadius.data();
+
+            float yScale = definition.yCoordFlipped ? 1.0f : 0.0f;
+
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_SSE
+            const __m128 stepVector = _mm_set1_ps(step);
+            const __m128 halfPi = _mm_set1_ps(PI_2);
+            const __m128 signBit = _mm_set1_ps(-0.0f);
+            const __m128 yScaleVector = _mm_set1_ps(yScale);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 a = wrapAngle(_mm_add_ps(_mm_loadu_ps(angles + i), _mm_mul_ps(_mm_loadu_ps(angleDeltas + i), stepVector)));
+                __m128 r = _mm_add_ps(_mm_loadu_ps(radiuses + i), _mm_mul_ps(_mm_loadu_ps(radiusDeltas + i), stepVector));
+                _mm_storeu_ps(angles + i, a);
+                _mm_storeu_ps(radiuses + i, r);
+
+                // negated radius, cos(a) = sin(a + pi/2)
+                __m128 negativeRadius = _mm_xor_ps(r, signBit);
+                _mm_storeu_ps(px + i, _mm_mul_ps(sine(wrapAngle(_mm_add_ps(a, halfPi))), negativeRadius));
+                _mm_storeu_ps(py + i, _mm_mul_ps(_mm_mul_ps(sine(a), negativeRadius), yScaleVector));
+            }
+#elif OUZEL_PARTICLE_DATA_NEON
+            const float32x4_t halfPi = vdupq_n_f32(PI_2);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                float32x4_t a = wrapAngle(vmlaq_n_f32(vld1q_f32(angles + i), vld1q_f32(angleDeltas + i), step));
+                float32x4_t r = vmlaq_n_f32(vld1q_f32(radiuses + i), vld1q_f32(radiusDeltas + i), step);
+                vst1q_f32(angles + i, a);
+                vst1q_f32(radiuses + i, r);
+
+                float32x4_t negativeRadius = vnegq_f32(r);
+                vst1q_f32(px + i, vmulq_f32(sine(wrapAngle(vaddq_f32(a, halfPi))), negativeRadius));
+                vst1q_f32(py + i, vmulq_n_f32(vmulq_f32(sine(a), negativeRadius), yScale));
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                angles[i] = wrapAngle(angles[i] + angleDeltas[i] * step);
+                radiuses[i] += radiusDeltas[i] * step;
+                px[i] = -cosf(angles[i]) * radiuses[i];
+                py[i] = -sinf(angles[i]) * radiuses[i] * yScale;
+            }
+        }
+
+        void ParticleData::updateDeltas(uint32_t count, float step)
+        {
+            float* values[] = {colorRed.data(), colorGreen.data(), colorBlue.data(), colorAlpha.data(), rotation.data()};
+            const float* deltas[] = {deltaColorRed.data(), deltaColorGreen.data(), deltaColorBlue.data(), deltaColorAlpha.data(), deltaRotation.data()};
+            float* lives = life.data();
+            float* sizes = size.data();
+            const float* sizeDeltas = deltaSize.data();
+
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_SSE
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 stepVector = _mm_set1_ps(step);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                _mm_storeu_ps(lives + i, _mm_sub_ps(_mm_loadu_ps(lives + i), stepVector));
+                _mm_storeu_ps(sizes + i, _mm_max_ps(zero, _mm_add_ps(_mm_loadu_ps(sizes + i), _mm_mul_ps(_mm_loadu_ps(sizeDeltas + i), stepVector))));
+
+                for (uint32_t field = 0; field < 5; ++field)
+                {
+                    _mm_storeu_ps(values[field] + i, _mm_add_ps(_mm_loadu_ps(values[field] + i), _mm_mul_ps(_mm_loadu_ps(deltas[field] + i), stepVector)));
+                }
+            }
+#elif OUZEL_PARTICLE_DATA_NEON
+            const float32x4_t zero = vdupq_n_f32(0.0f);
+            const float32x4_t stepVector = vdupq_n_f32(step);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                vst1q_f32(lives + i, vsubq_f32(vld1q_f32(lives + i), stepVector));
+                vst1q_f32(sizes + i, vmaxq_f32(zero, vmlaq_n_f32(vld1q_f32(sizes + i), vld1q_f32(sizeDeltas + i), step)));
+
+                for (uint32_t field = 0; field < 5; ++field)
+                {
+                    vst1q_f32(values[field] + i, vmlaq_n_f32(vld1q_f32(values[field] + i), vld1q_f32(deltas[field] + i), step));
+                }
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                lives[i] -= step;
+                sizes[i] = std::max(0.0f, sizes[i] + sizeDeltas[i] * step);
+
+                for (uint32_t field = 0; field < 5; ++field)
+                {
+                    values[field][i] += deltas[field][i] * step;
+                }
+            }
+        }
+
+        uint32_t ParticleData::removeDead(uint32_t count)
+        {
+            const float* lives = life.data();
+
+            uint32_t i = 0;
+
+            while (i < count)
+            {
+                // skip four live particles at once
+#if OUZEL_SUPPORTS_SSE
+                if (i + 4 <= count &&
+                    !_mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(lives + i), _mm_setzero_ps())))
+                {
+                    i += 4;
+                    continue;
+                }
+#elif OUZEL_PARTICLE_DATA_NEON
+                if (i + 4 <= count)
+                {
+                    uint32x4_t dead = vcltq_f32(vld1q_f32(lives + i), vdupq_n_f32(0.0f));
+                    uint32x2_t anyDead = vorr_u32(vget_low_u32(dead), vget_high_u32(dead));
+
+                    if (!(vget_lane_u32(anyDead, 0) | vget_lane_u32(anyDead, 1)))
+                    {
+                        i += 4;
+                        continue;
+                    }
+                }
+#endif
+
+                if (lives[i] < 0.0f)
+                {
+                    // the last particle takes the place of the dead one and is checked next
+                    --count;
+                    if (i != count) move(count, i);
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+
+            return count;
+        }
+    } // namespace scene
+} // namespace ouzel
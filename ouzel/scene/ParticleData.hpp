@@ -0,0 +1,74 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "scene/ParticleDefinition.hpp"
+#include "math/Vector2.hpp"
+#include "graphics/Vertex.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // particle state stored as structure of arrays, so that four particles are updated at once
+        class ParticleData
+        {
+        public:
+            void resize(uint32_t newSize);
+            uint32_t getSize() const { return static_cast<uint32_t>(life.size()); }
+
+            // moves the particle at index from to index to
+            void move(uint32_t from, uint32_t to);
+
+            // advances the first count particles by step seconds, removes the dead ones and returns the number of the live particles
+            uint32_t update(uint32_t count, const ParticleDefinition& definition, float step);
+
+            // writes a quad of four vertices for each of the first count particles, offset is added to every position
+            void writeVertices(uint32_t count, const Vector2& offset, graphics::VertexPCT* vertices) const;
+
+            std::vector<float> life;
+
+            std::vector<float> positionX;
+            std::vector<float> positionY;
+
+            std::vector<float> colorRed;
+            std::vector<float> colorGreen;
+            std::vector<float> colorBlue;
+            std::vector<float> colorAlpha;
+
+            std::vector<float> deltaColorRed;
+            std::vector<float> deltaColorGreen;
+            std::vector<float> deltaColorBlue;
+            std::vector<float> deltaColorAlpha;
+
+            std::vector<float> size;
+            std::vector<float> deltaSize;
+
+            std::vector<float> rotation;
+            std::vector<float> deltaRotation;
+
+            // gravity emitter
+            std::vector<float> radialAcceleration;
+            std::vector<float> tangentialAcceleration;
+            std::vector<float> directionX;
+            std::vector<float> directionY;
+
+            // radius emitter
+            std::vector<float> angle; // radians, kept in the range [-pi, pi]
+            std::vector<float> degreesPerSecond; // radians
+            std::vector<float> radius;
+            std::vector<float> deltaRadius;
+
+        protected:
+            template<class F> void forEachField(F function);
+
+            void updateGravity(uint32_t count, const ParticleDefinition& definition, float step);
+            void updateRadius(uint32_t count, const ParticleDefinition& definition, float step);
+            void updateDeltas(uint32_t count, float step);
+            uint32_t removeDead(uint32_t count);
+        };
+    } // namespace scene
+} // namespace ouzel
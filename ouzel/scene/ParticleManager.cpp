@@ -0,0 +1,98 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include "ParticleManager.hpp"
+#include "ParticleSystem.hpp"
+#include "core/Engine.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        ParticleManager::~ParticleManager()
+        {
+            for (ParticleSystem* particleSystem : particleSystems)
+            {
+                particleSystem->manager = nullptr;
+            }
+        }
+
+        void ParticleManager::addParticleSystem(ParticleSystem* particleSystem)
+        {
+            if (particleSystem->manager) particleSystem->manager->removeParticleSystem(particleSystem);
+
+            particleSystem->manager = this;
+            particleSystems.push_back(particleSystem);
+        }
+
+        void ParticleManager::removeParticleSystem(ParticleSystem* particleSystem)
+        {
+            auto i = std::find(particleSystems.begin(), particleSystems.end(), particleSystem);
+
+            if (i != particleSystems.end())
+            {
+                // the order of the particle systems does not matter
+                *i = particleSystems.back();
+                particleSystems.pop_back();
+                particleSystem->manager = nullptr;
+            }
+        }
+
+        void ParticleManager::update(float delta, bool generateMeshes)
+        {
+            if (particleSystems.empty()) return;
+
+            JobSystem* jobSystem = sharedEngine->getJobSystem();
+
+            // the actor transforms are read on the update thread
+            for (ParticleSystem* particleSystem : particleSystems)
+            {
+                particleSystem->prepareUpdate();
+            }
+
+            jobSystem->parallelFor(static_cast<uint32_t>(particleSystems.size()), [this, delta](uint32_t index) {
+                particleSystems[index]->simulate(delta);
+            }, 1);
+
+            // the streaming memory can be reserved only on the update thread, but it is filled on the worker threads,
+            // the device arena grows by new chunks, so the memory reserved for one system does not move when the next one reserves
+            meshJobs.clear();
+
+            if (generateMeshes)
+            {
+                for (ParticleSystem* particleSystem : particleSystems)
+                {
+                    if (particleSystem->needsMeshUpdate)
+                    {
+                        if (graphics::VertexPCT* vertices = particleSystem->reserveVertices())
+                        {
+                            meshJobs.push_back(std::make_pair(particleSystem, vertices));
+                        }
+                    }
+                }
+
+                jobSystem->parallelFor(static_cast<uint32_t>(meshJobs.size()), [this](uint32_t index) {
+                    meshJobs[index].first->writeVertices(meshJobs[index].second);
+                }, 1);
+            }
+
+            // the finished particle systems are removed
+            for (uint32_t i = 0; i < particleSystems.size();)
+            {
+                ParticleSystem* particleSystem = particleSystems[i];
+
+                if (particleSystem->finishUpdate())
+                {
+                    ++i;
+                }
+                else
+                {
+                    particleSystems[i] = particleSystems.back();
+                    particleSystems.pop_back();
+                    particleSystem->manager = nullptr;
+                }
+            }
+        }
+    } // namespace scene
+} // namespace ouzel
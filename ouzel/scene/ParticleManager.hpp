@@ -0,0 +1,34 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <utility>
+#include <vector>
+#include "utils/Noncopyable.hpp"
+#include "graphics/Vertex.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        class ParticleSystem;
+
+        // simulates all the active particle systems in parallel on the worker threads of the job system
+        class ParticleManager: public Noncopyable
+        {
+        public:
+            ~ParticleManager();
+
+            void addParticleSystem(ParticleSystem* particleSystem);
+            void removeParticleSystem(ParticleSystem* particleSystem);
+
+            // called by the update thread, the meshes are generated in the same pass if the frame is going to be drawn
+            void update(float delta, bool generateMeshes);
+
+        protected:
+            std::vector<ParticleSystem*> particleSystems;
+            std::vector<std::pair<ParticleSystem*, graphics::VertexPCT*>> meshJobs;
+        };
+    } // namespace scene
+} // namespace ouzel
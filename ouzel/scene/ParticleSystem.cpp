@@ -6,6 +6,7 @@
 #include "ParticleSystem.hpp"
 #include "core/Engine.hpp"
 #include "SceneManager.hpp"
+#include "ParticleManager.hpp"
 #include "files/FileSystem.hpp"
 #include "core/Cache.hpp"
 #include "Layer.hpp"
@@ -20,13 +21,11 @@ namespace ouzel
     namespace scene
     {
         ParticleSystem::ParticleSystem():
-            Component(TYPE)
+            Component(TYPE), randomEngine(ouzel::randomEngine())
         {
             shader = sharedEngine->getCache()->getShader(graphics::SHADER_TEXTURE);
             blendState = sharedEngine->getCache()->getBlendState(graphics::BLEND_ALPHA);
             whitePixelTexture = sharedEngine->getCache()->getTexture(graphics::TEXTURE_WHITE_PIXEL);
-
-            updateCallback.callback = std::bind(&ParticleSystem::update, this, std::placeholders::_1);
         }
 
         ParticleSystem::ParticleSystem(const std::string& filename):
@@ -35,6 +34,11 @@ namespace ouzel
             init(filename);
         }
 
+        ParticleSystem::~ParticleSystem()
+        {
+            if (manager) manager->removeParticleSystem(this);
+        }
+
         void ParticleSystem::draw(const Matrix4& transformMatrix,
                                   float opacity,
                                   const Matrix4& renderViewProjection,
@@ -79,16 +83,10 @@ namespace ouzel
 
                 float colorVector[] = {1.0f, 1.0f, 1.0f, opacity};
 
-                std::vector<std::vector<float>> pixelShaderConstants(1);
-                pixelShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-                std::vector<std::vector<float>> vertexShaderConstants(1);
-                vertexShaderConstants[0] = {std::begin(transform.m), std::end(transform.m)};
-
                 sharedEngine->getRenderer()->addDrawCommand({wireframe ? whitePixelTexture : texture},
                                                             shader,
-                                                            pixelShaderConstants,
-                                                            vertexShaderConstants,
+                                                            {colorVector},
+                                                            {transform.m},
                                                             blendState,
                                                             meshBuffer,
                                                             particleCount * 6,
@@ -105,12 +103,30 @@ namespace ouzel
             }
         }
 
-        void ParticleSystem::update(float delta)
+        void ParticleSystem::prepareUpdate()
+        {
+            emitPosition = Vector2::ZERO;
+
+            if (actor)
+            {
+                if (particleDefinition.positionType == ParticleDefinition::PositionType::FREE)
+                {
+                    emitPosition = actor->convertLocalToWorld(Vector2::ZERO);
+                }
+                else if (particleDefinition.positionType == ParticleDefinition::PositionType::PARENT)
+                {
+                    emitPosition = actor->convertLocalToWorld(Vector2::ZERO) - actor->getPosition();
+                }
+
+                inverseTransform = actor->getInverseTransform();
+            }
+        }
+
+        void ParticleSystem::simulate(float delta)
         {
             timeSinceUpdate += delta;
 
             static const float UPDATE_STEP = 1.0f / 60.0f;
-            bool needsBoundingBoxUpdate = false;
 
             while (timeSinceUpdate >= UPDATE_STEP)
             {
@@ -142,85 +158,14 @@ namespace ouzel
                 }
                 else if (active && !particleCount)
                 {
+                    // the finish event is sent by finishUpdate on the update thread
                     active = false;
-                    updateCallback.remove();
-
-                    Event finishEvent;
-                    finishEvent.type = Event::Type::ANIMATION_FINISH;
-                    finishEvent.animationEvent.component = this;
-                    sharedEngine->getEventDispatcher()->postEvent(finishEvent);
-
                     return;
                 }
 
                 if (active)
                 {
-                    for (uint32_t counter = particleCount; counter > 0; --counter)
-                    {
-                        size_t i = counter - 1;
-
-                        particles[i].life -= UPDATE_STEP;
-
-                        if (particles[i].life >= 0.0f)
-                        {
-                            if (particleDefinition.emitterType == ParticleDefinition::EmitterType::GRAVITY)
-                            {
-                                Vector2 tmp, radial, tangential;
-
-                                // radial acceleration
-                                if (particles[i].position.x == 0.0f || particles[i].position.y == 0.0f)
-                                {
-                                    radial = particles[i].position;
-                                    radial.normalize();
-                                }
-                                tangential = radial;
-                                radial *= particles[i].radialAcceleration;
-
-                                // tangential acceleration
-                                std::swap(tangential.x, tangential.y);
-                                tangential.x *= - particles[i].tangentialAcceleration;
-                                tangential.y *= particles[i].tangentialAcceleration;
-
-                                // (gravity + radial + tangential) * UPDATE_STEP
-                                tmp.x = radial.x + tangential.x + particleDefinition.gravity.x;
-                                tmp.y = radial.y + tangential.y + particleDefinition.gravity.y;
-                                tmp.x *= UPDATE_STEP;
-                                tmp.y *= UPDATE_STEP;
-
-                                particles[i].direction.x += tmp.x;
-                                particles[i].direction.y += tmp.y;
-                                tmp.x = particles[i].direction.x * UPDATE_STEP * particleDefinition.yCoordFlipped;
-                                tmp.y = particles[i].direction.y * UPDATE_STEP * particleDefinition.yCoordFlipped;
-                                particles[i].position.x += tmp.x;
-                                particles[i].position.y += tmp.y;
-                            }
-                            else
-                            {
-                                particles[i].angle += particles[i].degreesPerSecond * UPDATE_STEP;
-                                particles[i].radius += particles[i].deltaRadius * UPDATE_STEP;
-                                particles[i].position.x = -cosf(particles[i].angle) * particles[i].radius;
-                                particles[i].position.y = -sinf(particles[i].angle) * particles[i].radius * particleDefinition.yCoordFlipped;
-                            }
-
-                            //color r,g,b,a
-                            particles[i].colorRed += particles[i].deltaColorRed * UPDATE_STEP;
-                            particles[i].colorGreen += particles[i].deltaColorGreen * UPDATE_STEP;
-                            particles[i].colorBlue += particles[i].deltaColorBlue * UPDATE_STEP;
-                            particles[i].colorAlpha += particles[i].deltaColorAlpha * UPDATE_STEP;
-
-                            //size
-                            particles[i].size += (particles[i].deltaSize * UPDATE_STEP);
-                            particles[i].size = std::max(0.0f, particles[i].size);
-
-                            //angle
-                            particles[i].rotation += particles[i].deltaRotation * UPDATE_STEP;
-                        }
-                        else
-                        {
-                            particles[i] = particles[particleCount - 1];
-                            particleCount--;
-                        }
-                    }
+                    particleCount = particles.update(particleCount, particleDefinition, UPDATE_STEP);
 
                     needsMeshUpdate = true;
                     needsBoundingBoxUpdate = true;
@@ -237,11 +182,9 @@ namespace ouzel
                 {
                     if (actor)
                     {
-                        const Matrix4& inverseTransform = actor->getInverseTransform();
-
                         for (uint32_t i = 0; i < particleCount; i++)
                         {
-                            Vector3 position = particles[i].position;
+                            Vector3 position(particles.positionX[i], particles.positionY[i], 0.0f);
                             inverseTransform.transformPoint(position);
                             boundingBox.insertPoint(Vector2(position.x, position.y));
                         }
@@ -251,12 +194,33 @@ namespace ouzel
                 {
                     for (uint32_t i = 0; i < particleCount; i++)
                     {
-                        boundingBox.insertPoint(particles[i].position);
+                        boundingBox.insertPoint(Vector2(particles.positionX[i], particles.positionY[i]));
                     }
                 }
             }
         }
 
+        bool ParticleSystem::finishUpdate()
+        {
+            if (needsBoundingBoxUpdate)
+            {
+                boundingBoxChanged();
+                needsBoundingBoxUpdate = false;
+            }
+
+            if (!active)
+            {
+                Event finishEvent;
+                finishEvent.type = Event::Type::ANIMATION_FINISH;
+                finishEvent.animationEvent.component = this;
+                sharedEngine->getEventDispatcher()->postEvent(finishEvent);
+
+                return false;
+            }
+
+            return true;
+        }
+
         bool ParticleSystem::init(const ParticleDefinition& newParticleDefinition)
         {
             particleDefinition = newParticleDefinition;
@@ -301,7 +265,7 @@ namespace ouzel
                 if (!active)
                 {
                     active = true;
-                    sharedEngine->scheduleUpdate(&updateCallback);
+                    sharedEngine->getSceneManager()->getParticleManager()->addParticleSystem(this);
                 }
 
                 if (particleCount == 0)
@@ -331,7 +295,6 @@ namespace ouzel
         bool ParticleSystem::createParticleMesh()
         {
             indices.reserve(particleDefinition.maxParticles * 6);
-            vertices.reserve(particleDefinition.maxParticles * 4);
 
             for (uint16_t i = 0; i < particleDefinition.maxParticles; ++i)
             {
@@ -341,18 +304,13 @@ namespace ouzel
                 indices.push_back(i * 4 + 1);
                 indices.push_back(i * 4 + 3);
                 indices.push_back(i * 4 + 2);
-
-                vertices.push_back(graphics::VertexPCT(Vector3(-1.0f, -1.0f, 0.0f), Color::WHITE, Vector2(0.0f, 1.0f)));
-                vertices.push_back(graphics::VertexPCT(Vector3(1.0f, -1.0f, 0.0f), Color::WHITE, Vector2(1.0f, 1.0f)));
-                vertices.push_back(graphics::VertexPCT(Vector3(-1.0f, 1.0f, 0.0f),  Color::WHITE, Vector2(0.0f, 0.0f)));
-                vertices.push_back(graphics::VertexPCT(Vector3(1.0f, 1.0f, 0.0f),  Color::WHITE, Vector2(1.0f, 0.0f)));
             }
 
             indexBuffer = std::make_shared<graphics::Buffer>();
             indexBuffer->init(graphics::Buffer::Usage::INDEX, indices.data(), static_cast<uint32_t>(getVectorSize(indices)), 0);
 
             vertexBuffer = std::make_shared<graphics::Buffer>();
-            vertexBuffer->init(graphics::Buffer::Usage::VERTEX, vertices.data(), static_cast<uint32_t>(getVectorSize(vertices)), graphics::Buffer::DYNAMIC);
+            vertexBuffer->init(graphics::Buffer::Usage::VERTEX, graphics::Buffer::DYNAMIC);
 
             meshBuffer = std::make_shared<graphics::MeshBuffer>();
             meshBuffer->init(sizeof(uint16_t), indexBuffer, graphics::VertexPCT::ATTRIBUTES, vertexBuffer);
@@ -364,61 +322,34 @@ namespace ouzel
 
         bool ParticleSystem::updateParticleMesh()
         {
-            if (actor)
+            if (graphics::VertexPCT* vertices = reserveVertices())
             {
-                for (uint32_t counter = particleCount; counter > 0; --counter)
-                {
-                    size_t i = counter - 1;
-
-                    Vector2 position;
-
-                    if (particleDefinition.positionType == ParticleDefinition::PositionType::FREE)
-                    {
-                        position = particles[i].position;
-                    }
-                    else if (particleDefinition.positionType == ParticleDefinition::PositionType::PARENT)
-                    {
-                        position = actor->getPosition() + particles[i].position;
-                    }
-
-                    float size_2 = particles[i].size / 2.0f;
-                    Vector2 v1(-size_2, -size_2);
-                    Vector2 v2(size_2, size_2);
-
-                    float r = -degToRad(particles[i].rotation);
-                    float cr = cosf(r);
-                    float sr = sinf(r);
-
-                    Vector2 a(v1.x * cr - v1.y * sr, v1.x * sr + v1.y * cr);
-                    Vector2 b(v2.x * cr - v1.y * sr, v2.x * sr + v1.y * cr);
-                    Vector2 c(v2.x * cr - v2.y * sr, v2.x * sr + v2.y * cr);
-                    Vector2 d(v1.x * cr - v2.y * sr, v1.x * sr + v2.y * cr);
-
-                    Color color(static_cast<uint8_t>(particles[i].colorRed * 255),
-                                static_cast<uint8_t>(particles[i].colorGreen * 255),
-                                static_cast<uint8_t>(particles[i].colorBlue * 255),
-                                static_cast<uint8_t>(particles[i].colorAlpha * 255));
-
-                    vertices[i * 4 + 0].position = a + position;
-                    vertices[i * 4 + 0].color = color;
+                writeVertices(vertices);
+            }
 
-                    vertices[i * 4 + 1].position = b + position;
-                    vertices[i * 4 + 1].color = color;
+            return true;
+        }
 
-                    vertices[i * 4 + 2].position = d + position;
-                    vertices[i * 4 + 2].color = color;
+        graphics::VertexPCT* ParticleSystem::reserveVertices()
+        {
+            if (!actor) return nullptr;
 
-                    vertices[i * 4 + 3].position = c + position;
-                    vertices[i * 4 + 3].color = color;
-                }
+            vertexOffset = Vector2::ZERO;
 
-                if (!vertexBuffer->setData(vertices.data(), static_cast<uint32_t>(getVectorSize(vertices))))
-                {
-                    return false;
-                }
+            if (particleDefinition.positionType == ParticleDefinition::PositionType::PARENT)
+            {
+                vertexOffset = actor->getPosition();
             }
 
-            return true;
+            // only the live particles are uploaded, the vertices are written directly to the streaming memory
+            uint8_t* data = vertexBuffer->reserveData(particleCount * 4 * static_cast<uint32_t>(sizeof(graphics::VertexPCT)));
+            return reinterpret_cast<graphics::VertexPCT*>(data);
+        }
+
+        void ParticleSystem::writeVertices(graphics::VertexPCT* vertices)
+        {
+            particles.writeVertices(particleCount, vertexOffset, vertices);
+            needsMeshUpdate = false;
         }
 
         void ParticleSystem::emitParticles(uint32_t count)
@@ -432,55 +363,46 @@ namespace ouzel
             {
                 if (actor)
                 {
-                    Vector2 position;
-
-                    if (particleDefinition.positionType == ParticleDefinition::PositionType::FREE)
-                    {
-                        position = actor->convertLocalToWorld(Vector2::ZERO);
-                    }
-                    else if (particleDefinition.positionType == ParticleDefinition::PositionType::PARENT)
-                    {
-                        position = actor->convertLocalToWorld(Vector2::ZERO) - actor->getPosition();
-                    }
-
                     for (uint32_t i = particleCount; i < particleCount + count; ++i)
                     {
                         if (particleDefinition.emitterType == ParticleDefinition::EmitterType::GRAVITY)
                         {
-                            particles[i].life = fmaxf(particleDefinition.particleLifespan + particleDefinition.particleLifespanVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f);
+                            particles.life[i] = fmaxf(particleDefinition.particleLifespan + particleDefinition.particleLifespanVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f);
 
-                            particles[i].position = particleDefinition.sourcePosition + position + Vector2(particleDefinition.sourcePositionVariance.x * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine),
-                                                                                                             particleDefinition.sourcePositionVariance.y * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine));
+                            Vector2 particlePosition = particleDefinition.sourcePosition + emitPosition + Vector2(particleDefinition.sourcePositionVariance.x * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine),
+                                                                                                                  particleDefinition.sourcePositionVariance.y * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine));
+                            particles.positionX[i] = particlePosition.x;
+                            particles.positionY[i] = particlePosition.y;
 
-                            particles[i].size = fmaxf(particleDefinition.startParticleSize + particleDefinition.startParticleSizeVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f);
+                            particles.size[i] = fmaxf(particleDefinition.startParticleSize + particleDefinition.startParticleSizeVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f);
 
                             float finishSize = fmaxf(particleDefinition.finishParticleSize + particleDefinition.finishParticleSizeVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f);
-                            particles[i].deltaSize = (finishSize - particles[i].size) / particles[i].life;
+                            particles.deltaSize[i] = (finishSize - particles.size[i]) / particles.life[i];
 
-                            particles[i].colorRed = clamp(particleDefinition.startColorRed + particleDefinition.startColorRedVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
-                            particles[i].colorGreen = clamp(particleDefinition.startColorGreen + particleDefinition.startColorGreenVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
-                            particles[i].colorBlue = clamp(particleDefinition.startColorBlue + particleDefinition.startColorBlueVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
-                            particles[i].colorAlpha = clamp(particleDefinition.startColorAlpha + particleDefinition.startColorAlphaVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
+                            particles.colorRed[i] = clamp(particleDefinition.startColorRed + particleDefinition.startColorRedVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
+                            particles.colorGreen[i] = clamp(particleDefinition.startColorGreen + particleDefinition.startColorGreenVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
+                            particles.colorBlue[i] = clamp(particleDefinition.startColorBlue + particleDefinition.startColorBlueVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
+                            particles.colorAlpha[i] = clamp(particleDefinition.startColorAlpha + particleDefinition.startColorAlphaVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
 
                             float finishColorRed = clamp(particleDefinition.finishColorRed + particleDefinition.finishColorRedVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
                             float finishColorGreen = clamp(particleDefinition.finishColorGreen + particleDefinition.finishColorGreenVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
                             float finishColorBlue = clamp(particleDefinition.finishColorBlue + particleDefinition.finishColorBlueVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
                             float finishColorAlpha = clamp(particleDefinition.finishColorAlpha + particleDefinition.finishColorAlphaVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine), 0.0f, 1.0f);
 
-                            particles[i].deltaColorRed = (finishColorRed - particles[i].colorRed) / particles[i].life;
-                            particles[i].deltaColorGreen = (finishColorGreen - particles[i].colorGreen) / particles[i].life;
-                            particles[i].deltaColorBlue = (finishColorBlue - particles[i].colorBlue) / particles[i].life;
-                            particles[i].deltaColorAlpha = (finishColorAlpha - particles[i].colorAlpha) / particles[i].life;
+                            particles.deltaColorRed[i] = (finishColorRed - particles.colorRed[i]) / particles.life[i];
+                            particles.deltaColorGreen[i] = (finishColorGreen - particles.colorGreen[i]) / particles.life[i];
+                            particles.deltaColorBlue[i] = (finishColorBlue - particles.colorBlue[i]) / particles.life[i];
+                            particles.deltaColorAlpha[i] = (finishColorAlpha - particles.colorAlpha[i]) / particles.life[i];
 
                             //_particles[i].finishColor = finishColor;
 
-                            particles[i].rotation = particleDefinition.startRotation + particleDefinition.startRotationVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
+                            particles.rotation[i] = particleDefinition.startRotation + particleDefinition.startRotationVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
 
                             float finishRotation = particleDefinition.finishRotation + particleDefinition.finishRotationVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
-                            particles[i].deltaRotation = (finishRotation - particles[i].rotation) / particles[i].life;
+                            particles.deltaRotation[i] = (finishRotation - particles.rotation[i]) / particles.life[i];
 
-                            particles[i].radialAcceleration = particleDefinition.radialAcceleration + particleDefinition.radialAcceleration * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
-                            particles[i].tangentialAcceleration = particleDefinition.tangentialAcceleration + particleDefinition.tangentialAcceleration * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
+                            particles.radialAcceleration[i] = particleDefinition.radialAcceleration + particleDefinition.radialAcceleration * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
+                            particles.tangentialAcceleration[i] = particleDefinition.tangentialAcceleration + particleDefinition.tangentialAcceleration * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
 
                             if (particleDefinition.rotationIsDir)
                             {
@@ -488,8 +410,9 @@ namespace ouzel
                                 Vector2 v(cosf(a), sinf(a));
                                 float s = particleDefinition.speed + particleDefinition.speedVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
                                 Vector2 dir = v * s;
-                                particles[i].direction = dir;
-                                particles[i].rotation = -radToDeg(dir.getAngle());
+                                particles.directionX[i] = dir.x;
+                                particles.directionY[i] = dir.y;
+                                particles.rotation[i] = -radToDeg(dir.getAngle());
                             }
                             else
                             {
@@ -497,17 +420,18 @@ namespace ouzel
                                 Vector2 v(cosf(a), sinf(a));
                                 float s = particleDefinition.speed + particleDefinition.speedVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
                                 Vector2 dir = v * s;
-                                particles[i].direction = dir;
+                                particles.directionX[i] = dir.x;
+                                particles.directionY[i] = dir.y;
                             }
                         }
                         else
                         {
-                            particles[i].radius = particleDefinition.maxRadius + particleDefinition.maxRadiusVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
-                            particles[i].angle = degToRad(particleDefinition.angle + particleDefinition.angleVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine));
-                            particles[i].degreesPerSecond = degToRad(particleDefinition.rotatePerSecond + particleDefinition.rotatePerSecondVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine));
+                            particles.radius[i] = particleDefinition.maxRadius + particleDefinition.maxRadiusVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
+                            particles.angle[i] = remainderf(degToRad(particleDefinition.angle + particleDefinition.angleVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine)), PIX2);
+                            particles.degreesPerSecond[i] = degToRad(particleDefinition.rotatePerSecond + particleDefinition.rotatePerSecondVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine));
 
                             float endRadius = particleDefinition.minRadius + particleDefinition.minRadiusVariance * std::uniform_real_distribution<float>{-1.0f, 1.0f}(randomEngine);
-                            particles[i].deltaRadius = (endRadius - particles[i].radius) / particles[i].life;
+                            particles.deltaRadius[i] = (endRadius - particles.radius[i]) / particles.life[i];
                         }
                     }
 
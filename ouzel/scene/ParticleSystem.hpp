@@ -6,12 +6,14 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <random>
 #include "scene/Component.hpp"
 #include "scene/ParticleDefinition.hpp"
+#include "scene/ParticleData.hpp"
 #include "math/Vector2.hpp"
 #include "math/Color.hpp"
 #include "graphics/Vertex.hpp"
-#include "core/UpdateCallback.hpp"
+#include "math/Matrix4.hpp"
 #include "graphics/BlendState.hpp"
 #include "graphics/Buffer.hpp"
 #include "graphics/MeshBuffer.hpp"
@@ -22,13 +24,17 @@ namespace ouzel
 {
     namespace scene
     {
+        class ParticleManager;
+
         class ParticleSystem: public Component
         {
+            friend ParticleManager;
         public:
             static const uint32_t TYPE = Component::PARTICLE_SYSTEM;
 
             ParticleSystem();
             ParticleSystem(const std::string& filename);
+            virtual ~ParticleSystem();
 
             virtual void draw(const Matrix4& transformMatrix,
                               float opacity,
@@ -55,11 +61,20 @@ namespace ouzel
             ParticleDefinition::PositionType getPositionType() const { return particleDefinition.positionType; }
 
         protected:
-            void update(float delta);
+            // called by the particle manager on the update thread before the simulation
+            void prepareUpdate();
+            // called by the particle manager on a worker thread
+            void simulate(float delta);
+            // called by the particle manager on the update thread after the simulation, returns false when the particle system has finished
+            bool finishUpdate();
 
             bool createParticleMesh();
             bool updateParticleMesh();
 
+            // the memory is reserved on the update thread and can be filled on any thread
+            graphics::VertexPCT* reserveVertices();
+            void writeVertices(graphics::VertexPCT* vertices);
+
             void emitParticles(uint32_t count);
 
             ParticleDefinition particleDefinition;
@@ -69,48 +84,14 @@ namespace ouzel
             std::shared_ptr<graphics::Texture> texture;
             std::shared_ptr<graphics::Texture> whitePixelTexture;
 
-            struct Particle
-            {
-                float life = 0.0f;
-
-                Vector2 position;
-
-                float colorRed = 0.0f;
-                float colorGreen = 0.0f;
-                float colorBlue = 0.0f;
-                float colorAlpha = 0.0f;
-
-                float deltaColorRed = 0.0f;
-                float deltaColorGreen = 0.0f;
-                float deltaColorBlue = 0.0f;
-                float deltaColorAlpha = 0.0f;
-
-                float angle = 0.0f;
-                float speed = 0.0f;
-
-                float size = 0.0f;
-                float deltaSize = 0.0f;
-
-                float rotation = 0.0f;
-                float deltaRotation = 0.0f;
-
-                float radialAcceleration = 0.0f;
-                float tangentialAcceleration = 0.0f;
-
-                Vector2 direction;
-                float radius = 0.0f;
-                float degreesPerSecond = 0.0f;
-                float deltaRadius = 0.0f;
-            };
-
-            std::vector<Particle> particles;
+            ParticleData particles;
+            std::mt19937 randomEngine; // used only by this particle system, so that it can be simulated on any thread
 
             std::shared_ptr<graphics::MeshBuffer> meshBuffer;
             std::shared_ptr<graphics::Buffer> indexBuffer;
             std::shared_ptr<graphics::Buffer> vertexBuffer;
 
             std::vector<uint16_t> indices;
-            std::vector<graphics::VertexPCT> vertices;
 
             uint32_t particleCount = 0;
 
@@ -122,8 +103,15 @@ namespace ouzel
             bool finished = false;
 
             bool needsMeshUpdate = false;
+            bool needsBoundingBoxUpdate = false;
+
+            // copied from the actor before the simulation
+            Vector2 emitPosition;
+            Matrix4 inverseTransform;
+
+            Vector2 vertexOffset;
 
-            UpdateCallback updateCallback;
+            ParticleManager* manager = nullptr;
         };
     } // namespace scene
 } // namespace ouzel
@@ -38,9 +38,33 @@ namespace ouzel
                 return a->getOrder() > b->getOrder();
             });
 
+            JobSystem* jobSystem = sharedEngine->getJobSystem();
+
+            // the layers do not share actors, so their transforms are updated and their first cameras culled in parallel
+            jobSystem->parallelFor(static_cast<uint32_t>(layers.size()), [this](uint32_t index) {
+                layers[index]->prepareDraw();
+            });
+
+            cullJobs.clear();
+            for (Layer* layer : layers)
+            {
+                for (uint32_t i = 1; i < layer->getCameras().size(); ++i)
+                {
+                    cullJobs.push_back(std::make_pair(layer, i));
+                }
+            }
+
+            jobSystem->parallelFor(static_cast<uint32_t>(cullJobs.size()), [this](uint32_t index) {
+                cullJobs[index].first->cull(cullJobs[index].second);
+            });
+
+            // the draw calls are submitted in the order of the layers and cameras,
+            // draw is called so that the layers that override it still get drawn their way
             for (Layer* layer : layers)
             {
+                layer->culled = true;
                 layer->draw();
+                layer->culled = false;
             }
         }
 
@@ -80,6 +80,7 @@ namespace ouzel
 
             std::vector<Layer*> layers;
             std::vector<std::unique_ptr<Layer>> ownedLayers;
+            std::vector<std::pair<Layer*, uint32_t>> cullJobs; // layer and the index of the camera
             ouzel::EventHandler eventHandler;
 
             std::unordered_map<uint64_t, std::pair<Actor*, ouzel::Vector3>> pointerDownOnActors;
@@ -6,6 +6,7 @@
 #include <memory>
 #include <vector>
 #include "utils/Noncopyable.hpp"
+#include "scene/ParticleManager.hpp"
 
 namespace ouzel
 {
@@ -47,11 +48,16 @@ namespace ouzel
             }
             Scene* getScene() const { return scenes.empty() ? nullptr : scenes.back(); }
 
+            ParticleManager* getParticleManager() { return &particleManager; }
+
         protected:
             virtual void addChildScene(Scene* scene);
             virtual bool removeChildScene(Scene* scene);
             SceneManager();
 
+            // destroyed after the scenes
+            ParticleManager particleManager;
+
             std::vector<Scene*> scenes;
             std::vector<std::unique_ptr<Scene>> ownedScenes;
         };
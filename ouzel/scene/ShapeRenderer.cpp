@@ -63,16 +63,10 @@ namespace ouzel
 
             for (const DrawCommand& drawCommand : drawCommands)
             {
-                std::vector<std::vector<float>> pixelShaderConstants(1);
-                pixelShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-                std::vector<std::vector<float>> vertexShaderConstants(1);
-                vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
-
-                sharedEngine->getRenderer()->addDrawCommand(std::vector<std::shared_ptr<graphics::Texture>>(),
+                sharedEngine->getRenderer()->addDrawCommand({},
                                                             shader,
-                                                            pixelShaderConstants,
-                                                            vertexShaderConstants,
+                                                            {colorVector},
+                                                            {modelViewProj.m},
                                                             blendState,
                                                             meshBuffer,
                                                             drawCommand.indexCount,
@@ -98,6 +92,7 @@ namespace ouzel
             vertices.clear();
 
             dirty = true;
+            boundingBoxChanged();
         }
 
         bool ShapeRenderer::line(const Vector2& start, const Vector2& finish, const Color& color, float thickness)
@@ -161,6 +156,7 @@ namespace ouzel
             drawCommands.push_back(command);
 
             dirty = true;
+            boundingBoxChanged();
             return true;
         }
 
@@ -284,6 +280,7 @@ namespace ouzel
             drawCommands.push_back(command);
 
             dirty = true;
+            boundingBoxChanged();
             return true;
         }
 
@@ -416,6 +413,7 @@ namespace ouzel
             drawCommands.push_back(command);
 
             dirty = true;
+            boundingBoxChanged();
             return true;
         }
 
@@ -490,6 +488,7 @@ namespace ouzel
             drawCommands.push_back(command);
 
             dirty = true;
+            boundingBoxChanged();
             return true;
         }
 
@@ -564,6 +563,7 @@ namespace ouzel
             drawCommands.push_back(command);
 
             dirty = true;
+            boundingBoxChanged();
             return true;
         }
     } // namespace scene
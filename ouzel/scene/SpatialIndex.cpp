@@ -0,0 +1,612 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include "SpatialIndex.hpp"
+#include "Actor.hpp"
+#include "Component.hpp"
+#include "Layer.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        static const uint32_t DIRTY_MASK = 0x03;
+        static const uint32_t UNCULLED = 0x04;
+
+        static Box3 combine(const Box3& a, const Box3& b)
+        {
+            Box3 result(a);
+            result.merge(b);
+            return result;
+        }
+
+        // sum of the extents, unlike the surface area it works also for flat and thin boxes
+        static float getCost(const Box3& box)
+        {
+            return (box.max.x - box.min.x) + (box.max.y - box.min.y) + (box.max.z - box.min.z);
+        }
+
+        static bool contains(const Box3& a, const Box3& b)
+        {
+            return a.min.x <= b.min.x && a.min.y <= b.min.y && a.min.z <= b.min.z &&
+                b.max.x <= a.max.x && b.max.y <= a.max.y && b.max.z <= a.max.z;
+        }
+
+        // enlarge the box, so that small movements don't require reinsertion
+        static Box3 fatten(const Box3& box)
+        {
+            Vector3 margin = (box.max - box.min) * 0.1f;
+            return Box3(box.min - margin, box.max + margin);
+        }
+
+        SpatialIndex::SpatialIndex(Layer* aLayer):
+            layer(aLayer)
+        {
+            std::vector<Actor*> actors(layer->getChildren().begin(), layer->getChildren().end());
+
+            for (uint32_t i = 0; i < actors.size(); ++i)
+            {
+                Actor* actor = actors[i];
+                addActor(actor);
+                actors.insert(actors.end(), actor->getChildren().begin(), actor->getChildren().end());
+            }
+        }
+
+        SpatialIndex::~SpatialIndex()
+        {
+            for (Actor* actor : layer->getChildren())
+            {
+                resetActors(actor);
+            }
+        }
+
+        void SpatialIndex::update()
+        {
+            for (uint32_t i = 0; i < dirtyActors.size(); ++i)
+            {
+                Actor* actor = dirtyActors[i];
+
+                if (actor && (actor->spatialState & DIRTY_MASK))
+                {
+                    refreshActor(actor);
+                }
+            }
+
+            dirtyActors.clear();
+
+            if (drawOrderDirty)
+            {
+                uint32_t drawIndex = 0;
+
+                for (Actor* actor : layer->getChildren())
+                {
+                    updateDrawIndices(actor, drawIndex);
+                }
+
+                drawOrderDirty = false;
+            }
+        }
+
+        uint32_t SpatialIndex::getDrawIndex(const Actor* actor)
+        {
+            return actor->spatialDrawIndex;
+        }
+
+        void SpatialIndex::updateDrawIndices(Actor* actor, uint32_t& drawIndex)
+        {
+            // pre-order, the same order in which the children are visited without the index
+            actor->spatialDrawIndex = drawIndex++;
+
+            for (Actor* child : actor->getChildren())
+            {
+                updateDrawIndices(child, drawIndex);
+            }
+        }
+
+        void SpatialIndex::query(const Box3& box, std::vector<Actor*>& result) const
+        {
+            if (root == NULL_NODE) return;
+
+            // local, the index is queried by several cameras at the same time
+            std::vector<int32_t> stack;
+            stack.reserve(64);
+            stack.push_back(root);
+
+            while (!stack.empty())
+            {
+                const Node& node = nodes[static_cast<uint32_t>(stack.back())];
+                stack.pop_back();
+
+                if (node.box.intersects(box))
+                {
+                    if (node.isLeaf())
+                    {
+                        result.push_back(node.actor);
+                    }
+                    else
+                    {
+                        stack.push_back(node.children[0]);
+                        stack.push_back(node.children[1]);
+                    }
+                }
+            }
+        }
+
+        void SpatialIndex::addActor(Actor* actor)
+        {
+            actor->spatialIndex = this;
+            actor->spatialProxy = NULL_NODE;
+            actor->spatialState = SUBTREE_DIRTY;
+            addDirtyActor(actor);
+            drawOrderDirty = true;
+        }
+
+        void SpatialIndex::removeActor(Actor* actor)
+        {
+            if (actor->spatialState & DIRTY_MASK)
+            {
+                dirtyActors[actor->spatialDirtyIndex] = nullptr;
+            }
+
+            if (actor->spatialProxy != NULL_NODE)
+            {
+                destroyProxy(actor->spatialProxy);
+            }
+
+            setUnculled(actor, false);
+
+            actor->spatialIndex = nullptr;
+            actor->spatialProxy = NULL_NODE;
+            actor->spatialState = 0;
+        }
+
+        void SpatialIndex::setSubtreeDirty(Actor* actor)
+        {
+            // the children of an actor with a dirty subtree are already dirty
+            if (actor->spatialState & SUBTREE_DIRTY) return;
+
+            if (!(actor->spatialState & DIRTY_MASK)) addDirtyActor(actor);
+            actor->spatialState |= SUBTREE_DIRTY;
+
+            for (Actor* child : actor->getChildren())
+            {
+                if (child->spatialIndex == this) setSubtreeDirty(child);
+            }
+        }
+
+        void SpatialIndex::setBoundsDirty(Actor* actor)
+        {
+            if (!(actor->spatialState & DIRTY_MASK)) addDirtyActor(actor);
+            actor->spatialState |= BOUNDS_DIRTY;
+        }
+
+        void SpatialIndex::addDirtyActor(Actor* actor)
+        {
+            actor->spatialDirtyIndex = static_cast<uint32_t>(dirtyActors.size());
+            dirtyActors.push_back(actor);
+        }
+
+        void SpatialIndex::refreshActor(Actor* actor)
+        {
+            Actor* parentActor = nullptr;
+
+            if (actor->parent && actor->parent != layer)
+            {
+                parentActor = static_cast<Actor*>(actor->parent);
+
+                // the parent has to be up to date before its world transform is used
+                if (parentActor->spatialIndex == this && (parentActor->spatialState & SUBTREE_DIRTY))
+                {
+                    refreshActor(parentActor);
+                }
+            }
+
+            bool subtreeDirty = (actor->spatialState & SUBTREE_DIRTY) != 0;
+            actor->spatialState &= ~DIRTY_MASK;
+
+            if (subtreeDirty)
+            {
+                if (parentActor)
+                {
+                    actor->parentTransform = parentActor->getTransform();
+                    actor->worldOrder = parentActor->worldOrder + actor->order;
+                    actor->worldHidden = parentActor->worldHidden || actor->hidden;
+                }
+                else
+                {
+                    actor->parentTransform = Matrix4::IDENTITY;
+                    actor->worldOrder = actor->order;
+                    actor->worldHidden = actor->hidden;
+                }
+
+                actor->transformDirty = actor->inverseTransformDirty = true;
+                actor->clearStaticCache();
+
+                for (Component* component : actor->components)
+                {
+                    component->updateTransform();
+                }
+            }
+
+            const Matrix4& transform = actor->getTransform();
+            actor->updateChildrenTransform = false; // the children are refreshed by the index
+
+            Box3 boundingBox = actor->worldHidden ? Box3() : actor->getBoundingBox();
+
+            setUnculled(actor, !actor->worldHidden && actor->cullDisabled);
+
+            if (boundingBox.isEmpty())
+            {
+                if (actor->spatialProxy != NULL_NODE)
+                {
+                    destroyProxy(actor->spatialProxy);
+                    actor->spatialProxy = NULL_NODE;
+                }
+
+                return;
+            }
+
+            Vector3 corners[8];
+            boundingBox.getCorners(corners);
+
+            Box3& worldBoundingBox = actor->spatialBoundingBox;
+            worldBoundingBox.reset();
+
+            for (Vector3& corner : corners)
+            {
+                transform.transformPoint(corner);
+                worldBoundingBox.insertPoint(corner);
+            }
+
+            if (actor->spatialProxy == NULL_NODE)
+            {
+                actor->spatialProxy = createProxy(worldBoundingBox, actor);
+            }
+            else
+            {
+                moveProxy(actor->spatialProxy, worldBoundingBox);
+            }
+        }
+
+        void SpatialIndex::resetActors(Actor* actor)
+        {
+            if (actor->spatialIndex == this)
+            {
+                actor->spatialIndex = nullptr;
+                actor->spatialProxy = NULL_NODE;
+                actor->spatialState = 0;
+            }
+
+            for (Actor* child : actor->getChildren())
+            {
+                resetActors(child);
+            }
+        }
+
+        void SpatialIndex::setUnculled(Actor* actor, bool unculled)
+        {
+            if (unculled && !(actor->spatialState & UNCULLED))
+            {
+                unculledActors.push_back(actor);
+                actor->spatialState |= UNCULLED;
+            }
+            else if (!unculled && (actor->spatialState & UNCULLED))
+            {
+                auto i = std::find(unculledActors.begin(), unculledActors.end(), actor);
+                if (i != unculledActors.end()) unculledActors.erase(i);
+                actor->spatialState &= ~UNCULLED;
+            }
+        }
+
+        int32_t SpatialIndex::allocateNode()
+        {
+            int32_t index;
+
+            if (freeList != NULL_NODE)
+            {
+                index = freeList;
+                freeList = nodes[static_cast<uint32_t>(index)].parent;
+                nodes[static_cast<uint32_t>(index)] = Node();
+            }
+            else
+            {
+                index = static_cast<int32_t>(nodes.size());
+                nodes.push_back(Node());
+            }
+
+            return index;
+        }
+
+        void SpatialIndex::freeNode(int32_t index)
+        {
+            Node& node = nodes[static_cast<uint32_t>(index)];
+            node.actor = nullptr;
+            node.height = -1;
+            node.parent = freeList;
+            freeList = index;
+        }
+
+        int32_t SpatialIndex::createProxy(const Box3& box, Actor* actor)
+        {
+            int32_t proxy = allocateNode();
+
+            Node& node = nodes[static_cast<uint32_t>(proxy)];
+            node.box = fatten(box);
+            node.actor = actor;
+            node.height = 0;
+
+            insertLeaf(proxy);
+
+            return proxy;
+        }
+
+        void SpatialIndex::destroyProxy(int32_t proxy)
+        {
+            removeLeaf(proxy);
+            freeNode(proxy);
+        }
+
+        void SpatialIndex::moveProxy(int32_t proxy, const Box3& box)
+        {
+            Node& node = nodes[static_cast<uint32_t>(proxy)];
+
+            if (contains(node.box, box)) return;
+
+            removeLeaf(proxy);
+            nodes[static_cast<uint32_t>(proxy)].box = fatten(box);
+            insertLeaf(proxy);
+        }
+
+        void SpatialIndex::insertLeaf(int32_t leaf)
+        {
+            if (root == NULL_NODE)
+            {
+                root = leaf;
+                nodes[static_cast<uint32_t>(root)].parent = NULL_NODE;
+                return;
+            }
+
+            Box3 leafBox = nodes[static_cast<uint32_t>(leaf)].box;
+
+            // find the best sibling
+            int32_t index = root;
+            while (!nodes[static_cast<uint32_t>(index)].isLeaf())
+            {
+                const Node& node = nodes[static_cast<uint32_t>(index)];
+                int32_t child1 = node.children[0];
+                int32_t child2 = node.children[1];
+
+                float cost = getCost(node.box);
+                float combinedCost = getCost(combine(node.box, leafBox));
+
+                // cost of creating a new parent for this node and the new leaf
+                float siblingCost = 2.0f * combinedCost;
+
+                // minimum cost of pushing the leaf further down the tree
+                float inheritanceCost = 2.0f * (combinedCost - cost);
+
+                const Node& node1 = nodes[static_cast<uint32_t>(child1)];
+                float cost1 = getCost(combine(leafBox, node1.box)) + inheritanceCost;
+                if (!node1.isLeaf()) cost1 -= getCost(node1.box);
+
+                const Node& node2 = nodes[static_cast<uint32_t>(child2)];
+                float cost2 = getCost(combine(leafBox, node2.box)) + inheritanceCost;
+                if (!node2.isLeaf()) cost2 -= getCost(node2.box);
+
+                if (siblingCost < cost1 && siblingCost < cost2) break;
+
+                index = (cost1 < cost2) ? child1 : child2;
+            }
+
+            int32_t sibling = index;
+
+            // create a new parent
+            int32_t oldParent = nodes[static_cast<uint32_t>(sibling)].parent;
+            int32_t newParent = allocateNode();
+
+            Node& parentNode = nodes[static_cast<uint32_t>(newParent)];
+            parentNode.parent = oldParent;
+            parentNode.box = combine(leafBox, nodes[static_cast<uint32_t>(sibling)].box);
+            parentNode.height = nodes[static_cast<uint32_t>(sibling)].height + 1;
+            parentNode.children[0] = sibling;
+            parentNode.children[1] = leaf;
+
+            if (oldParent != NULL_NODE)
+            {
+                Node& oldParentNode = nodes[static_cast<uint32_t>(oldParent)];
+
+                if (oldParentNode.children[0] == sibling)
+                    oldParentNode.children[0] = newParent;
+                else
+                    oldParentNode.children[1] = newParent;
+            }
+            else
+            {
+                root = newParent;
+            }
+
+            nodes[static_cast<uint32_t>(sibling)].parent = newParent;
+            nodes[static_cast<uint32_t>(leaf)].parent = newParent;
+
+            // fix the heights and the boxes of the ancestors
+            index = nodes[static_cast<uint32_t>(leaf)].parent;
+            while (index != NULL_NODE)
+            {
+                index = balance(index);
+
+                Node& node = nodes[static_cast<uint32_t>(index)];
+                const Node& node1 = nodes[static_cast<uint32_t>(node.children[0])];
+                const Node& node2 = nodes[static_cast<uint32_t>(node.children[1])];
+
+                node.height = 1 + std::max(node1.height, node2.height);
+                node.box = combine(node1.box, node2.box);
+
+                index = node.parent;
+            }
+        }
+
+        void SpatialIndex::removeLeaf(int32_t leaf)
+        {
+            if (leaf == root)
+            {
+                root = NULL_NODE;
+                return;
+            }
+
+            int32_t parent = nodes[static_cast<uint32_t>(leaf)].parent;
+            const Node& parentNode = nodes[static_cast<uint32_t>(parent)];
+            int32_t grandParent = parentNode.parent;
+            int32_t sibling = (parentNode.children[0] == leaf) ? parentNode.children[1] : parentNode.children[0];
+
+            if (grandParent != NULL_NODE)
+            {
+                // replace the parent with the sibling
+                Node& grandParentNode = nodes[static_cast<uint32_t>(grandParent)];
+
+                if (grandParentNode.children[0] == parent)
+                    grandParentNode.children[0] = sibling;
+                else
+                    grandParentNode.children[1] = sibling;
+
+                nodes[static_cast<uint32_t>(sibling)].parent = grandParent;
+                freeNode(parent);
+
+                int32_t index = grandParent;
+                while (index != NULL_NODE)
+                {
+                    index = balance(index);
+
+                    Node& node = nodes[static_cast<uint32_t>(index)];
+                    const Node& node1 = nodes[static_cast<uint32_t>(node.children[0])];
+                    const Node& node2 = nodes[static_cast<uint32_t>(node.children[1])];
+
+                    node.box = combine(node1.box, node2.box);
+                    node.height = 1 + std::max(node1.height, node2.height);
+
+                    index = node.parent;
+                }
+            }
+            else
+            {
+                root = sibling;
+                nodes[static_cast<uint32_t>(sibling)].parent = NULL_NODE;
+                freeNode(parent);
+            }
+        }
+
+        // rotates the higher child of the node up if the tree is unbalanced, returns the new root of the subtree
+        int32_t SpatialIndex::balance(int32_t iA)
+        {
+            Node& a = nodes[static_cast<uint32_t>(iA)];
+
+            if (a.isLeaf() || a.height < 2) return iA;
+
+            int32_t iB = a.children[0];
+            int32_t iC = a.children[1];
+            Node& b = nodes[static_cast<uint32_t>(iB)];
+            Node& c = nodes[static_cast<uint32_t>(iC)];
+
+            int32_t heightDifference = c.height - b.height;
+
+            if (heightDifference > 1) // rotate c up
+            {
+                int32_t iF = c.children[0];
+                int32_t iG = c.children[1];
+                Node& f = nodes[static_cast<uint32_t>(iF)];
+                Node& g = nodes[static_cast<uint32_t>(iG)];
+
+                c.children[0] = iA;
+                c.parent = a.parent;
+                a.parent = iC;
+
+                if (c.parent != NULL_NODE)
+                {
+                    Node& parentNode = nodes[static_cast<uint32_t>(c.parent)];
+
+                    if (parentNode.children[0] == iA)
+                        parentNode.children[0] = iC;
+                    else
+                        parentNode.children[1] = iC;
+                }
+                else
+                {
+                    root = iC;
+                }
+
+                if (f.height > g.height)
+                {
+                    c.children[1] = iF;
+                    a.children[1] = iG;
+                    g.parent = iA;
+                    a.box = combine(b.box, g.box);
+                    c.box = combine(a.box, f.box);
+                    a.height = 1 + std::max(b.height, g.height);
+                    c.height = 1 + std::max(a.height, f.height);
+                }
+                else
+                {
+                    c.children[1] = iG;
+                    a.children[1] = iF;
+                    f.parent = iA;
+                    a.box = combine(b.box, f.box);
+                    c.box = combine(a.box, g.box);
+                    a.height = 1 + std::max(b.height, f.height);
+                    c.height = 1 + std::max(a.height, g.height);
+                }
+
+                return iC;
+            }
+            else if (heightDifference < -1) // rotate b up
+            {
+                int32_t iD = b.children[0];
+                int32_t iE = b.children[1];
+                Node& d = nodes[static_cast<uint32_t>(iD)];
+                Node& e = nodes[static_cast<uint32_t>(iE)];
+
+                b.children[0] = iA;
+                b.parent = a.parent;
+                a.parent = iB;
+
+                if (b.parent != NULL_NODE)
+                {
+                    Node& parentNode = nodes[static_cast<uint32_t>(b.parent)];
+
+                    if (parentNode.children[0] == iA)
+                        parentNode.children[0] = iB;
+                    else
+                        parentNode.children[1] = iB;
+                }
+                else
+                {
+                    root = iB;
+                }
+
+                if (d.height > e.height)
+                {
+                    b.children[1] = iD;
+                    a.children[0] = iE;
+                    e.parent = iA;
+                    a.box = combine(c.box, e.box);
+                    b.box = combine(a.box, d.box);
+                    a.height = 1 + std::max(c.height, e.height);
+                    b.height = 1 + std::max(a.height, d.height);
+                }
+                else
+                {
+                    b.children[1] = iE;
+                    a.children[0] = iD;
+                    d.parent = iA;
+                    a.box = combine(c.box, d.box);
+                    b.box = combine(a.box, e.box);
+                    a.height = 1 + std::max(c.height, d.height);
+                    b.height = 1 + std::max(a.height, e.height);
+                }
+
+                return iB;
+            }
+
+            return iA;
+        }
+    } // namespace scene
+} // namespace ouzel
@@ -0,0 +1,102 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "utils/Noncopyable.hpp"
+#include "math/Box3.hpp"
+#include "math/Matrix4.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        class Actor;
+        class ActorContainer;
+        class Layer;
+
+        // dynamic AABB tree of the world bounding boxes of the visible actors of a layer,
+        // only the actors whose transform, order, visibility or bounds changed are updated
+        class SpatialIndex: public Noncopyable
+        {
+            friend Actor;
+            friend ActorContainer;
+            friend Layer;
+        public:
+            SpatialIndex(Layer* aLayer);
+            ~SpatialIndex();
+
+            // recalculates the world transforms and the bounding boxes of the dirty actors
+            // and the draw indices if the actors were added or moved
+            void update();
+
+            // finds the actors whose (enlarged) bounding box intersects the box
+            void query(const Box3& box, std::vector<Actor*>& result) const;
+
+            // actors with culling disabled, they are not culled by the tree
+            const std::vector<Actor*>& getUnculledActors() const { return unculledActors; }
+
+            // pre-order index of the actor in the layer, valid after update
+            static uint32_t getDrawIndex(const Actor* actor);
+
+            uint32_t getHeight() const { return (root == NULL_NODE) ? 0 : static_cast<uint32_t>(nodes[static_cast<uint32_t>(root)].height); }
+
+        protected:
+            enum State
+            {
+                BOUNDS_DIRTY = 0x01, // only the bounding box of the actor changed
+                SUBTREE_DIRTY = 0x02 // the world transform, order or visibility of the actor and all its children changed
+            };
+
+            static const int32_t NULL_NODE = -1;
+
+            struct Node
+            {
+                Box3 box;
+                Actor* actor = nullptr;
+                int32_t parent = NULL_NODE; // next free node if the node is not used
+                int32_t children[2] = {NULL_NODE, NULL_NODE};
+                int32_t height = 0; // -1 if the node is not used
+
+                bool isLeaf() const { return children[0] == NULL_NODE; }
+            };
+
+            // called by the actors
+            void addActor(Actor* actor);
+            void removeActor(Actor* actor);
+            void setSubtreeDirty(Actor* actor);
+            void setBoundsDirty(Actor* actor);
+
+            void addDirtyActor(Actor* actor);
+            void refreshActor(Actor* actor);
+            void resetActors(Actor* actor);
+
+            void setUnculled(Actor* actor, bool unculled);
+
+            // called when actors are added or the children are reordered
+            void setDrawOrderDirty() { drawOrderDirty = true; }
+            void updateDrawIndices(Actor* actor, uint32_t& drawIndex);
+
+            int32_t allocateNode();
+            void freeNode(int32_t index);
+            int32_t createProxy(const Box3& box, Actor* actor);
+            void destroyProxy(int32_t proxy);
+            void moveProxy(int32_t proxy, const Box3& box);
+            void insertLeaf(int32_t leaf);
+            void removeLeaf(int32_t leaf);
+            int32_t balance(int32_t a);
+
+            Layer* layer;
+
+            std::vector<Node> nodes;
+            int32_t root = NULL_NODE;
+            int32_t freeList = NULL_NODE;
+
+            std::vector<Actor*> dirtyActors;
+            std::vector<Actor*> unculledActors;
+            bool drawOrderDirty = true;
+        };
+    } // namespace scene
+} // namespace ouzel
@@ -207,36 +207,58 @@ namespace ouzel
 
             if (currentFrame < frames.size() && material)
             {
-                Matrix4 modelViewProj = renderViewProjection * transformMatrix * offsetMatrix;
-                float colorVector[] = {material->diffuseColor.normR(), material->diffuseColor.normG(), material->diffuseColor.normB(), material->diffuseColor.normA() * opacity};
-
-                std::vector<std::vector<float>> pixelShaderConstants(1);
-                pixelShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-                std::vector<std::vector<float>> vertexShaderConstants(1);
-                vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
-
-                std::vector<std::shared_ptr<graphics::Texture>> textures;
-                if (wireframe) textures.push_back(whitePixelTexture);
-                else textures.assign(std::begin(material->textures), std::end(material->textures));
-
-                sharedEngine->getRenderer()->addDrawCommand(textures,
-                                                            material->shader,
-                                                            pixelShaderConstants,
-                                                            vertexShaderConstants,
-                                                            material->blendState,
-                                                            frames[currentFrame].getMeshBuffer(),
-                                                            0,
-                                                            graphics::Renderer::DrawMode::TRIANGLE_LIST,
-                                                            0,
-                                                            renderTarget,
-                                                            renderViewport,
-                                                            depthWrite,
-                                                            depthTest,
-                                                            wireframe,
-                                                            scissorTest,
-                                                            scissorRectangle,
-                                                            material->cullMode);
+                graphics::Renderer* renderer = sharedEngine->getRenderer();
+
+                std::shared_ptr<graphics::Texture> wireframeTextures[graphics::Texture::LAYERS] = {whitePixelTexture};
+                const std::shared_ptr<graphics::Texture> (&textures)[graphics::Texture::LAYERS] = wireframe ? wireframeTextures : material->textures;
+
+                if (renderer->isBatchingEnabled())
+                {
+                    const SpriteFrame& frame = frames[currentFrame];
+
+                    Color color = material->diffuseColor;
+                    color.a = static_cast<uint8_t>(color.a * opacity);
+
+                    renderer->addBatchedDrawCommand(textures,
+                                                    material->shader,
+                                                    material->blendState,
+                                                    frame.getIndices(),
+                                                    frame.getVertices(),
+                                                    transformMatrix * offsetMatrix,
+                                                    color,
+                                                    renderViewProjection,
+                                                    renderTarget,
+                                                    renderViewport,
+                                                    depthWrite,
+                                                    depthTest,
+                                                    wireframe,
+                                                    scissorTest,
+                                                    scissorRectangle,
+                                                    material->cullMode);
+                }
+                else
+                {
+                    Matrix4 modelViewProj = renderViewProjection * transformMatrix * offsetMatrix;
+                    float colorVector[] = {material->diffuseColor.normR(), material->diffuseColor.normG(), material->diffuseColor.normB(), material->diffuseColor.normA() * opacity};
+
+                    renderer->addDrawCommand(textures,
+                                             material->shader,
+                                             {colorVector},
+                                             {modelViewProj.m},
+                                             material->blendState,
+                                             frames[currentFrame].getMeshBuffer(),
+                                             0,
+                                             graphics::Renderer::DrawMode::TRIANGLE_LIST,
+                                             0,
+                                             renderTarget,
+                                             renderViewport,
+                                             depthWrite,
+                                             depthTest,
+                                             wireframe,
+                                             scissorTest,
+                                             scissorRectangle,
+                                             material->cullMode);
+                }
             }
         }
 
@@ -344,6 +366,8 @@ namespace ouzel
                 size.width = size.height = 0.0f;
                 boundingBox.reset();
             }
+
+            boundingBoxChanged();
         }
     } // namespace scene
 } // namespace ouzel
@@ -20,7 +20,7 @@ namespace ouzel
                                  const Vector2& sourceOffset,
                                  const Vector2& pivot)
         {
-            std::vector<uint16_t> indices = {0, 1, 2, 1, 3, 2};
+            indices = {0, 1, 2, 1, 3, 2};
 
             Vector2 textCoords[4];
             Vector2 finalOffset(-sourceSize.width * pivot.x + sourceOffset.x,
@@ -53,7 +53,7 @@ namespace ouzel
                 textCoords[3] = Vector2(rightBottom.x, rightBottom.y);
             }
 
-            std::vector<graphics::VertexPCT> vertices = {
+            vertices = {
                 graphics::VertexPCT(Vector3(finalOffset.x, finalOffset.y, 0.0f), Color::WHITE, textCoords[0]),
                 graphics::VertexPCT(Vector3(finalOffset.x + frameRectangle.size.width, finalOffset.y, 0.0f), Color::WHITE, textCoords[1]),
                 graphics::VertexPCT(Vector3(finalOffset.x, finalOffset.y + frameRectangle.size.height, 0.0f),  Color::WHITE, textCoords[2]),
@@ -75,12 +75,13 @@ namespace ouzel
             meshBuffer->init(sizeof(uint16_t), indexBuffer, graphics::VertexPCT::ATTRIBUTES, vertexBuffer);
         }
 
-        SpriteFrame::SpriteFrame(const std::vector<uint16_t>& indices,
-                                 const std::vector<graphics::VertexPCT>& vertices,
+        SpriteFrame::SpriteFrame(const std::vector<uint16_t>& newIndices,
+                                 const std::vector<graphics::VertexPCT>& newVertices,
                                  const Rectangle& frameRectangle,
                                  const Size2& sourceSize,
                                  const Vector2& sourceOffset,
-                                 const Vector2& pivot)
+                                 const Vector2& pivot):
+            indices(newIndices), vertices(newVertices)
         {
             for (const graphics::VertexPCT& vertex : vertices)
             {
@@ -39,9 +39,14 @@ namespace ouzel
             const Box2& getBoundingBox() const { return boundingBox; }
             const std::shared_ptr<graphics::MeshBuffer>& getMeshBuffer() const { return meshBuffer; }
 
+            const std::vector<uint16_t>& getIndices() const { return indices; }
+            const std::vector<graphics::VertexPCT>& getVertices() const { return vertices; }
+
         protected:
             Rectangle rectangle;
             Box2 boundingBox;
+            std::vector<uint16_t> indices;
+            std::vector<graphics::VertexPCT> vertices;
             std::shared_ptr<graphics::MeshBuffer> meshBuffer;
             std::shared_ptr<graphics::Buffer> indexBuffer;
             std::shared_ptr<graphics::Buffer> vertexBuffer;
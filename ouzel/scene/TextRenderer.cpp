@@ -40,6 +40,7 @@ namespace ouzel
 
             font = sharedEngine->getCache()->getFont(fontFile, mipmaps);
 
+            updateShader();
             updateText();
         }
 
@@ -47,6 +48,7 @@ namespace ouzel
         {
             font = sharedEngine->getCache()->getFont(fontFile);
 
+            updateShader();
             updateText();
         }
 
@@ -86,6 +88,16 @@ namespace ouzel
                             scissorTest,
                             scissorRectangle);
 
+            font->useGlyphs(characters, fontSize);
+
+            // the glyphs could have been evicted from the font atlas, their positions stay the same
+            if (font->getVersion() != fontVersion)
+            {
+                font->getVertices(text, Color::WHITE, fontSize, textAnchor, indices, vertices, texture);
+                fontVersion = font->getVersion();
+                needsMeshUpdate = true;
+            }
+
             if (needsMeshUpdate)
             {
                 indexBuffer->setData(indices.data(), static_cast<uint32_t>(getVectorSize(indices)));
@@ -97,16 +109,10 @@ namespace ouzel
             Matrix4 modelViewProj = renderViewProjection * transformMatrix;
             float colorVector[] = {color.normR(), color.normG(), color.normB(), color.normA() * opacity};
 
-            std::vector<std::vector<float>> pixelShaderConstants(1);
-            pixelShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-            std::vector<std::vector<float>> vertexShaderConstants(1);
-            vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
-
             sharedEngine->getRenderer()->addDrawCommand({wireframe ? whitePixelTexture : texture},
                                                         shader,
-                                                        pixelShaderConstants,
-                                                        vertexShaderConstants,
+                                                        {colorVector},
+                                                        {modelViewProj.m},
                                                         blendState,
                                                         meshBuffer,
                                                         static_cast<uint32_t>(indices.size()),
@@ -136,7 +142,9 @@ namespace ouzel
 
         void TextRenderer::updateText()
         {
+            characters = utf8to32(text);
             font->getVertices(text, Color::WHITE, fontSize, textAnchor, indices, vertices, texture);
+            fontVersion = font->getVersion();
             needsMeshUpdate = true;
 
             boundingBox.reset();
@@ -146,6 +154,20 @@ namespace ouzel
                 boundingBox.insertPoint(Vector2(vertex.position.x, vertex.position.y));
             }
 
+            boundingBoxChanged();
+        }
+
+        void TextRenderer::updateShader()
+        {
+            const std::shared_ptr<graphics::Shader>& textureShader = sharedEngine->getCache()->getShader(graphics::SHADER_TEXTURE);
+            const std::shared_ptr<graphics::Shader>& distanceFieldShader = sharedEngine->getCache()->getShader(graphics::SHADER_DISTANCE_FIELD);
+
+            // a custom shader is kept
+            if (shader != textureShader && shader != distanceFieldShader) return;
+
+            // render devices without the distance field shader draw the distance field as a texture
+            if (font && font->isDistanceField() && distanceFieldShader) shader = distanceFieldShader;
+            else shader = textureShader;
         }
     } // namespace scene
 } // namespace ouzel
@@ -62,6 +62,7 @@ namespace ouzel
 
         protected:
             void updateText();
+            void updateShader();
 
             std::shared_ptr<graphics::Shader> shader;
             std::shared_ptr<graphics::BlendState> blendState;
@@ -74,7 +75,9 @@ namespace ouzel
             std::shared_ptr<graphics::Texture> whitePixelTexture;
 
             std::shared_ptr<Font> font;
+            uint32_t fontVersion = 0;
             std::string text;
+            std::vector<uint32_t> characters; // the text in UTF-32
             float fontSize = 1.0f;
             Vector2 textAnchor;
 
@@ -0,0 +1,122 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "TransformHierarchy.hpp"
+#include "Actor.hpp"
+#include "Component.hpp"
+#include "Layer.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        TransformHierarchy::TransformHierarchy(Layer* aLayer):
+            layer(aLayer)
+        {
+        }
+
+        TransformHierarchy::~TransformHierarchy()
+        {
+            for (Actor* actor : actors)
+            {
+                if (actor) actor->transformHierarchy = nullptr;
+            }
+        }
+
+        void TransformHierarchy::update()
+        {
+            if (structureDirty)
+            {
+                rebuild();
+            }
+
+            const uint32_t count = static_cast<uint32_t>(actors.size());
+
+            // read only the dirty flags and the matrices, actors are touched only if their transform changed
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                int32_t parent = parents[i];
+                uint8_t dirty = localDirty[i] | (parent >= 0 ? worldDirty[static_cast<uint32_t>(parent)] : 0);
+
+                worldDirty[i] = dirty;
+
+                if (dirty)
+                {
+                    if (localDirty[i])
+                    {
+                        localTransforms[i] = actors[i]->getLocalTransform();
+                        localDirty[i] = 0;
+                    }
+
+                    const Matrix4& parentTransform = (parent >= 0) ? worldTransforms[static_cast<uint32_t>(parent)] : Matrix4::IDENTITY;
+                    Matrix4::multiply(parentTransform, localTransforms[i], worldTransforms[i]);
+                }
+            }
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (worldDirty[i])
+                {
+                    Actor* actor = actors[i];
+                    int32_t parent = parents[i];
+
+                    actor->parentTransform = (parent >= 0) ? worldTransforms[static_cast<uint32_t>(parent)] : Matrix4::IDENTITY;
+                    actor->transform = worldTransforms[i];
+                    actor->transformDirty = false;
+                    actor->inverseTransformDirty = true;
+                    actor->updateChildrenTransform = false; // the children are updated by this pass
+                    actor->clearStaticCache(); // the parents were invalidated when the local transform changed
+
+                    for (Component* component : actor->components)
+                    {
+                        component->updateTransform();
+                    }
+                }
+            }
+        }
+
+        void TransformHierarchy::rebuild()
+        {
+            for (Actor* actor : actors)
+            {
+                if (actor) actor->transformHierarchy = nullptr;
+            }
+
+            actors.clear();
+            parents.clear();
+
+            for (Actor* actor : layer->getChildren())
+            {
+                actors.push_back(actor);
+                parents.push_back(-1);
+            }
+
+            // breadth-first, the parents of the actors that are appended are already in the array
+            for (uint32_t i = 0; i < actors.size(); ++i)
+            {
+                Actor* actor = actors[i];
+                actor->transformHierarchy = this;
+                actor->transformIndex = i;
+
+                for (Actor* child : actor->getChildren())
+                {
+                    actors.push_back(child);
+                    parents.push_back(static_cast<int32_t>(i));
+                }
+            }
+
+            localDirty.assign(actors.size(), 1);
+            worldDirty.assign(actors.size(), 1);
+            localTransforms.resize(actors.size());
+            worldTransforms.resize(actors.size());
+
+            structureDirty = false;
+        }
+
+        void TransformHierarchy::removeActor(uint32_t index)
+        {
+            actors[index] = nullptr;
+            structureDirty = true;
+        }
+    } // namespace scene
+} // namespace ouzel
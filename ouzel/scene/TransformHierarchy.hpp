@@ -0,0 +1,51 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "utils/Noncopyable.hpp"
+#include "math/Matrix4.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        class Actor;
+        class Layer;
+
+        // local and world transforms of all actors of a layer in contiguous arrays in breadth-first order,
+        // parents always come before their children, so the dirty transforms are recalculated in one linear pass
+        class TransformHierarchy: public Noncopyable
+        {
+            friend Actor;
+        public:
+            TransformHierarchy(Layer* aLayer);
+            ~TransformHierarchy();
+
+            // recalculates the dirty world transforms and writes them to the actors
+            void update();
+
+            uint32_t getActorCount() const { return static_cast<uint32_t>(actors.size()); }
+
+        protected:
+            void rebuild();
+
+            // called by the actors
+            void setStructureDirty() { structureDirty = true; }
+            void setLocalDirty(uint32_t index) { localDirty[index] = 1; }
+            void removeActor(uint32_t index);
+
+            Layer* layer;
+            bool structureDirty = true;
+
+            std::vector<Actor*> actors;
+            std::vector<int32_t> parents; // index of the parent, -1 for the children of the layer
+            std::vector<uint8_t> localDirty;
+            std::vector<uint8_t> worldDirty;
+            std::vector<Matrix4> localTransforms;
+            std::vector<Matrix4> worldTransforms;
+        };
+    } // namespace scene
+} // namespace ouzel
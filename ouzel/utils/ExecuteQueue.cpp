@@ -0,0 +1,177 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <thread>
+#include "ExecuteQueue.hpp"
+
+namespace ouzel
+{
+    ExecuteQueue::ExecuteQueue():
+        freeHead(NULL_INDEX), pendingHead(NULL_INDEX)
+    {
+        for (std::atomic<Node*>& chunk : chunks)
+        {
+            chunk.store(nullptr, std::memory_order_relaxed);
+        }
+
+        addChunk();
+    }
+
+    ExecuteQueue::~ExecuteQueue()
+    {
+        for (uint32_t i = 0; i < chunkCount; ++i)
+        {
+            delete [] chunks[i].load();
+        }
+    }
+
+    void ExecuteQueue::push(Function&& function)
+    {
+        uint32_t index = allocateNode();
+        Node& node = getNode(index);
+        node.function = std::move(function);
+        node.marker = false;
+
+        link(index);
+    }
+
+    void ExecuteQueue::pushMarker()
+    {
+        uint32_t index = allocateNode();
+        getNode(index).marker = true;
+
+        link(index);
+    }
+
+    void ExecuteQueue::link(uint32_t index)
+    {
+        Node& node = getNode(index);
+        uint32_t head = pendingHead.load(std::memory_order_relaxed);
+
+        do
+        {
+            node.next.store(head, std::memory_order_relaxed);
+        }
+        while (!pendingHead.compare_exchange_weak(head, index, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void ExecuteQueue::executeAll()
+    {
+        execute(false);
+    }
+
+    bool ExecuteQueue::executeToMarker()
+    {
+        return execute(true);
+    }
+
+    bool ExecuteQueue::execute(bool stopAtMarker)
+    {
+        for (;;)
+        {
+            if (batchPosition == batch.size() && !fetchPending()) return false;
+
+            uint32_t index = batch[batchPosition++];
+            Node& node = getNode(index);
+
+            if (node.marker)
+            {
+                freeNode(index);
+
+                if (stopAtMarker) return true;
+            }
+            else
+            {
+                // moved out of the node, so that the node can be reused while the function runs
+                Function function = std::move(node.function);
+                freeNode(index);
+
+                function();
+            }
+        }
+    }
+
+    bool ExecuteQueue::fetchPending()
+    {
+        batch.clear();
+        batchPosition = 0;
+
+        // all the pushed nodes are taken at once
+        for (uint32_t index = pendingHead.exchange(NULL_INDEX, std::memory_order_acquire); index != NULL_INDEX;)
+        {
+            batch.push_back(index);
+            index = getNode(index).next.load(std::memory_order_relaxed);
+        }
+
+        std::reverse(batch.begin(), batch.end());
+
+        return !batch.empty();
+    }
+
+    uint32_t ExecuteQueue::allocateNode()
+    {
+        uint64_t head = freeHead.load(std::memory_order_acquire);
+
+        for (;;)
+        {
+            uint32_t index = static_cast<uint32_t>(head);
+
+            if (index == NULL_INDEX)
+            {
+                addChunk();
+                head = freeHead.load(std::memory_order_acquire);
+                continue;
+            }
+
+            // the node can be taken by another thread in the meantime, then the tag does not match and the next is not used
+            uint64_t next = getNode(index).next.load(std::memory_order_relaxed);
+            uint64_t newHead = next | (((head >> 32) + 1) << 32);
+
+            if (freeHead.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                return index;
+            }
+        }
+    }
+
+    void ExecuteQueue::freeNode(uint32_t index)
+    {
+        Node& node = getNode(index);
+        uint64_t head = freeHead.load(std::memory_order_relaxed);
+        uint64_t newHead;
+
+        do
+        {
+            node.next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            newHead = index | (((head >> 32) + 1) << 32);
+        }
+        while (!freeHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void ExecuteQueue::addChunk()
+    {
+        std::lock_guard<std::mutex> lock(chunkMutex);
+
+        // another thread added a chunk or the consumer freed nodes
+        if (static_cast<uint32_t>(freeHead.load()) != NULL_INDEX) return;
+
+        // the queue can not grow anymore, wait until the consumer frees some nodes
+        if (chunkCount == MAX_CHUNK_COUNT)
+        {
+            std::this_thread::yield();
+            return;
+        }
+
+        Node* chunk = new Node[CHUNK_SIZE];
+        chunks[chunkCount].store(chunk, std::memory_order_release);
+
+        uint32_t first = chunkCount * CHUNK_SIZE;
+        ++chunkCount;
+
+        for (uint32_t i = CHUNK_SIZE; i > 0; --i)
+        {
+            freeNode(first + i - 1);
+        }
+    }
+}
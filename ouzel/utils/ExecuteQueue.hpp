@@ -0,0 +1,69 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "utils/Noncopyable.hpp"
+#include "utils/Function.hpp"
+
+namespace ouzel
+{
+    // lock-free queue of functions that are pushed by any thread and executed by one thread,
+    // the nodes are recycled, so pushing allocates only when the queue grows
+    class ExecuteQueue: public Noncopyable
+    {
+    public:
+        ExecuteQueue();
+        ~ExecuteQueue();
+
+        // can be called from any thread
+        void push(Function&& function);
+        // marks the end of a batch, the functions linked before the marker belong to the batch
+        void pushMarker();
+
+        // called only by the consuming thread, execute the functions in the order they were pushed
+        void executeAll();
+        // executes the functions until the next marker, returns false if no marker was found
+        bool executeToMarker();
+
+    protected:
+        static const uint32_t NULL_INDEX = 0xFFFFFFFF;
+        static const uint32_t CHUNK_SIZE = 256;
+        static const uint32_t MAX_CHUNK_COUNT = 4096;
+
+        struct Node
+        {
+            Function function;
+            std::atomic<uint32_t> next;
+            bool marker = false;
+        };
+
+        Node& getNode(uint32_t index) const
+        {
+            return chunks[index / CHUNK_SIZE].load(std::memory_order_acquire)[index % CHUNK_SIZE];
+        }
+
+        void link(uint32_t index);
+        // stops after a marker if stopAtMarker is set
+        bool execute(bool stopAtMarker);
+        uint32_t allocateNode();
+        void freeNode(uint32_t index);
+        void addChunk();
+        bool fetchPending();
+
+        std::atomic<Node*> chunks[MAX_CHUNK_COUNT]; // the chunks never move, so the indices stay valid
+        uint32_t chunkCount = 0;
+        std::mutex chunkMutex;
+
+        std::atomic<uint64_t> freeHead; // index of the first free node and a tag that is changed by every update
+        std::atomic<uint32_t> pendingHead; // pushed nodes, the last pushed node first
+
+        // accessed only by the consuming thread
+        std::vector<uint32_t> batch; // fetched nodes in the push order
+        size_t batchPosition = 0;
+    };
+}
@@ -0,0 +1,155 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ouzel
+{
+    // move-only void(void) callable, closures of up to STORAGE_SIZE bytes are stored without allocating
+    class Function
+    {
+    public:
+        static const size_t STORAGE_SIZE = 64;
+
+        Function()
+        {
+        }
+
+        template<class F, class = typename std::enable_if<!std::is_same<typename std::decay<F>::type, Function>::value>::type>
+        Function(F&& f)
+        {
+            typedef typename std::decay<F>::type Type;
+            construct<Type>(std::forward<F>(f), std::integral_constant<bool, isStoredInline<Type>()>());
+        }
+
+        Function(Function&& other)
+        {
+            if (other.operations)
+            {
+                other.operations->move(&other.storage, &storage);
+                operations = other.operations;
+                other.operations = nullptr;
+            }
+        }
+
+        Function& operator=(Function&& other)
+        {
+            if (&other != this)
+            {
+                reset();
+
+                if (other.operations)
+                {
+                    other.operations->move(&other.storage, &storage);
+                    operations = other.operations;
+                    other.operations = nullptr;
+                }
+            }
+
+            return *this;
+        }
+
+        Function(const Function&) = delete;
+        Function& operator=(const Function&) = delete;
+
+        ~Function()
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            if (operations)
+            {
+                operations->destroy(&storage);
+                operations = nullptr;
+            }
+        }
+
+        explicit operator bool() const { return operations != nullptr; }
+
+        void operator()()
+        {
+            operations->call(&storage);
+        }
+
+    private:
+        typedef typename std::aligned_storage<STORAGE_SIZE>::type Storage;
+
+        struct Operations
+        {
+            void (*call)(void* storage);
+            void (*move)(void* from, void* to); // also destroys the source
+            void (*destroy)(void* storage);
+        };
+
+        template<class F> static constexpr bool isStoredInline()
+        {
+            return sizeof(F) <= sizeof(Storage) &&
+                std::alignment_of<Storage>::value % std::alignment_of<F>::value == 0 &&
+                std::is_nothrow_move_constructible<F>::value;
+        }
+
+        template<class F> struct InlineOperations
+        {
+            static void call(void* storage) { (*static_cast<F*>(storage))(); }
+
+            static void move(void* from, void* to)
+            {
+                new (to) F(std::move(*static_cast<F*>(from)));
+                static_cast<F*>(from)->~F();
+            }
+
+            static void destroy(void* storage) { static_cast<F*>(storage)->~F(); }
+
+            static const Operations operations;
+        };
+
+        // closures that do not fit are allocated and only the pointer is stored
+        template<class F> struct HeapOperations
+        {
+            static void call(void* storage) { (**static_cast<F**>(storage))(); }
+
+            static void move(void* from, void* to)
+            {
+                *static_cast<F**>(to) = *static_cast<F**>(from);
+            }
+
+            static void destroy(void* storage) { delete *static_cast<F**>(storage); }
+
+            static const Operations operations;
+        };
+
+        template<class F, class T> void construct(T&& f, std::true_type)
+        {
+            new (&storage) F(std::forward<T>(f));
+            operations = &InlineOperations<F>::operations;
+        }
+
+        template<class F, class T> void construct(T&& f, std::false_type)
+        {
+            *reinterpret_cast<F**>(&storage) = new F(std::forward<T>(f));
+            operations = &HeapOperations<F>::operations;
+        }
+
+        Storage storage;
+        const Operations* operations = nullptr;
+    };
+
+    template<class F> const Function::Operations Function::InlineOperations<F>::operations = {
+        &Function::InlineOperations<F>::call,
+        &Function::InlineOperations<F>::move,
+        &Function::InlineOperations<F>::destroy
+    };
+
+    template<class F> const Function::Operations Function::HeapOperations<F>::operations = {
+        &Function::HeapOperations<F>::call,
+        &Function::HeapOperations<F>::move,
+        &Function::HeapOperations<F>::destroy
+    };
+}
@@ -0,0 +1,247 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include "Profiler.hpp"
+#include "core/Engine.hpp"
+#include "files/FileSystem.hpp"
+#include "utils/Log.hpp"
+
+namespace ouzel
+{
+    static std::atomic<uint32_t> lastProfilerId(0);
+
+    struct CurrentThreadBuffer
+    {
+        uint32_t profilerId;
+        void* buffer;
+    };
+
+    static thread_local CurrentThreadBuffer currentThreadBuffer = {0, nullptr};
+
+    static void appendEscaped(std::string& result, const std::string& str)
+    {
+        for (char c : str)
+        {
+            if (c == '"' || c == '\\') result += '\\';
+            result += c;
+        }
+    }
+
+    Profiler::Profiler():
+        enabled(false), id(++lastProfilerId), startTime(std::chrono::steady_clock::now())
+    {
+        frameStarts.resize(FRAME_BUFFER_SIZE);
+    }
+
+    void Profiler::setThreadName(const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex);
+
+        std::thread::id threadId = std::this_thread::get_id();
+
+        auto i = std::find_if(threadNames.begin(), threadNames.end(), [threadId](const std::pair<std::thread::id, std::string>& threadName) {
+            return threadName.first == threadId;
+        });
+
+        if (i == threadNames.end()) threadNames.push_back(std::make_pair(threadId, name));
+        else i->second = name;
+
+        // the thread could have recorded events already
+        for (const std::unique_ptr<ThreadBuffer>& buffer : threadBuffers)
+        {
+            if (buffer->threadId == threadId)
+            {
+                std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+                buffer->name = name;
+            }
+        }
+    }
+
+    void Profiler::beginFrame()
+    {
+        if (!isEnabled()) return;
+
+        std::lock_guard<std::mutex> lock(frameMutex);
+        frameStarts[frameCount % FRAME_BUFFER_SIZE] = getTime();
+        ++frameCount;
+    }
+
+    std::vector<Profiler::Summary> Profiler::getFrameSummary() const
+    {
+        std::vector<Summary> result;
+
+        uint64_t frameStart;
+        uint64_t frameEnd;
+
+        {
+            std::lock_guard<std::mutex> lock(frameMutex);
+            if (frameCount < 2) return result;
+
+            frameStart = frameStarts[(frameCount - 2) % FRAME_BUFFER_SIZE];
+            frameEnd = frameStarts[(frameCount - 1) % FRAME_BUFFER_SIZE];
+        }
+
+        std::lock_guard<std::mutex> bufferLock(bufferMutex);
+
+        for (const std::unique_ptr<ThreadBuffer>& buffer : threadBuffers)
+        {
+            std::lock_guard<std::mutex> lock(buffer->mutex);
+
+            size_t threadStart = result.size();
+            uint64_t count = std::min(buffer->eventCount, static_cast<uint64_t>(EVENT_BUFFER_SIZE));
+
+            for (uint64_t i = buffer->eventCount - count; i < buffer->eventCount; ++i)
+            {
+                const Event& event = buffer->events[i % EVENT_BUFFER_SIZE];
+
+                if (event.start < frameStart || event.start >= frameEnd) continue;
+
+                auto summary = std::find_if(result.begin() + static_cast<std::ptrdiff_t>(threadStart), result.end(), [&event](const Summary& s) {
+                    return s.name == event.name && s.depth == event.depth;
+                });
+
+                if (summary == result.end())
+                {
+                    Summary newSummary;
+                    newSummary.threadName = buffer->name;
+                    newSummary.name = event.name;
+                    newSummary.depth = event.depth;
+                    newSummary.count = 0;
+                    newSummary.time = 0.0f;
+                    result.push_back(newSummary);
+                    summary = result.end() - 1;
+                }
+
+                ++summary->count;
+                summary->time += (event.end - event.start) / 1000000000.0f;
+            }
+        }
+
+        return result;
+    }
+
+    void Profiler::logFrameSummary() const
+    {
+        for (const Summary& summary : getFrameSummary())
+        {
+            Log(Log::Level::INFO) << summary.threadName << ": " << std::string(summary.depth * 2, ' ') << summary.name <<
+                " " << summary.time * 1000.0f << " ms (" << summary.count << ")";
+        }
+    }
+
+    bool Profiler::exportChromeTrace(const std::string& filename) const
+    {
+        std::string json = "{\"traceEvents\":[";
+        bool first = true;
+
+        {
+            std::lock_guard<std::mutex> bufferLock(bufferMutex);
+
+            for (const std::unique_ptr<ThreadBuffer>& buffer : threadBuffers)
+            {
+                std::lock_guard<std::mutex> lock(buffer->mutex);
+
+                std::string tid = std::to_string(buffer->index);
+
+                if (!buffer->name.empty())
+                {
+                    if (!first) json += ",";
+                    first = false;
+
+                    json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" + tid + ",\"args\":{\"name\":\"";
+                    appendEscaped(json, buffer->name);
+                    json += "\"}}";
+                }
+
+                uint64_t count = std::min(buffer->eventCount, static_cast<uint64_t>(EVENT_BUFFER_SIZE));
+
+                for (uint64_t i = buffer->eventCount - count; i < buffer->eventCount; ++i)
+                {
+                    const Event& event = buffer->events[i % EVENT_BUFFER_SIZE];
+
+                    if (!first) json += ",";
+                    first = false;
+
+                    // complete events with the time stamps in microseconds
+                    json += "{\"name\":\"";
+                    appendEscaped(json, event.name);
+                    json += "\",\"cat\":\"ouzel\",\"ph\":\"X\",\"pid\":0,\"tid\":" + tid +
+                        ",\"ts\":" + std::to_string(event.start / 1000) + "." + std::to_string(event.start % 1000 / 100) +
+                        ",\"dur\":" + std::to_string((event.end - event.start) / 1000) + "." + std::to_string((event.end - event.start) % 1000 / 100) + "}";
+                }
+            }
+        }
+
+        json += "]}";
+
+        std::vector<uint8_t> data(json.begin(), json.end());
+
+        if (!sharedEngine->getFileSystem()->writeFile(filename, data))
+        {
+            Log(Log::Level::ERR) << "Failed to write the profile to " << filename;
+            return false;
+        }
+
+        return true;
+    }
+
+    Profiler::ThreadBuffer* Profiler::getThreadBuffer()
+    {
+        if (currentThreadBuffer.profilerId == id)
+        {
+            return static_cast<ThreadBuffer*>(currentThreadBuffer.buffer);
+        }
+
+        std::lock_guard<std::mutex> lock(bufferMutex);
+
+        std::thread::id threadId = std::this_thread::get_id();
+
+        auto i = std::find_if(threadBuffers.begin(), threadBuffers.end(), [threadId](const std::unique_ptr<ThreadBuffer>& buffer) {
+            return buffer->threadId == threadId;
+        });
+
+        ThreadBuffer* result;
+
+        if (i == threadBuffers.end())
+        {
+            std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+            buffer->threadId = threadId;
+            buffer->index = static_cast<uint32_t>(threadBuffers.size());
+            buffer->events.resize(EVENT_BUFFER_SIZE);
+
+            for (const std::pair<std::thread::id, std::string>& threadName : threadNames)
+            {
+                if (threadName.first == threadId) buffer->name = threadName.second;
+            }
+
+            result = buffer.get();
+            threadBuffers.push_back(std::move(buffer));
+        }
+        else
+        {
+            result = i->get();
+        }
+
+        currentThreadBuffer.profilerId = id;
+        currentThreadBuffer.buffer = result;
+
+        return result;
+    }
+
+    void Profiler::addEvent(ThreadBuffer* buffer, const char* name, uint64_t start, uint64_t end)
+    {
+        --buffer->depth;
+
+        // the lock is contended only while the events are exported
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+
+        Event& event = buffer->events[buffer->eventCount % EVENT_BUFFER_SIZE];
+        event.name = name;
+        event.start = start;
+        event.end = end;
+        event.depth = buffer->depth;
+
+        ++buffer->eventCount;
+    }
+}
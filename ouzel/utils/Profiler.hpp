@@ -0,0 +1,132 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include "core/Setup.h"
+#include "utils/Noncopyable.hpp"
+
+namespace ouzel
+{
+    class ProfileScope;
+
+    // records the scoped markers of every thread into its own ring buffer,
+    // the markers can be exported as a Chrome trace (chrome://tracing) or summed up per frame
+    class Profiler: public Noncopyable
+    {
+        friend ProfileScope;
+    public:
+        struct Event
+        {
+            const char* name; // must be a string literal
+            uint64_t start; // nanoseconds since the profiler was created
+            uint64_t end;
+            uint32_t depth; // number of the markers that enclose this marker
+        };
+
+        struct Summary
+        {
+            std::string threadName;
+            const char* name;
+            uint32_t depth;
+            uint32_t count;
+            float time; // seconds
+        };
+
+        static const uint32_t EVENT_BUFFER_SIZE = 65536; // events per thread
+        static const uint32_t FRAME_BUFFER_SIZE = 256;
+
+        Profiler();
+
+        void setEnabled(bool newEnabled) { enabled = newEnabled; }
+        bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+        // names the buffer of the calling thread, the buffer is allocated only when the thread records its first event
+        void setThreadName(const std::string& name);
+
+        // called by the update thread before every update
+        void beginFrame();
+
+        // time spent in every marker during the last finished frame
+        std::vector<Summary> getFrameSummary() const;
+        void logFrameSummary() const;
+
+        bool exportChromeTrace(const std::string& filename) const;
+
+        uint64_t getTime() const
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count());
+        }
+
+    protected:
+        struct ThreadBuffer
+        {
+            std::thread::id threadId;
+            uint32_t index;
+            std::string name;
+            uint32_t depth = 0; // accessed only by the owning thread
+
+            mutable std::mutex mutex;
+            std::vector<Event> events;
+            uint64_t eventCount = 0; // total, the ring buffer keeps the last EVENT_BUFFER_SIZE
+        };
+
+        ThreadBuffer* getThreadBuffer();
+        void addEvent(ThreadBuffer* buffer, const char* name, uint64_t start, uint64_t end);
+
+        std::atomic<bool> enabled;
+        uint32_t id; // tells the thread local pointers of different profilers apart
+        std::chrono::steady_clock::time_point startTime;
+
+        mutable std::mutex bufferMutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers;
+        std::vector<std::pair<std::thread::id, std::string>> threadNames;
+
+        mutable std::mutex frameMutex;
+        std::vector<uint64_t> frameStarts;
+        uint64_t frameCount = 0;
+    };
+
+    class ProfileScope: public Noncopyable
+    {
+    public:
+        ProfileScope(Profiler* aProfiler, const char* aName):
+            profiler(aProfiler->isEnabled() ? aProfiler : nullptr), name(aName)
+        {
+            if (profiler)
+            {
+                buffer = profiler->getThreadBuffer();
+                ++buffer->depth;
+                start = profiler->getTime();
+            }
+        }
+
+        ~ProfileScope()
+        {
+            if (profiler) profiler->addEvent(buffer, name, start, profiler->getTime());
+        }
+
+    private:
+        Profiler* profiler;
+        const char* name;
+        Profiler::ThreadBuffer* buffer = nullptr;
+        uint64_t start = 0;
+    };
+}
+
+#define OUZEL_PROFILE_CONCAT2(a, b) a##b
+#define OUZEL_PROFILE_CONCAT(a, b) OUZEL_PROFILE_CONCAT2(a, b)
+
+#if OUZEL_ENABLE_PROFILER
+#define OUZEL_PROFILE_SCOPE(profiler, name) ouzel::ProfileScope OUZEL_PROFILE_CONCAT(profileScope, __LINE__)(profiler, name)
+#else
+#define OUZEL_PROFILE_SCOPE(profiler, name)
+#endif
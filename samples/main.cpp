@@ -1,6 +1,7 @@
 // Copyright (C) 2017 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <cstdlib>
 #include "MainMenu.hpp"
 #include "SpritesSample.hpp"
 #include "GUISample.hpp"
@@ -13,12 +14,32 @@
 std::string DEVELOPER_NAME = "org.ouzelengine";
 std::string APPLICATION_NAME = "samples";
 
+std::unique_ptr<ouzel::graphics::RenderReplay> replay;
+
+// returns false if the argument is not a positive 32-bit number
+static bool getCount(const std::string& argument, uint32_t& count)
+{
+    if (argument.empty() || argument[0] < '0' || argument[0] > '9') return false;
+
+    char* end;
+    unsigned long value = std::strtoul(argument.c_str(), &end, 10);
+
+    if (*end != '\0' || value == 0 || value > 0xFFFFFFFFUL) return false;
+
+    count = static_cast<uint32_t>(value);
+    return true;
+}
+
 void ouzelMain(const std::vector<std::string>& args)
 {
     // disable screen saver
     ouzel::sharedEngine->setScreenSaverEnabled(false);
 
     std::string sample;
+    std::string recordFilename;
+    uint32_t recordFrames = 300;
+    std::string replayFilename;
+    uint32_t replayLoops = 1;
 
     for (auto arg = args.begin(); arg != args.end(); ++arg)
     {
@@ -41,12 +62,87 @@ void ouzelMain(const std::vector<std::string>& args)
                 ouzel::Log(ouzel::Log::Level::WARN) << "No sample specified";
             }
         }
+        else if (*arg == "-record")
+        {
+            auto nextArg = ++arg;
+
+            if (nextArg != args.end())
+            {
+                recordFilename = *nextArg;
+            }
+            else
+            {
+                ouzel::Log(ouzel::Log::Level::WARN) << "No capture file specified";
+            }
+        }
+        else if (*arg == "-frames")
+        {
+            auto nextArg = ++arg;
+
+            if (nextArg != args.end())
+            {
+                if (!getCount(*nextArg, recordFrames))
+                {
+                    ouzel::Log(ouzel::Log::Level::WARN) << "Invalid frame count \"" << *nextArg << "\"";
+                }
+            }
+            else
+            {
+                ouzel::Log(ouzel::Log::Level::WARN) << "No frame count specified";
+            }
+        }
+        else if (*arg == "-replay")
+        {
+            auto nextArg = ++arg;
+
+            if (nextArg != args.end())
+            {
+                replayFilename = *nextArg;
+            }
+            else
+            {
+                ouzel::Log(ouzel::Log::Level::WARN) << "No capture file specified";
+            }
+        }
+        else if (*arg == "-loops")
+        {
+            auto nextArg = ++arg;
+
+            if (nextArg != args.end())
+            {
+                if (!getCount(*nextArg, replayLoops))
+                {
+                    ouzel::Log(ouzel::Log::Level::WARN) << "Invalid loop count \"" << *nextArg << "\"";
+                }
+            }
+            else
+            {
+                ouzel::Log(ouzel::Log::Level::WARN) << "No loop count specified";
+            }
+        }
         else
         {
             ouzel::Log(ouzel::Log::Level::WARN) << "Invalid argument \"" << *arg << "\"";
         }
     }
 
+    // replays a capture (with the graphics driver set to "empty" this runs without a GPU) and exits
+    if (!replayFilename.empty())
+    {
+        replay.reset(new ouzel::graphics::RenderReplay());
+
+        if (replay->init(replayFilename))
+        {
+            replay->start(replayLoops, true);
+        }
+        else
+        {
+            ouzel::sharedEngine->exit();
+        }
+
+        return;
+    }
+
     ouzel::sharedEngine->getFileSystem()->addResourcePath("Resources");
 
     ouzel::sharedEngine->getRenderer()->setClearColor(ouzel::Color(64, 0, 0));
@@ -91,4 +187,9 @@ void ouzelMain(const std::vector<std::string>& args)
     }
 
     ouzel::sharedEngine->getSceneManager()->setScene(std::move(currentScene));
+
+    if (!recordFilename.empty())
+    {
+        ouzel::sharedEngine->getRenderer()->startRecording(recordFilename, recordFrames);
+    }
 }
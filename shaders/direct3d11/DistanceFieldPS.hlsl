@@ -0,0 +1,25 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+cbuffer Constants: register(b0)
+{
+    float4 color;
+}
+
+struct VS2PS
+{
+    float4 position: SV_POSITION;
+    float4 color: COLOR;
+    float2 texCoord: TEXCOORD;
+};
+
+SamplerState sampler0;
+Texture2D texture0;
+
+void main(in VS2PS input, out float4 output0: SV_TARGET0)
+{
+    float distance = texture0.Sample(sampler0, input.texCoord).a;
+    float smoothing = 0.7 * length(float2(ddx(distance), ddy(distance)));
+    float alpha = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);
+    output0 = float4(input.color.rgb * color.rgb, alpha * input.color.a * color.a);
+}
@@ -1,5 +1,7 @@
 fxc /Zi /E"main" /Od /Fh"../../ouzel/graphics/direct3d11/TexturePSD3D11.h" /Vn"TEXTURE_PIXEL_SHADER_D3D11" /T ps_4_0_level_9_1 /nologo TexturePS.hlsl
 fxc /Zi /E"main" /Od /Fh"../../ouzel/graphics/direct3d11/TextureVSD3D11.h" /Vn"TEXTURE_VERTEX_SHADER_D3D11" /T vs_4_0_level_9_1 /nologo TextureVS.hlsl
 
+fxc /Zi /E"main" /Od /Fh"../../ouzel/graphics/direct3d11/DistanceFieldPSD3D11.h" /Vn"DISTANCE_FIELD_PIXEL_SHADER_D3D11" /T ps_4_0_level_9_3 /nologo DistanceFieldPS.hlsl
+
 fxc /Zi /E"main" /Od /Fh"../../ouzel/graphics/direct3d11/ColorPSD3D11.h" /Vn"COLOR_PIXEL_SHADER_D3D11" /T ps_4_0_level_9_1 /nologo ColorPS.hlsl
 fxc /Zi /E"main" /Od /Fh"../../ouzel/graphics/direct3d11/ColorVSD3D11.h" /Vn"COLOR_VERTEX_SHADER_D3D11" /T vs_4_0_level_9_1 /nologo ColorVS.hlsl
\ No newline at end of file
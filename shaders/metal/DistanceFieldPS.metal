@@ -0,0 +1,31 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <metal_stdlib>
+#include <simd/simd.h>
+
+using namespace metal;
+
+typedef struct __attribute__((__aligned__(256)))
+{
+    float4 color;
+} uniforms_t;
+
+typedef struct
+{
+    float4 position [[position]];
+    half4 color;
+    float2 texCoord;
+} VS2PS;
+
+// Fragment shader function
+fragment half4 mainPS(VS2PS input [[stage_in]],
+                      texture2d<float> tex2D [[texture(0)]],
+                      sampler sampler2D [[sampler(0)]],
+                      constant uniforms_t& uniforms [[buffer(1)]])
+{
+    float distance = tex2D.sample(sampler2D, input.texCoord).a;
+    float smoothing = 0.7 * length(float2(dfdx(distance), dfdy(distance)));
+    float alpha = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);
+    return half4(input.color.rgb * half3(uniforms.color.rgb), half(alpha) * input.color.a * half(uniforms.color.a));
+}
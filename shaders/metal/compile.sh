@@ -21,6 +21,10 @@ $MACOS_PLATFORM/usr/bin/metal -arch air64 -ffast-math -o TextureVSMacOS.air -std
 $MACOS_PLATFORM/usr/bin/metal-ar r TextureVSMacOS.metalar TextureVSMacOS.air
 $MACOS_PLATFORM/usr/bin/metallib -o TextureVSMacOS.metallib TextureVSMacOS.metalar
 
+$MACOS_PLATFORM/usr/bin/metal -arch air64 -ffast-math -o DistanceFieldPSMacOS.air -std=osx-metal1.1 DistanceFieldPS.metal
+$MACOS_PLATFORM/usr/bin/metal-ar r DistanceFieldPSMacOS.metalar DistanceFieldPSMacOS.air
+$MACOS_PLATFORM/usr/bin/metallib -o DistanceFieldPSMacOS.metallib DistanceFieldPSMacOS.metalar
+
 # iOS
 
 $IOS_PLATFORM/usr/bin/metal -arch air64 -ffast-math -o ColorPSIOS.air -std=ios-metal1.1 ColorPS.metal
@@ -39,6 +43,10 @@ $IOS_PLATFORM/usr/bin/metal -arch air64 -ffast-math -o TextureVSIOS.air -std=ios
 $IOS_PLATFORM/usr/bin/metal-ar r TextureVSIOS.metalar TextureVSIOS.air
 $IOS_PLATFORM/usr/bin/metallib -o TextureVSIOS.metallib TextureVSIOS.metalar
 
+$IOS_PLATFORM/usr/bin/metal -arch air64 -ffast-math -o DistanceFieldPSIOS.air -std=ios-metal1.1 DistanceFieldPS.metal
+$IOS_PLATFORM/usr/bin/metal-ar r DistanceFieldPSIOS.metalar DistanceFieldPSIOS.air
+$IOS_PLATFORM/usr/bin/metallib -o DistanceFieldPSIOS.metallib DistanceFieldPSIOS.metalar
+
 # tvOS
 
 $TVOS_PLATFORM/usr/bin/metal -arch air64 -ffast-math -o ColorPSTVOS.air -std=ios-metal1.1 ColorPS.metal
@@ -57,20 +65,27 @@ $TVOS_PLATFORM/usr/bin/metal -arch air64 -ffast-math -o TextureVSTVOS.air -std=i
 $TVOS_PLATFORM/usr/bin/metal-ar r TextureVSTVOS.metalar TextureVSTVOS.air
 $TVOS_PLATFORM/usr/bin/metallib -o TextureVSTVOS.metallib TextureVSTVOS.metalar
 
+$TVOS_PLATFORM/usr/bin/metal -arch air64 -ffast-math -o DistanceFieldPSTVOS.air -std=ios-metal1.1 DistanceFieldPS.metal
+$TVOS_PLATFORM/usr/bin/metal-ar r DistanceFieldPSTVOS.metalar DistanceFieldPSTVOS.air
+$TVOS_PLATFORM/usr/bin/metallib -o DistanceFieldPSTVOS.metallib DistanceFieldPSTVOS.metalar
+
 xxd -i ColorPSMacOS.metallib ../../ouzel/graphics/metal/ColorPSMacOS.h
 xxd -i ColorVSMacOS.metallib ../../ouzel/graphics/metal/ColorVSMacOS.h
 xxd -i TexturePSMacOS.metallib ../../ouzel/graphics/metal/TexturePSMacOS.h
 xxd -i TextureVSMacOS.metallib ../../ouzel/graphics/metal/TextureVSMacOS.h
+xxd -i DistanceFieldPSMacOS.metallib ../../ouzel/graphics/metal/DistanceFieldPSMacOS.h
 
 xxd -i ColorPSIOS.metallib ../../ouzel/graphics/metal/ColorPSIOS.h
 xxd -i ColorVSIOS.metallib ../../ouzel/graphics/metal/ColorVSIOS.h
 xxd -i TexturePSIOS.metallib ../../ouzel/graphics/metal/TexturePSIOS.h
 xxd -i TextureVSIOS.metallib ../../ouzel/graphics/metal/TextureVSIOS.h
+xxd -i DistanceFieldPSIOS.metallib ../../ouzel/graphics/metal/DistanceFieldPSIOS.h
 
 xxd -i ColorPSTVOS.metallib ../../ouzel/graphics/metal/ColorPSTVOS.h
 xxd -i ColorVSTVOS.metallib ../../ouzel/graphics/metal/ColorVSTVOS.h
 xxd -i TexturePSTVOS.metallib ../../ouzel/graphics/metal/TexturePSTVOS.h
 xxd -i TextureVSTVOS.metallib ../../ouzel/graphics/metal/TextureVSTVOS.h
+xxd -i DistanceFieldPSTVOS.metallib ../../ouzel/graphics/metal/DistanceFieldPSTVOS.h
 
 rm -rf ./*.air
 rm -rf ./*.metalar
@@ -0,0 +1,12 @@
+#version 120
+uniform vec4 color;
+uniform sampler2D texture0;
+varying vec4 exColor;
+varying vec2 exTexCoord;
+void main()
+{
+    float distance = texture2D(texture0, exTexCoord).a;
+    float smoothing = 0.7 * length(vec2(dFdx(distance), dFdy(distance)));
+    float alpha = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);
+    gl_FragColor = vec4(exColor.rgb * color.rgb, alpha * exColor.a * color.a);
+}
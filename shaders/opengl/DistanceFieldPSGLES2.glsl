@@ -0,0 +1,13 @@
+#extension GL_OES_standard_derivatives : enable
+precision mediump float;
+uniform lowp vec4 color;
+uniform lowp sampler2D texture0;
+varying lowp vec4 exColor;
+varying vec2 exTexCoord;
+void main()
+{
+    float distance = texture2D(texture0, exTexCoord).a;
+    float smoothing = 0.7 * length(vec2(dFdx(distance), dFdy(distance)));
+    float alpha = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);
+    gl_FragColor = vec4(exColor.rgb * color.rgb, alpha * exColor.a * color.a);
+}
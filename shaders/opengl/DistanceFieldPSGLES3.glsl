@@ -0,0 +1,14 @@
+#version 300 es
+precision mediump float;
+uniform lowp vec4 color;
+uniform lowp sampler2D texture0;
+in lowp vec4 exColor;
+in vec2 exTexCoord;
+out vec4 outColor;
+void main()
+{
+    float distance = texture(texture0, exTexCoord).a;
+    float smoothing = 0.7 * length(vec2(dFdx(distance), dFdy(distance)));
+    float alpha = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);
+    outColor = vec4(exColor.rgb * color.rgb, alpha * exColor.a * color.a);
+}
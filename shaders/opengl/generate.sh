@@ -3,27 +3,32 @@ xxd -i ColorPSGL2.glsl ../../ouzel/graphics/opengl/ColorPSGL2.h
 xxd -i ColorVSGL2.glsl ../../ouzel/graphics/opengl/ColorVSGL2.h
 xxd -i TexturePSGL2.glsl ../../ouzel/graphics/opengl/TexturePSGL2.h
 xxd -i TextureVSGL2.glsl ../../ouzel/graphics/opengl/TextureVSGL2.h
+xxd -i DistanceFieldPSGL2.glsl ../../ouzel/graphics/opengl/DistanceFieldPSGL2.h
 
 # OpenGL 3
 xxd -i ColorPSGL3.glsl ../../ouzel/graphics/opengl/ColorPSGL3.h
 xxd -i ColorVSGL3.glsl ../../ouzel/graphics/opengl/ColorVSGL3.h
 xxd -i TexturePSGL3.glsl ../../ouzel/graphics/opengl/TexturePSGL3.h
 xxd -i TextureVSGL3.glsl ../../ouzel/graphics/opengl/TextureVSGL3.h
+xxd -i DistanceFieldPSGL3.glsl ../../ouzel/graphics/opengl/DistanceFieldPSGL3.h
 
 # OpenGL 4
 xxd -i ColorPSGL4.glsl ../../ouzel/graphics/opengl/ColorPSGL4.h
 xxd -i ColorVSGL4.glsl ../../ouzel/graphics/opengl/ColorVSGL4.h
 xxd -i TexturePSGL4.glsl ../../ouzel/graphics/opengl/TexturePSGL4.h
 xxd -i TextureVSGL4.glsl ../../ouzel/graphics/opengl/TextureVSGL4.h
+xxd -i DistanceFieldPSGL4.glsl ../../ouzel/graphics/opengl/DistanceFieldPSGL4.h
 
 # OpenGL ES 2
 xxd -i ColorPSGLES2.glsl ../../ouzel/graphics/opengl/ColorPSGLES2.h
 xxd -i ColorVSGLES2.glsl ../../ouzel/graphics/opengl/ColorVSGLES2.h
 xxd -i TexturePSGLES2.glsl ../../ouzel/graphics/opengl/TexturePSGLES2.h
 xxd -i TextureVSGLES2.glsl ../../ouzel/graphics/opengl/TextureVSGLES2.h
+xxd -i DistanceFieldPSGLES2.glsl ../../ouzel/graphics/opengl/DistanceFieldPSGLES2.h
 
 # OpenGL ES 3
 xxd -i ColorPSGLES3.glsl ../../ouzel/graphics/opengl/ColorPSGLES3.h
 xxd -i ColorVSGLES3.glsl ../../ouzel/graphics/opengl/ColorVSGLES3.h
 xxd -i TexturePSGLES3.glsl ../../ouzel/graphics/opengl/TexturePSGLES3.h
-xxd -i TextureVSGLES3.glsl ../../ouzel/graphics/opengl/TextureVSGLES3.h
\ No newline at end of file
+xxd -i TextureVSGLES3.glsl ../../ouzel/graphics/opengl/TextureVSGLES3.h
+xxd -i DistanceFieldPSGLES3.glsl ../../ouzel/graphics/opengl/DistanceFieldPSGLES3.h
\ No newline at end of file
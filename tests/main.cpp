@@ -0,0 +1,187 @@
+// Copyright (C) 2017 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include "ouzel.hpp"
+
+std::string DEVELOPER_NAME = "org.ouzelengine";
+std::string APPLICATION_NAME = "tests";
+
+static uint32_t failureCount = 0;
+
+static void checkEqual(const std::string& name, uint32_t value, uint32_t expected)
+{
+    if (value != expected)
+    {
+        ouzel::Log(ouzel::Log::Level::ERR) << name << " is " << value << ", expected " << expected;
+        ++failureCount;
+    }
+}
+
+// flushes the commands that were added to the device and waits until the render thread has drawn them,
+// nothing else is flushed while ouzelMain runs, so the published statistics belong to this frame
+static bool drawFrame(ouzel::graphics::RenderDevice* device, ouzel::graphics::RenderStatistics& statistics)
+{
+    uint32_t frame = device->getStatistics().frame;
+
+    device->flushCommands();
+
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        statistics = device->getStatistics();
+
+        if (statistics.frame != frame)
+        {
+            return true;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    ouzel::Log(ouzel::Log::Level::ERR) << "Frame was not drawn";
+    ++failureCount;
+
+    return false;
+}
+
+static void testDrawCommandCounters()
+{
+    ouzel::graphics::RenderDevice* device = ouzel::sharedEngine->getRenderer()->getDevice();
+
+    if (device->getDriver() != ouzel::graphics::Renderer::Driver::EMPTY)
+    {
+        ouzel::Log(ouzel::Log::Level::WARN) << "The draw command counters are checked only with the empty driver";
+        return;
+    }
+
+    ouzel::graphics::ShaderResource* shaders[2] = {
+        ouzel::sharedEngine->getCache()->getShader(ouzel::graphics::SHADER_TEXTURE)->getResource(),
+        ouzel::sharedEngine->getCache()->getShader(ouzel::graphics::SHADER_COLOR)->getResource()
+    };
+
+    ouzel::graphics::BlendStateResource* blendStates[2] = {
+        ouzel::sharedEngine->getCache()->getBlendState(ouzel::graphics::BLEND_ALPHA)->getResource(),
+        ouzel::sharedEngine->getCache()->getBlendState(ouzel::graphics::BLEND_ADD)->getResource()
+    };
+
+    ouzel::graphics::Texture texture0;
+    ouzel::graphics::Texture texture1;
+    ouzel::graphics::TextureResource* textures[2] = {texture0.getResource(), texture1.getResource()};
+
+    // order group 0 alternates the shader, texture and blend state on every command,
+    // order group 1 alternates them again and must stay after group 0 when sorted
+    auto addCommands = [device, &shaders, &blendStates, &textures]() {
+        for (uint32_t i = 0; i < 10; ++i)
+        {
+            ouzel::graphics::RenderDevice::DrawCommand drawCommand = {};
+            drawCommand.textures[0] = textures[i % 2];
+            drawCommand.shader = shaders[i % 2];
+            drawCommand.blendState = blendStates[i % 2];
+            drawCommand.indexCount = 6;
+            drawCommand.drawMode = ouzel::graphics::Renderer::DrawMode::TRIANGLE_LIST;
+            drawCommand.viewport = ouzel::Rectangle(0.0f, 0.0f, 800.0f, 600.0f);
+            drawCommand.cullMode = ouzel::graphics::Renderer::CullMode::NONE;
+            drawCommand.orderGroup = (i < 8) ? 0 : 1;
+
+            device->addDrawCommand(drawCommand, {}, {});
+        }
+    };
+
+    ouzel::graphics::RenderStatistics statistics;
+
+    // submission order: every consecutive command changes the shader, texture and blend state
+    device->setDrawCommandSorting(false);
+    addCommands();
+
+    if (drawFrame(device, statistics))
+    {
+        checkEqual("Unsorted draw calls", statistics.drawCalls, 10);
+        checkEqual("Unsorted shader changes", statistics.shaderChanges, 10);
+        checkEqual("Unsorted texture changes", statistics.textureChanges, 10);
+        checkEqual("Unsorted blend state changes", statistics.blendStateChanges, 10);
+        checkEqual("Unsorted render target changes", statistics.renderTargetChanges, 1);
+        checkEqual("Unsorted viewport changes", statistics.viewportChanges, 1);
+        checkEqual("Unsorted removed state changes", device->getRemovedStateChangeCount(), 0);
+    }
+
+    // sorted: group 0 becomes two runs of four commands, group 1 keeps its two commands
+    device->setDrawCommandSorting(true);
+    addCommands();
+
+    if (drawFrame(device, statistics))
+    {
+        checkEqual("Sorted draw calls", statistics.drawCalls, 10);
+        checkEqual("Sorted shader changes", statistics.shaderChanges, 4);
+        checkEqual("Sorted texture changes", statistics.textureChanges, 4);
+        checkEqual("Sorted blend state changes", statistics.blendStateChanges, 4);
+        checkEqual("Sorted render target changes", statistics.renderTargetChanges, 1);
+        checkEqual("Sorted viewport changes", statistics.viewportChanges, 1);
+        // 32 state changes (render target, blend state, shader, texture, mesh buffer) before sorting, 14 after
+        checkEqual("Sorted removed state changes", device->getRemovedStateChangeCount(), 18);
+    }
+
+    device->setDrawCommandSorting(false);
+}
+
+void ouzelMain(const std::vector<std::string>& args)
+{
+    std::vector<std::string> tests;
+
+    for (auto arg = args.begin(); arg != args.end(); ++arg)
+    {
+        if (arg == args.begin())
+        {
+            // skip the first parameter
+            continue;
+        }
+
+        if (*arg == "-test")
+        {
+            auto nextArg = ++arg;
+
+            if (nextArg != args.end())
+            {
+                tests.push_back(*nextArg);
+            }
+            else
+            {
+                ouzel::Log(ouzel::Log::Level::WARN) << "No test specified";
+            }
+        }
+        else
+        {
+            ouzel::Log(ouzel::Log::Level::WARN) << "Invalid argument \"" << *arg << "\"";
+        }
+    }
+
+    // all the tests are run if none is specified
+    if (tests.empty())
+    {
+        tests = {"drawcommands"};
+    }
+
+    for (const std::string& test : tests)
+    {
+        if (test == "drawcommands")
+        {
+            testDrawCommandCounters();
+        }
+        else
+        {
+            ouzel::Log(ouzel::Log::Level::WARN) << "Invalid test \"" << test << "\"";
+        }
+    }
+
+    if (failureCount > 0)
+    {
+        ouzel::Log(ouzel::Log::Level::ERR) << failureCount << " checks failed";
+        // the engine does not return an exit code of its own
+        std::exit(EXIT_FAILURE);
+    }
+
+    ouzel::Log(ouzel::Log::Level::INFO) << "All checks passed";
+
+    ouzel::sharedEngine->exit();
+}